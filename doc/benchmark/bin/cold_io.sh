@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# cold_io.sh
+
+# Latency of the requests for a small file (in page cache) while other clients download a working set of files NOT in page cache
+# (cold), to compare userver with and without the threads of disk I/O (DISK_IO_THREAD in the section userver of the configuration)
+#
+# ./cold_io.sh <host> <port> <document root of userver> [number of files] [size of file in KB] [output label]
+#
+# NB: the files of the working set must not be in the cache of document root of mod_http (they are created after the start of
+#     userver or they are over the limits of the cache) and the document root must be on a real disk (not tmpfs)...
+
+HOST=${1:-localhost}
+PORT=${2:-8080}
+DOC_ROOT=${3:-/var/www/localhost/htdocs}
+NUM=${4:-200}
+SIZE=${5:-512}
+LABEL=${6:-userver}
+
+mkdir -p COLD_IO $DOC_ROOT/cold
+
+i=0
+while [ $i -lt $NUM ]; do
+	[ -f $DOC_ROOT/cold/$i.bin ] || dd if=/dev/urandom of=$DOC_ROOT/cold/$i.bin bs=1k count=$SIZE 2>/dev/null
+	i=`expr $i + 1`
+done
+
+[ -f $DOC_ROOT/100.html ] || head -c 100 /dev/zero | tr '\0' 'x' > $DOC_ROOT/100.html
+
+sync
+
+# the working set is dropped from page cache (posix_fadvise(POSIX_FADV_DONTNEED))...
+
+for f in $DOC_ROOT/cold/*.bin; do
+	dd if=$f iflag=nocache count=0 2>/dev/null
+done
+
+# 8 clients download the cold working set while ab measure the latency of the hot file...
+
+ls $DOC_ROOT/cold | sed "s|^|http://$HOST:$PORT/cold/|" | xargs -n 1 -P 8 curl -s -o /dev/null &
+
+ab -k -n 20000 -c 4 "http://$HOST:$PORT/100.html" > COLD_IO/${LABEL}_${NUM}x${SIZE}k.txt 2>&1
+
+wait
+
+grep -A 10 "Percentage of the requests" COLD_IO/${LABEL}_${NUM}x${SIZE}k.txt
@@ -0,0 +1,69 @@
+#!/bin/sh
+
+# spawn.sh
+
+# Latency of the requests for a tiny CGI (a new process for every request) with the process of userver at different size of memory (RSS),
+# to compare the launch of the process with fork()+exec() and with posix_spawn() (UProcess::execute(), see HAVE_SPAWN_H)
+#
+# ./spawn.sh <userver binary> [document root] [port] [list of size of the memory cache in MB] [output label]
+#
+# NB: the memory of the server is grown with the cache of document root of mod_http (CACHE_FILE_MASK on the files spawn/*.bin of 1MB
+#     each), the latency of fork() grow with the page table to copy while that of vfork()/posix_spawn() must stay the same...
+
+USERVER=${1:-userver_tcp}
+DOC_ROOT=${2:-/var/www/localhost/htdocs}
+PORT=${3:-8080}
+SIZES=${4:-"0 256 1024 2048"}
+LABEL=${5:-userver}
+
+mkdir -p SPAWN $DOC_ROOT/spawn $DOC_ROOT/cgi-bin
+
+cat > $DOC_ROOT/cgi-bin/spawn.sh <<'EOF'
+#!/bin/sh
+
+printf 'Content-Type: text/plain\r\n\r\nOK\n'
+EOF
+
+chmod +x $DOC_ROOT/cgi-bin/spawn.sh
+
+for MB in $SIZES; do
+	# only the first $MB files have the extension in the mask of the cache...
+
+	i=0
+	while [ $i -lt $MB ]; do
+		[ -f $DOC_ROOT/spawn/$i.bin ] || [ -f $DOC_ROOT/spawn/$i.off ] || dd if=/dev/urandom of=$DOC_ROOT/spawn/$i.off bs=1M count=1 2>/dev/null
+		[ -f $DOC_ROOT/spawn/$i.off ] && mv $DOC_ROOT/spawn/$i.off $DOC_ROOT/spawn/$i.bin
+		i=`expr $i + 1`
+	done
+
+	while [ -f $DOC_ROOT/spawn/$i.bin ]; do
+		mv $DOC_ROOT/spawn/$i.bin $DOC_ROOT/spawn/$i.off
+		i=`expr $i + 1`
+	done
+
+	cat > SPAWN/spawn.cfg <<EOF
+userver {
+ PORT $PORT
+ PREFORK_CHILD 0
+ DOCUMENT_ROOT $DOC_ROOT
+ LOG_FILE SPAWN/spawn.log
+}
+mod_http {
+ CACHE_FILE_MASK *.bin
+}
+EOF
+
+	$USERVER -c SPAWN/spawn.cfg >/dev/null 2>&1 &
+	PID=$!
+
+	until curl -s -o /dev/null "http://localhost:$PORT/cgi-bin/spawn.sh"; do sleep 1; done
+
+	RSS=`ps -o rss= -p $PID`
+
+	ab -n 2000 -c 1 "http://localhost:$PORT/cgi-bin/spawn.sh" > SPAWN/${LABEL}_${MB}M.txt 2>&1
+
+	kill $PID; wait $PID 2>/dev/null
+
+	echo "$LABEL: cache ${MB}MB (rss ${RSS}KB)"
+	grep -A 10 "Percentage of the requests" SPAWN/${LABEL}_${MB}M.txt
+done
@@ -76,6 +76,7 @@ public:
       // LISTEN_BACKLOG        max number of ready to be delivered connections to accept()
       // USE_TCP_OPTIMIZATION  flag indicating the use of TCP/IP options to optimize data transmission (TCP_CORK, TCP_DEFER_ACCEPT, TCP_QUICKACK)
       // SET_REALTIME_PRIORITY flag indicating that the preforked processes will be scheduled under the real-time policies SCHED_FIFO
+      // ENABLE_REUSEPORT      flag indicating that every preforked process accept connections on its own listening socket (SO_REUSEPORT)
       //
       // PID_FILE       write pid on file indicated
       // WELCOME_MSG    message of welcome to send initially to client
@@ -88,10 +89,14 @@ public:
       //
       // PLUGIN         list of plugins to load, a flexible way to add specific functionality to the server
       // PLUGIN_DIR     directory of plugins to load
+      // PLUGIN_TIMING  measure with the time stamp counter of the cpu the latency of the connection-wide hooks of every plugin (default no)
       //
       // REQ_TIMEOUT    timeout for request from client
       // CGI_TIMEOUT    timeout for cgi execution
       //
+      // REQ_ARENA_SIZE size of the area reserved for the request-scoped allocation of strings (default 0 - disabled)
+      // HUGE_PAGES     back the big memory area with huge page (yes = transparent huge page, hugetlb = MAP_HUGETLB with fallback) (default no)
+      //
       // MAX_KEEP_ALIVE Specifies the maximum number of requests that can be served through a Keep-Alive (Persistent) session.
       //                (Value <= 0 will disable Keep-Alive) (default 1020)
       //
@@ -86,6 +86,7 @@ union uuaddress {
 };
 
 extern U_EXPORT int         u_num_cpu;
+extern U_EXPORT int         u_simd_level; /* SIMD instruction set to scan the HTTP request: 0 - scalar, 1 - SSE2, 2 - AVX2 (-1 - to detect) */
 extern U_EXPORT const char* u_short_units[]; /* { "B", "KB", "MB", "GB", "TB", 0 } */
 
 U_EXPORT int         u_getScreenWidth(void) __pure; /* Determine the width of the terminal we're running on */
@@ -94,6 +95,8 @@ U_EXPORT const char* u_get_mimetype(const char* restrict suffix);
 U_EXPORT bool        u_isNumber(const char* restrict s, uint32_t n) __pure;
 U_EXPORT void        u_printSize(char* restrict buffer, uint64_t bytes); /* print size using u_calcRate() */
 U_EXPORT uint32_t    u_findEndHeader(const char* restrict s, uint32_t n); /* find sequence of U_LF2 or U_CRLF2 */
+U_EXPORT void        u_init_simd(void); /* select the SIMD instruction set (u_simd_level) with cpuid */
+U_EXPORT const char* u_skipUriChar(const char* restrict s, const char* restrict end); /* skip the char of URI until ' ', '?' or control char */
 U_EXPORT char*       u_getPathRelativ(const char* restrict path, uint32_t* restrict path_len);
 U_EXPORT double      u_calcRate(uint64_t bytes, uint32_t msecs, int* restrict units); /* Calculate the transfert rate */
 U_EXPORT bool        u_rmatch(const char* restrict haystack, uint32_t haystack_len, const char* restrict needle, uint32_t needle_len) __pure;
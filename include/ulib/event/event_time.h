@@ -21,10 +21,13 @@
 U_EXPORT struct event_base* u_ev_base;
 #endif
 
+class UTimer;
+
 class U_EXPORT UEventTime : public UTimeVal {
 public:
 
    struct timeval ctime;
+   UTimer* ptimer; // nodo della ruota delle scadenze (se inserito nel timer)
 
    void reset() { ctime.tv_sec = ctime.tv_usec = 0L; }
 
@@ -34,6 +37,8 @@ public:
 
       reset();
 
+      ptimer = 0;
+
 #  ifdef USE_LIBEVENT
       U_INTERNAL_ASSERT_POINTER(u_ev_base)
 
@@ -56,6 +56,10 @@
 #define U_FILE_TO_PARAM(file) (file).getPathRelativ(),(file).getPathRelativLen()
 #define U_FILE_TO_TRACE(file) (file).getPathRelativLen(),(file).getPathRelativ()
 
+// NB: size of the huge page (x86 default: 2M)...
+#define U_HUGE_PAGE_SIZE (2U * 1024U * 1024U)
+#define U_HUGE_PAGE_MASK (U_HUGE_PAGE_SIZE - 1)
+
 class URDB;
 class UHTTP;
 class UDirWalk;
@@ -656,6 +660,19 @@ public:
 
    static char* mmap(uint32_t* plength, int _fd = -1, int prot = PROT_READ | PROT_WRITE, int flags = MAP_SHARED | MAP_ANONYMOUS, uint32_t offset = 0);
 
+   // HUGE PAGE: 0 - disabled, 1 - transparent huge page (madvise(MADV_HUGEPAGE)), 2 - MAP_HUGETLB with fallback to 1
+   // --------------------------------------------------------------------------------------------------------------------
+   // NB: with MAP_HUGETLB we map only the shared anonymous area (that are unmapped all in one time), the private area are
+   //     carved and given back to the system in piece of 4K (see UMemoryPool::deallocate()) so we can only advise them...
+   // --------------------------------------------------------------------------------------------------------------------
+
+   static int huge_page;
+   static uint32_t nr_huge_page, nr_huge_page_fallback; // huge page obtained with MAP_HUGETLB, failed call to MAP_HUGETLB
+   static uint64_t size_huge_page_advise;               // bytes of the area advised with MADV_HUGEPAGE
+
+   static void     setHugePage(int mode);
+   static uint32_t writeHugePageInfo(char* buffer, uint32_t buffer_size);
+
    // MIME TYPE
 
    const char* getMimeType(bool bmagic);
@@ -895,6 +912,9 @@ protected:
    static void ftw_vector_push();
 
 private:
+   static void  adviseHugePage(char* ptr, uint32_t length) U_NO_EXPORT;
+   static char*   mmapHugePage(uint32_t* plength, int prot, int flags) U_NO_EXPORT;
+
 #ifdef __MINGW32__
    uint64_t u_inode;
 #endif
@@ -261,6 +261,14 @@
 
 #define U_NUM_STACK_TYPE 10
 
+// U_MEMORY_POOL_THREAD_CACHE: with thread every thread has its own magazine of blocks for each 'type' stack in front of
+// the global stacks (the depot), so the lock of the depot is needed only to refill or to give back half magazine...
+
+#if defined(ENABLE_MEMPOOL) && defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+#  define U_MEMORY_POOL_THREAD_CACHE
+#  define U_MAGAZINE_SIZE 32 // NB: must be even...
+#endif
+
 /* Implements a simple stack allocator */
 
 #define U_SIZE_TO_STACK_INDEX(sz) ((sz) <= U_STACK_TYPE_0 ? 0 : \
@@ -273,6 +281,15 @@
                                    (sz) <= U_STACK_TYPE_7 ? 7 : \
                                    (sz) <= U_STACK_TYPE_8 ? 8 : 9)
 
+// statistics of a 'type' stack (always available, also without DEBUG)...
+
+typedef struct umemorypoolstat {
+   uint64_t num_alloc, num_free; // call to pop()/push()
+   uint32_t num_miss,            // stack empty on pop() => new blocks are created (allocateMemoryBlocks())
+            in_use, max_in_use,  // blocks out of the stack (current and high-water)
+            size;                // bytes of the blocks created for the stack (preallocated + addMemoryBlocks() + miss)
+} umemorypoolstat;
+
 class UOptions;
 class UStringRep;
 class UServer_Base;
@@ -294,6 +311,24 @@ public:
    static void* _malloc(         uint32_t   num, uint32_t type_size = 1, bool bzero = false);
    static void* _malloc(         uint32_t* pnum, uint32_t type_size = 1, bool bzero = false);
 
+   // NB: a thread must give back the blocks of its magazines before to exit (see UThread::execHandler())...
+
+   static void flushThreadCache();
+
+   // statistics: NB with thread the counters of call of a thread are added to the global ones only when the thread use the depot
+   //             (or call writeInfo()), and the blocks in the magazines are counted as in use...
+
+   static umemorypoolstat pool_stat[U_NUM_STACK_TYPE]; // 10
+
+   static uint32_t writeInfo(char* buffer, uint32_t buffer_size);
+
+#if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+   // NB: the lock of the depot serialize also the allocation from the area of UFile::mmap() (UFile::pfree), it is recursive...
+
+   static void lock();
+   static void unlock();
+#endif
+
 #ifdef DEBUG
    static const char* obj_class;
    static const char* func_call;
@@ -323,6 +358,82 @@ private:
    friend class UStackMemoryPool;
 };
 
+// -------------------------------------------------------------------------------------------------------------------
+// UMemoryArena: request-scoped bump allocator for UStringRep (opt-in with the REQ_ARENA_SIZE directive of userver)
+// -------------------------------------------------------------------------------------------------------------------
+// The area is reserved only one time and it is divided in chunk of U_ARENA_CHUNK_SIZE aligned to their size, so from
+// a pointer we get the chunk with a mask. Every chunk count its live allocation: the release of a string allocated on
+// the arena only decrement the counter and, when it goes to zero, the chunk is rewound in one shot. If a string survive
+// the request (cache, session, ...) its chunk stay pinned until the string die, so we never reuse memory still in use...
+// -------------------------------------------------------------------------------------------------------------------
+
+#define U_ARENA_CHUNK_SIZE (64U * 1024U)
+
+typedef struct uarenachunk {
+   struct uarenachunk* next; // list of free chunk
+   uint32_t live, used;
+} uarenachunk;
+
+class U_EXPORT UMemoryArena {
+public:
+
+   static char* base; // reserved area [base,limit)...
+   static char* limit;
+#ifdef ENABLE_THREAD
+   static __thread bool active; // NB: we allocate from the arena only between begin() and end() of the processing of a request,
+#else                           //     and only in the thread that process it (the other thread allocate always from the pool)...
+   static bool active;
+#endif
+
+   // statistics
+
+   static uint64_t total_size;
+   static uint32_t num_request, max_size, request_size, num_fallback, num_pinned;
+
+   static bool init(uint32_t sz);
+   static void clear();
+
+   static void* allocate(uint32_t sz);
+   static void  release(void* ptr);
+
+   static bool isArena(const void* ptr)
+      {
+      U_TRACE(0, "UMemoryArena::isArena(%p)", ptr)
+
+      bool result = ((const char*)ptr >= base && (const char*)ptr < limit);
+
+      U_RETURN(result);
+      }
+
+   static void begin()
+      {
+      U_TRACE(0, "UMemoryArena::begin()")
+
+      U_INTERNAL_ASSERT_POINTER(base)
+
+      if (bclear) return;
+
+      active       = true;
+      request_size = 0;
+      }
+
+   static void end();
+
+   static uint32_t writeInfo(char* buffer, uint32_t buffer_size);
+
+private:
+   static char* next_chunk;
+   static uarenachunk* current;
+   static uarenachunk* free_chunk;
+   static uint32_t num_live; // NB: the allocation still alive on the arena (clear() unmap the area only when it goes to zero)...
+   static bool bclear;
+
+   static bool newChunk() U_NO_EXPORT;
+
+   UMemoryArena(const UMemoryArena&)            {}
+   UMemoryArena& operator=(const UMemoryArena&) { return *this; }
+};
+
 //#define ENABLE_NEW_VECTOR yes // I don't understand what happen with this...
 
 template <class T> T* u_new_vector(uint32_t& n, int32_t* poffset)
@@ -33,6 +33,9 @@
 #  define FILETEST_RES (const char*)0
 #endif
 
+// NB: max size of the queue of the responses for pipelined requests, over this we write it anyway (with TCP_CORK on)...
+#define U_MAX_SIZE_RESPONSE_QUEUE (64U * 1024U)
+
 /**
    @class UClientImage
 
@@ -51,14 +54,20 @@ public:
    USocket* socket;
    UString* logbuf;
    time_t last_event;
+   UClientImage_Base* prev_idle; // NB: intrusive list of connection ordered by last_event (LRU) to check for idle connection...
+   UClientImage_Base* next_idle;
+
+   static UClientImage_Base* first_idle;
+   static UClientImage_Base* last_idle;
 
    static UString* body;
    static UString* rbuffer;
    static UString* wbuffer;
    static UString* request; // NB: it is only a pointer, not a string object...
    static UString* pbuffer;
+   static UString* qbuffer; // NB: responses of pipelined requests waiting to be written with only one writev()...
    static UString* environment;
-   static bool bIPv6, pipeline, write_off;
+   static bool bIPv6, pipeline, write_off, bcork;
    static uint32_t rstart, size_request, counter;
 
    // NB: these are for ULib Servlet Page (USP) - USP_PRINTF...
@@ -82,7 +91,7 @@ public:
       {
       U_TRACE(0, "UClientImage_Base::isPendingWrite()")
 
-      U_RETURN(count > 0);
+      U_RETURN(count > 0 || range_num > 0); // NB: with multi-range response also the header of the next part...
       }
 
    static void init();
@@ -143,6 +152,26 @@ public:
 
    static void manageRequestSize(bool request_resize);
 
+   // NB: while we have other request available in pipeline the responses are queued (qbuffer) and written all together
+   //     with the response of the last request. We must flush the queue before anybody else write on the socket...
+
+   static bool isResponseQueued()
+      {
+      U_TRACE(0, "UClientImage_Base::isResponseQueued()")
+
+      bool result = (qbuffer && qbuffer->empty() == false);
+
+      U_RETURN(result);
+      }
+
+   bool flushResponseQueue();
+
+   // manage idle connection: the head of the list is the connection with the oldest last_event, so the check
+   // for timeout can stop at the first connection not expired without scanning all the connection...
+
+   void setLastEvent();
+   void eraseIdle();
+
    // DEBUG
 
 #ifdef DEBUG
@@ -150,9 +179,36 @@ public:
 #endif
 
 protected:
-   uint32_t start, count;
+   uint32_t start, count, nrequest; // NB: nrequest is the number of request served on this connection (per-child metrics)...
+
+   // NB: the request is recorded in the per-child metrics only when the response is completed (with a pending sendfile()
+   //     it happens in handlerWrite()), request_start == 0 means already recorded...
+
+   uint64_t request_start;
+   uint32_t request_in, request_out, request_code;
+
+   void setRequestMetrics();
+   void endRequestMetrics();
    int state, sfd, bclose;
 
+   // NB: multi-range response (multipart/byteranges) with sendfile(), after every segment of the file we write the header
+   //     of the next part or the closing boundary (see UHTTP::checkGetRequestForRange())...
+
+   typedef struct range_segment {
+      uint32_t start, count, len; // NB: the segment of the file and the size of the text that follow it in range_part...
+   } range_segment;
+
+   UString* range_part;
+   range_segment* vrange;
+   uint32_t range_num, range_index, range_pos;
+
+   void resetRange();
+
+   // NB: the read of the segment to send with sendfile() in progress on a thread of disk I/O is for this connection only if the
+   //     generation is the same (the object can be reused by another connection before the completion, see UServer_Base::handlerDiskIO())...
+
+   uint32_t disk_io_gen;
+
    static UString* msg_welcome;
 
    // COSTRUTTORI
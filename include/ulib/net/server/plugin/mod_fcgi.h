@@ -53,9 +53,6 @@ protected:
    static bool fcgi_keep_conn;
    static UClient_Base* connection;
 
-          void set_FCGIBeginRequest();
-   static void fill_FCGIBeginRequest(u_char type, u_short content_length);
-
 private:
    UFCGIPlugIn(const UFCGIPlugIn&) : UServerPlugIn() {}
    UFCGIPlugIn& operator=(const UFCGIPlugIn&)        { return *this; }
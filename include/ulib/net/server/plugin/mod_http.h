@@ -40,6 +40,12 @@ public:
    static const UString* str_APACHE_LIKE_LOG;
    static const UString* str_USP_AUTOMATIC_ALIASING;
    static const UString* str_CACHE_FILE_STORE;
+   static const UString* str_STATUS_URI;
+   static const UString* str_MICRO_CACHE_SIZE;
+   static const UString* str_MICRO_CACHE_TTL;
+   static const UString* str_MICRO_CACHE_SHARED;
+   static const UString* str_MICRO_CACHE_MAX_TTL;
+   static const UString* str_CACHE_FILE_SHARED;
 
    static void str_allocate();
 
@@ -79,6 +85,11 @@ public:
    const char* dump(bool reset) const { return UEventFd::dump(reset); }
 #endif
 
+protected:
+   static UString* status_uri;
+
+   static void setStatusResponse() U_NO_EXPORT;
+
 private:
    UHttpPlugIn(const UHttpPlugIn&) : UServerPlugIn(), UEventFd() {}
    UHttpPlugIn& operator=(const UHttpPlugIn&)                    { return *this; }
@@ -89,6 +89,7 @@ class UClient_Base;
 class UProxyPlugIn;
 class UStreamPlugIn;
 class UModNoCatPeer;
+class UDiskIOThread;
 class UClientThread;
 class UWebSocketPlugIn;
 class UModProxyService;
@@ -112,6 +113,7 @@ public:
    // LISTEN_BACKLOG        max number of ready to be delivered connections to accept()
    // USE_TCP_OPTIMIZATION  flag indicating the use of TCP/IP options to optimize data transmission (DEFER_ACCEPT, QUICKACK)
    // SET_REALTIME_PRIORITY flag indicating that the preforked processes will be scheduled under the real-time policies SCHED_FIFO
+   // ENABLE_REUSEPORT      flag indicating that every preforked process accept connections on its own listening socket (SO_REUSEPORT)
    //
    // PID_FILE      write pid on file indicated
    // WELCOME_MSG   message of welcome to send initially to client
@@ -124,9 +126,15 @@ public:
    //
    // PLUGIN        list of plugins to load, a flexible way to add specific functionality to the server
    // PLUGIN_DIR    directory of plugins to load
+   // PLUGIN_TIMING measure with the time stamp counter of the cpu the latency of the connection-wide hooks of every plugin (default no)
    //
    // REQ_TIMEOUT   timeout for request from client
    // CGI_TIMEOUT   timeout for cgi execution
+   // TIMER_TICK    resolution (ms) of the wheel of the internal timer (UTimer), a coarser tick reduce the work for many alarm (default 1)
+   //
+   // REQ_ARENA_SIZE size of the area reserved for the request-scoped allocation of strings (default 0 - disabled)
+   // HUGE_PAGES     back the big memory area with huge page (yes = transparent huge page, hugetlb = MAP_HUGETLB with fallback) (default no)
+   // DISK_IO_THREAD number of threads (for every process) that read from disk the data of the file not in page cache (default 0 - disabled)
    //
    // MAX_KEEP_ALIVE Specifies the maximum number of requests that can be served through a Keep-Alive (Persistent) session.
    //                (Value <= 0 will disable Keep-Alive)
@@ -142,6 +150,9 @@ public:
    // PREFORK_CHILD number of child server processes created at startup ( 0 - serialize, no forking
    //                                                                     1 - classic, forking after client accept
    //                                                                    >1 - pool of serialized processes plus monitoring process)
+   //
+   // SIGQUIT  graceful stop: we stop to accept and we exit when the connections in progress are completed
+   // SIGWINCH binary upgrade: we exec again our binary passing to it the listening sockets (see handlerForSigWINCH())
    // -----------------------------------------------------------------------------------------------------------------------------
 
    static const UString* str_ENABLE_IPV6;
@@ -184,6 +195,12 @@ public:
    static const UString* str_LISTEN_BACKLOG;
    static const UString* str_SET_REALTIME_PRIORITY;
    static const UString* str_ENABLE_RFC1918_FILTER;
+   static const UString* str_ENABLE_REUSEPORT;
+   static const UString* str_REQ_ARENA_SIZE;
+   static const UString* str_HUGE_PAGES;
+   static const UString* str_PLUGIN_TIMING;
+   static const UString* str_DISK_IO_THREAD;
+   static const UString* str_TIMER_TICK;
 
    static void str_allocate();
 
@@ -249,6 +266,36 @@ public:
    static int pluginsHandlerRequest();
    static int pluginsHandlerReset();
 
+   // NB: the connection-wide hooks are called through a dispatch list (built after the load of the plugins) that contain
+   //     only the plugins that redefine the hook, so that we don't call for every request the hooks that do nothing...
+
+#define U_HOOK_READ    0
+#define U_HOOK_Request 1
+#define U_HOOK_Reset   2
+#define U_NUM_HOOK     3
+
+   typedef struct plugin_hook {
+      UServerPlugIn* plugin;
+      uint32_t index; // NB: index of the plugin in vplugin...
+   } plugin_hook;
+
+   static plugin_hook* vhook[U_NUM_HOOK];
+   static uint32_t vhook_size[U_NUM_HOOK];
+
+   // PLUGIN_TIMING: for every plugin and connection-wide hook we accumulate the time spent (cpu cycle with rdtsc) in a slot
+   // of the shared data (one area for every preforked child, as the per-child metrics), shown by writeMetrics()...
+
+#define U_NUM_HOOK_BUCKET 29 // log2 of the cpu cycle: [0] < 2^8, [1] < 2^9, ..., [28] >= 2^35
+
+   typedef struct plugin_hook_stat {
+      uint64_t count, total, max;
+      uint64_t histogram[U_NUM_HOOK_BUCKET];
+   } plugin_hook_stat;
+
+   static bool plugin_timing;
+   static plugin_hook_stat* ptr_hook_stat; // NB: the area of all the process...
+   static plugin_hook_stat* phook_stat;    // NB: the area of this process (vplugin_size * U_NUM_HOOK slot)...
+
    // ----------------------------------------------------------------------------------------------------------------------------
    // Manage process server
    // ----------------------------------------------------------------------------------------------------------------------------
@@ -258,17 +305,29 @@ public:
    //                                                                    >1 - pool of serialized processes plus monitoring process
    // ----------------------------------------------------------------------------------------------------------------------------
 
+   // NB: with preforked children the store of the http session is split in shard (URDB with own lock and journal) selected by the
+   //     hash of the key, and every key have also a slot of sequence counter (seqlock) to validate the copy in the private cache of
+   //     the process without taking the lock (see UHTTP::getSessionData())...
+
+#  define U_HTTP_SESSION_SHARD    8U // NB: must be a power of 2...
+#  define U_HTTP_SESSION_SEQ   1024U // NB: must be a power of 2...
+
    typedef struct shared_data {
    // ---------------------------------
       sem_t lock_user1;
       sem_t lock_user2;
       sem_t lock_rdb_server;
       sem_t lock_ssl_session;
-      sem_t lock_http_session;
+      sem_t lock_http_session[U_HTTP_SESSION_SHARD];
+      sem_t lock_micro_cache;
    // ---------------------------------
       sig_atomic_t cnt_user1;
       sig_atomic_t cnt_user2;
       sig_atomic_t cnt_connection;
+   // ---------------------------------
+      uint32_t seq_http_session[U_HTTP_SESSION_SEQ]; // NB: even -> stable, odd -> write in progress (changed atomically)...
+      uint32_t shard_http_session;                   // NB: next shard for the incremental sweep of the expired session...
+      long sweep_http_session, max_age_http_session;
    // ---------------------------------
       struct timeval _timeval;
       long last_sec[3];
@@ -288,7 +347,8 @@ public:
 #define U_LOCK_USER2        &(UServer_Base::ptr_shared_data->lock_user2)
 #define U_LOCK_RDB_SERVER   &(UServer_Base::ptr_shared_data->lock_rdb_server)
 #define U_LOCK_SSL_SESSION  &(UServer_Base::ptr_shared_data->lock_ssl_session)
-#define U_LOCK_HTTP_SESSION &(UServer_Base::ptr_shared_data->lock_http_session)
+#define U_LOCK_HTTP_SESSION(n) &(UServer_Base::ptr_shared_data->lock_http_session[n])
+#define U_LOCK_MICRO_CACHE  &(UServer_Base::ptr_shared_data->lock_micro_cache)
 #define U_CNT_USER1           UServer_Base::ptr_shared_data->cnt_user1
 #define U_CNT_USER2           UServer_Base::ptr_shared_data->cnt_user2
 #define U_TOT_CONNECTION      UServer_Base::ptr_shared_data->cnt_connection
@@ -297,6 +357,7 @@ public:
 
    static pid_t pid;
    static int preforked_num_kids; // keeping a pool of children and that they accept connections themselves
+   static int child_index;        // index of the preforked child in the pool (0 .. preforked_num_kids-1)
    static shared_data* ptr_shared_data;
    static uint32_t shared_data_add, map_size;
 
@@ -323,6 +384,34 @@ public:
       U_RETURN_POINTER(shared_data_ptr, void);
       }
 
+   // ----------------------------------------------------------------------------------------------------------------------------
+   // Per-child metrics: a vector of slot (one for every preforked child) in the shared data, every process write only in its own
+   // slot (256 bytes, aligned on cache line to avoid false sharing) with plain store, so the update don't need any lock. Anyone
+   // (for example the process that serve the STATUS_URI of mod_http) can read all the slot and aggregate them...
+   // ----------------------------------------------------------------------------------------------------------------------------
+
+#define U_NUM_LATENCY_BUCKET 20 // log2 of the microsecond: [0] < 2us, [1] < 4us, ..., [19] >= 2^19us (~0.5 sec)
+
+   typedef struct child_metrics {
+      uint64_t num_request;
+      uint64_t num_keep_alive; // request served on a connection already used (keep-alive or pipeline)
+      uint64_t bytes_in;
+      uint64_t bytes_out;
+      uint64_t cache_hit;      // lookup on the file cache
+      uint64_t cache_miss;
+      uint64_t status[5];      // response code class: 1xx 2xx 3xx 4xx 5xx
+      uint64_t latency[U_NUM_LATENCY_BUCKET];
+      long pid;
+   } child_metrics;
+
+   static child_metrics* ptr_child_metrics; // NB: the vector of slot...
+   static child_metrics* pmetrics;          // NB: the slot of this process...
+
+   static uint64_t metricsRequestBegin();
+   static void     metricsRequestEnd(uint64_t start, uint32_t code, uint32_t bytes_in, uint32_t bytes_out, bool bkeep_alive);
+
+   static void writeMetrics(UString& buffer);
+
    static int32_t            oClientImage;
    static UClientImage_Base* pClientImage;
    static UClientImage_Base* vClientImage;
@@ -384,6 +473,27 @@ public:
       U_RETURN(result);
       }
 
+   // DISK_IO_THREAD: the data of the file not in the cache of document root are sent with sendfile(), that with a cold page cache
+   // block on the read from disk the event loop of the process (and so all its connections). If the segment to send is not in
+   // page cache we give the read of the segment to a thread of the pool and the connection wait (without event of write) until
+   // the thread notify us (eventfd) that the data are in page cache...
+
+#define U_DISK_IO_WINDOW (1024U * 1024U) // NB: max size of the segment read by the thread (and sent with one sendfile())...
+
+   static int disk_io_thread;
+   static UEventFd* handler_disk_io;
+
+   static bool isDiskIO()
+      {
+      U_TRACE(0, "UServer_Base::isDiskIO()")
+
+      U_RETURN(handler_disk_io != 0);
+      }
+
+   static bool isDataNotResident(int fd, uint32_t offset, uint32_t count);
+   static bool readDataAsync(UClientImage_Base* pclient, uint32_t count);
+   static void handlerDiskIO(); // NB: resume the connections whose data are been read by the threads...
+
    // manage log server...
 
    typedef struct file_LOG {
@@ -444,17 +554,25 @@ protected:
    static UString* host;
    static UProcess* proc;
    static USocket* socket;
-   static int sfd, bclose;
+   static pid_t* vchild_pid;
+   static int* vreuseport_fd;
    static UEventTime* ptime;
    static UServer_Base* pthis;
    static UString* senvironment;
-   static uint32_t start, count;
-   static time_t expire, last_event;
+   static time_t last_event;
    static UVector<UIPAllow*>* vallow_IP;
    static UVector<UIPAllow*>* vallow_IP_prv;
-   static bool flag_loop, flag_use_tcp_optimization, monitoring_process,
+   static bool flag_loop, flag_use_tcp_optimization, monitoring_process, enable_reuseport,
                accept_edge_triggered, set_realtime_priority, enable_rfc1918_filter, public_address;
 
+   // NB: binary upgrade (SIGWINCH) and graceful stop (SIGQUIT), see handlerForSigWINCH()...
+
+   static bool flag_drain; // NB: we don't accept new connection and we exit when the connections in progress are completed...
+   static pid_t upgrade_pid; // NB: the old server that we must stop when we are ready to accept...
+   static int* vupgrade_fd; // NB: the listening sockets inherited from the old server...
+   static int nupgrade_fd;
+   static UString* cwd_startup; // NB: to exec the new binary with the same (maybe relative) path of the command line...
+
    // COSTRUTTORI
 
             UServer_Base(UFileConfig* cfg);
@@ -533,7 +651,11 @@ protected:
    // SERVICES
 
    static RETSIGTYPE handlerForSigHUP( int signo);
+   static RETSIGTYPE handlerForSigCHLD(int signo);
    static RETSIGTYPE handlerForSigTERM(int signo);
+   static RETSIGTYPE handlerForSigUSR2(int signo);
+   static RETSIGTYPE handlerForSigQUIT(int signo);
+   static RETSIGTYPE handlerForSigWINCH(int signo);
 
 private:
    friend class UHTTP;
@@ -548,14 +670,25 @@ private:
    friend class UGeoIPPlugIn;
    friend class UClient_Base;
    friend class UStreamPlugIn;
+   friend class UDiskIOThread;
    friend class UClientThread;
    friend class UModNoCatPeer;
    friend class UWebSocketPlugIn;
    friend class UModProxyService;
    friend class UClientImage_Base;
 
+   static void initDiskIO() U_NO_EXPORT;
+   static void initReusePort() U_NO_EXPORT;
+   static void setReusePortChild() U_NO_EXPORT;
    static void logMemUsage(const char* signame) U_NO_EXPORT;
+   static void logMemoryArena() U_NO_EXPORT;
+   static void logMemoryPool(const char* signame) U_NO_EXPORT;
    static void loadStaticLinkedModules(const char* name) U_NO_EXPORT;
+   static void buildHookList() U_NO_EXPORT;
+   static void initUpgrade() U_NO_EXPORT;
+   static void stopOldServer() U_NO_EXPORT;
+   static void drainConnection() U_NO_EXPORT;
+   static void execNewBinary() U_NO_EXPORT;
 
    UServer_Base(const UServer_Base&) : UEventFd() {}
    UServer_Base& operator=(const UServer_Base&)   { return *this; }
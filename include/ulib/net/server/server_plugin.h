@@ -38,7 +38,7 @@ UServer has 8 hooks which are used in different states of the execution of the r
 6) handlerREAD:
 7) handlerRequest:
 8) handlerReset:
-  called in `UClientImage_Base::handlerRead()`
+  called in `UClientImage_Base::handlerRead()` (through a dispatch list with only the plugins that redefine the hook)
 --------------------------------------------------------------------------------------------
 
 RETURNS:
@@ -52,6 +52,10 @@
 #ifndef SOCK_CLOEXEC
 #define SOCK_CLOEXEC    02000000
 #endif
+/* Steer the new connection of a SO_REUSEPORT group to the socket bound to the same cpu */
+#if defined(__linux__) && !defined(SO_INCOMING_CPU)
+#define SO_INCOMING_CPU 49
+#endif
 
 /**
    @class USocket
@@ -482,6 +486,21 @@ public:
 #  endif
       }
 
+   /**
+    * SO_INCOMING_CPU: with a group of listening sockets bound with SO_REUSEPORT the kernel prefer, for the new connection,
+    * the socket whose value match the cpu that processed the incoming packet. It is useful only if the process that accept
+    * on this socket is pinned to the same cpu...
+    ***/
+
+   static void setIncomingCPU(int fd, int cpu)
+      {
+      U_TRACE(1, "USocket::setIncomingCPU(%d,%d)", fd, cpu)
+
+#  ifdef SO_INCOMING_CPU
+      (void) U_SYSCALL(setsockopt, "%d,%d,%d,%p,%u", fd, SOL_SOCKET, SO_INCOMING_CPU, (const void*)&cpu, sizeof(int));
+#  endif
+      }
+
    /**
    Enables/disables the @c SO_TIMEOUT pseudo option
 
@@ -16,8 +16,28 @@
 
 #include <ulib/event/event_time.h>
 
+class UEventFd;
+
 // Il notificatore degli eventi usa questa classe per notificare una scadenza temporale rilevata da select()
 
+// --------------------------------------------------------------------------------------------------------------
+// the scheduled alarms are kept in a hierarchical timing wheel of two level: the absolute expire time is converted
+// in a number of tick (U_TIMER_TICK milliseconds by default, see setTick()) and the node is linked (doubly) in the
+// slot (expire & U_TIMER_WHEEL_MASK) of the first level if it expire in the next turn of the wheel (1024 tick, about
+// one second with the default tick), otherwise in the slot of its block of U_TIMER_WHEEL_SIZE tick in the second
+// level (1024 block, about 17 minutes with the default tick, es: the keep-alive timeout of the connection). When the
+// current tick enter a block the alarms of the block are moved (cascade) in the first level. Insertion and cancellation
+// are O(1), the expire processing cost is proportional to the elapsed ticks (the empty block are skipped) plus the
+// expired alarms, and setitimer() is reprogrammed only when a new alarm expire before the one currently armed...
+// --------------------------------------------------------------------------------------------------------------
+
+#ifndef U_TIMER_TICK
+#define U_TIMER_TICK       1 // ms
+#endif
+#define U_TIMER_WHEEL_BITS 10
+#define U_TIMER_WHEEL_SIZE (1U << U_TIMER_WHEEL_BITS)
+#define U_TIMER_WHEEL_MASK (U_TIMER_WHEEL_SIZE-1)
+
 class U_EXPORT UTimer {
 public:
    // Check for memory error
@@ -34,8 +54,11 @@ public:
       {
       U_TRACE_REGISTER_OBJECT(0, UTimer, "")
 
-      next  = 0;
-      alarm = 0;
+      next   = 0;
+      prev   = 0;
+      alarm  = 0;
+      expire = 0;
+      level2 = false;
 
       U_INTERNAL_DUMP("this = %p memory._this = %p", this, memory._this)
       }
@@ -48,7 +71,7 @@ public:
       {
       U_TRACE(0, "UTimer::empty()")
 
-      bool result = (first == 0);
+      bool result = (num == 0);
 
       U_RETURN(result);
       }
@@ -65,23 +88,15 @@ public:
 
    static void stop();
    static void init(bool async);
+   static bool initTimerFd(); // the expire are delivered as readable event (timerfd) through UNotifier instead of SIGALRM
+   static void setTick(long ms); // coarse tick (es: 1000ms for connection timeout), to call when the timer is empty
    static void setTimer(bool bsignal);
    static void clear(bool clean_alarm);
 
    static void insert(UEventTime* alarm,                  bool set_timer = true);
    static void  erase(UEventTime* alarm, bool flag_reuse, bool set_timer = true);
 
-   static bool isHandler(UEventTime* _alarm)
-      {
-      U_TRACE(0, "UTimer::isHandler(%p)", _alarm)
-
-      for (UTimer* item = first; item; item = item->next)
-         {
-         if (item->alarm == _alarm) U_RETURN(true);
-         }
-
-      U_RETURN(false);
-      }
+   static bool isHandler(UEventTime* _alarm) __pure;
 
    // manage signal
 
@@ -101,18 +116,67 @@ public:
 
 protected:
    UTimer* next;
+   UTimer** prev; // puntatore al puntatore che ci referenzia (slot della ruota o next del nodo precedente)
    UEventTime* alarm;
-
-   static bool async;
-   static UTimer* pool;  // lista scadenze da cancellare o riutilizzare
-   static UTimer* first; // lista scadenze
+   uint32_t expire; // scadenza assoluta in tick
+   bool level2; // il nodo e' nel secondo livello della ruota
+
+   static bool async, brun;
+   static UTimer* pool;    // lista scadenze da cancellare o riutilizzare
+   static UTimer* pending; // slot in corso di elaborazione in setTimer()
+   static UTimer* wheel[U_TIMER_WHEEL_SIZE];  // ruota delle scadenze (primo livello: un tick per slot)
+   static UTimer* wheel2[U_TIMER_WHEEL_SIZE]; // ruota delle scadenze (secondo livello: U_TIMER_WHEEL_SIZE tick per slot)
+   static uint32_t num, num2, tick, current, armed; // numero scadenze (totale e nel secondo livello), durata tick (ms), ultimo tick elaborato, tick armato con setitimer()
+   static time_t start; // origine del conteggio dei tick
+   static UEventFd* handler_timerfd;
    static struct itimerval timerval;
 
+   static uint32_t getTick(uint32_t ms_ahead = 0)
+      {
+      U_TRACE(0, "UTimer::getTick(%u)", ms_ahead)
+
+      uint64_t ms = (uint64_t)(u_now->tv_sec - start) * 1000ULL + (u_now->tv_usec / 1000L) + ms_ahead;
+
+      uint32_t result = (uint32_t)(ms / tick);
+
+      U_RETURN(result);
+      }
+
+   void link(UTimer** ptr)
+      {
+      U_TRACE(0, "UTimer::link(%p)", ptr)
+
+      if ((next = *ptr)) next->prev = &next;
+
+      prev = ptr;
+      *ptr = this;
+      }
+
+   void unlink()
+      {
+      U_TRACE(0, "UTimer::unlink()")
+
+      U_INTERNAL_ASSERT_POINTER(prev)
+
+      if (next) next->prev = prev;
+
+      *prev = next;
+       prev = 0;
+       next = 0;
+      }
+
 private:
+          void linkEntry() U_NO_EXPORT;
+          void unlinkEntry() U_NO_EXPORT;
           void insertEntry() U_NO_EXPORT;
           void outputEntry(ostream& os) const U_NO_EXPORT;
    inline void callHandlerTime() U_NO_EXPORT;
 
+   static void cascade(uint32_t _tick) U_NO_EXPORT;
+   static void setNextTick() U_NO_EXPORT;
+   static void setTimerVal() U_NO_EXPORT;
+   static void deleteList(UTimer* item, bool clean_alarm) U_NO_EXPORT;
+
    bool operator< (const UTimer& t) const { return (*alarm < *t.alarm); }
    bool operator> (const UTimer& t) const { return  t.operator<(*this); }
    bool operator<=(const UTimer& t) const { return !t.operator<(*this); }
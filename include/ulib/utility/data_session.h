@@ -24,6 +24,23 @@
 
 class UHTTP;
 
+/**
+   @class UDataSession
+
+   @brief UDataSession is the data of a http session (see UHTTP), it is stored with toString() in a compact binary format
+
+   ------------------------------------------------------------------------------------------------------------------------------
+   | version (1) | creation (4) | n (4) | len (4) | value | ... | len (4) | value | data of the subclass with toStream() (text) |
+   ------------------------------------------------------------------------------------------------------------------------------
+
+   The values are decoded by fromString() as substring of the stored string (without copy). The old text format (that start
+   with ' ') is still recognized by fromString() for migration. A record with a length out of the string is refused by fromString()
+   (return false) and the session is left empty...
+*/
+
+#define U_DATA_SESSION_VERSION '\001'
+#define U_DATA_SESSION_HEADER  (1U + sizeof(uint32_t) + sizeof(uint32_t))
+
 class U_EXPORT UDataSession {
 public:
 
@@ -57,11 +74,20 @@ public:
    // SERVICES
 
    UString   toString();
-   void    fromString(const UString& data);
+   bool    fromString(const UString& data);
 
    bool getValue(uint32_t index,       UString& value);
    void putValue(uint32_t index, const UString& value);
 
+   static time_t getCreation(const char* ptr)
+      {
+      U_TRACE(0, "UDataSession::getCreation(%p)", ptr)
+
+      time_t result = (ptr[0] == U_DATA_SESSION_VERSION ? (time_t)u_get_unalignedp(ptr+1) : (time_t)strtol(ptr, 0, 10));
+
+      U_RETURN(result);
+      }
+
    // method VIRTUAL to define
 
    virtual void clear();
@@ -84,6 +110,8 @@ public:
 protected:
    UString data;
 
+   static bool bbinary; // NB: toStream()/fromStream() are called only for the data of the subclass (see toString())...
+
 private:
    UDataSession(const UDataSession&)            {}
    UDataSession& operator=(const UDataSession&) { return *this; }
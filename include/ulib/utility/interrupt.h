@@ -16,6 +16,8 @@
 
 #include <ulib/internal/common.h>
 
+class UEventFd;
+
 struct U_EXPORT UInterrupt {
 
    static struct sigaction act;
@@ -114,6 +116,26 @@ struct U_EXPORT UInterrupt {
 
    static void callHandlerSignal();
    static bool checkForEventSignalPending();
+
+   // manage signal delivered as readable event (signalfd): the signal are blocked and read by the event loop (UNotifier)
+   // through handler_signalfd, so there is no EINTR on the system call of the hot path...
+
+   static int fd_signal;
+   static sigset_t mask_signalfd;
+   static UEventFd* handler_signalfd;
+
+   static bool initSignalFd(); // return false if signalfd is not available (the caller must use the async signal)
+   static void waitForSignalFd();
+   static bool callHandlerSignalFd();
+   static void discardSignal(int signo);
+
+   static void  eraseSignalFd(int signo);
+   static void insertSignalFd(int signo, sighandler_t handler);
+
+private:
+   static pid_t pid_signalfd; // NB: the process that own the open file of signalfd (after fork() it is shared with the parent)...
+
+   static void setSignalFd() U_NO_EXPORT;
 };
 
 #endif
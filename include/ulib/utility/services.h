@@ -74,6 +74,10 @@ struct U_EXPORT UServices {
       while (UServices::read(fd, buffer, U_SINGLE_READ, -1)) {}
       }
 
+   // read while received data, timeoutMS is for the whole read and not for every read (return false if the time is expired)
+
+   static bool readEOF(int fd, UString& buffer, int timeoutMS);
+
    // generic MatchType { U_FNMATCH = 0, U_DOSMATCH = 1, U_DOSMATCH_WITH_OR = 2 };
 
    static bool match(const UString& s, const UString& mask)
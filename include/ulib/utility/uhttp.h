@@ -34,7 +34,13 @@
 #define U_HTTP_REALM "Protected Area" // HTTP Access Authentication
 
 #define U_MAX_UPLOAD_PROGRESS         16
+#define U_MICRO_CACHE_KEY_SIZE       512 // NB: method, version, connection flags, accept gzip, virtual host and uri with query...
+#define U_MICRO_CACHE_MAX_RESPONSE   (64U * 1024U)
+#define U_HTTP_HEADER_INDEX_SIZE      64 // NB: must be a power of 2, over 3/4 of header lines we scan the request...
 #define U_MIN_SIZE_FOR_PARTIAL_WRITE (16U * 1024U)
+#define U_READY_RESPONSE_PREFIX       96 // NB: room for status line, Server, Date and Connection written before a ready response...
+#define U_CACHE_FILE_EVENT_MAX       256 // NB: size of the log of the change of file system (inotify) replayed by the children...
+#define U_CACHE_FILE_EVENT_PATH      248
 
 #define U_HTTP_BODY(str)                    (str).substr(u_http_info.endHeader, u_http_info.clength)
 #define U_HTTP_HEADER(str)                  (str).substr(u_http_info.startHeader, u_http_info.szHeader)
@@ -42,7 +48,10 @@
 #define U_HTTP_URI_DOSMATCH(mask,len,flags) (u_dosmatch_with_OR(U_HTTP_URI_TO_PARAM, mask, len, flags))
 #define U_HTTP_URI_OR_ALIAS_STRNEQ(req,str) (U_HTTP_URI_STRNEQ(str) || (req).equal(U_CONSTANT_TO_PARAM(str)))
 
+class ULock;
 class UFile;
+class URDB;
+class UCache;
 class UEventFd;
 class UCommand;
 class UPageSpeed;
@@ -172,7 +181,6 @@ public:
 
    static UString* uri;
    static UString* alias;
-   static UString* cbuffer;
    static UString* pathname;
    static UString* request_uri;
    static UString* global_alias;
@@ -212,8 +220,23 @@ public:
       U_http_method_len = 0; // NB: this mark the end of http request processing...
       }
 
-   static const char* getHeaderValuePtr(                        const UString& name, bool nocase) __pure;
-   static const char* getHeaderValuePtr(const UString& request, const UString& name, bool nocase) __pure;
+   // NB: the header lines of the request are indexed (hash of the name -> offset of the value) at the second lookup, so the
+   //     other lookups of the same request are hash probes. The known header looked up by name have a precomputed id...
+
+   enum HeaderKnownId {
+      HEADER_AUTHORIZATION       = 0,
+      HEADER_IF_RANGE            = 1,
+      HEADER_IF_NONE_MATCH       = 2,
+      HEADER_IF_UNMODIFIED_SINCE = 3,
+      HEADER_TRANSFER_ENCODING   = 4,
+      HEADER_X_PROGRESS_ID       = 5,
+      HEADER_KNOWN_NUM           = 6
+   };
+
+   static const char* getHeaderValuePtr(                        const UString& name, bool nocase);
+   static const char* getHeaderValuePtr(const UString& request, const UString& name, bool nocase);
+   static const char* getHeaderValuePtr(                        HeaderKnownId id,    bool nocase);
+   static const char* getHeaderValuePtr(const UString& request, HeaderKnownId id,    bool nocase);
 
    // set HTTP main error message
 
@@ -237,7 +260,13 @@ public:
    static UString getHeaderForResponse(const UString& content, bool connection_close);
 
 #ifdef U_HTTP_CACHE_REQUEST
-   static void  clearRequestCache();
+   // NB: micro-cache of the responses: the fully built responses (static file, USP, CGI) of GET/HEAD requests are kept for a short time
+   //     (per entry TTL) in a table shared by all the connections of the child, and optionally in an area mmap-ed shared between the children...
+
+   static uint32_t micro_cache_size, micro_cache_ttl, micro_cache_max_ttl, micro_cache_shared_size;
+
+   static void  initRequestCache();
+   static void clearRequestCache();
    static int   checkRequestCache();
    static void manageRequestCache();
 #endif
@@ -507,6 +536,12 @@ public:
    static void setSessionCookie(UString* param);
    static bool initSession(const char* location, uint32_t sz);
 
+   // NB: with preforked children the session data is read and written in the store of the session only by these (see server.h)...
+
+   static void sweepSession();
+   static UString getSessionData(const UString& key);
+   static int     putSessionData(const UString& key, const UString& data);
+
    static bool getDataSession(uint32_t index, UString* value);
    static void putDataSession(uint32_t index, const char* val, uint32_t sz);
 
@@ -542,10 +577,13 @@ public:
 
    typedef struct ucgi {
       char        sh_script;
-      char        dir[503];
+      char        pool; // NB: number of runner of the CGI of a mask of CGI_POOL (0 - fork and exec for every request)...
+      char        dir[502];
       const char* interpreter;
    } ucgi;
 
+   static UVector<UString>* vcgi_pool_mask; // NB: CGI_POOL [ mask1 num1 mask2 num2 ... ]
+
    static UString* geoip;
    static UString* fcgi_uri_mask;
    static UString* scgi_uri_mask;
@@ -570,6 +608,10 @@ public:
    static void setCgiResponse(bool header_content_type, bool bcompress, bool connection_close);
    static bool processCGIRequest(UCommand& cmd, UString* environment, const char* cgi_dir, bool& async);
 
+   // FCGI (see mod_fcgi and CGI_POOL)
+
+   static UString getFCGIRequest(UString& environment, uint16_t request_id, bool keep_conn);
+
    // URI PROTECTED
 
    static UString* htpasswd;
@@ -809,6 +851,7 @@ public:
 
    void* ptr;               // data
    UVector<UString>* array; // content, header, gzip(content, header)
+   UString* response[2];    // ready-to-send response (header, content) for identity and gzip, built when the file is cached
    time_t mtime;            // time of last modification
    time_t expire;           // expire time of the entry
    uint32_t size;           // size content
@@ -825,6 +868,8 @@ public:
 
    // STREAM
 
+   void setReadyResponse();
+
    friend U_EXPORT istream& operator>>(istream& is,       UFileCacheData& d);
    friend U_EXPORT ostream& operator<<(ostream& os, const UFileCacheData& d);
 
@@ -845,6 +890,14 @@ public:
    static UFileCacheData* file_data;
    static UHashMap<UFileCacheData*>* cache_file;
 
+   // NB: the content of the document root cache (content, header, gzip(content, header)) loaded by the parent is moved in an area
+   //     mmap-ed shared between the preforked children (read-only after the fork) so it is not duplicated by copy-on-write...
+
+   static char* cache_file_shared;
+   static uint32_t cache_file_shared_size, cache_file_shared_used;
+
+   static void initCacheFileShared();
+
    static bool isDataFromCache()
       {
       U_TRACE(0, "UHTTP::isDataFromCache()")
@@ -882,8 +935,44 @@ public:
    static bool XSendfile(UString& pathname, const UString& ext);
 
 private:
+   typedef struct header_index_entry {
+      uint32_t hash, name, name_len, value; // NB: offset from the start of the request, name_len == 0 -> empty slot...
+   } header_index_entry;
+
+   // NB: the index is built only at the second lookup of the same request, the first one is a scan of the header lines
+   //     (most of the request look up only one header, or none). header_index_num: 0 -> index to build, U_NOT_FOUND -> too
+   //     many header lines (we scan the request)...
+
+   static const char* header_index_ptr; // NB: the start of the header lines of the request (0 -> new request)...
+   static uint32_t header_index_num, header_index_size, header_index_lookup, header_known_hash[HEADER_KNOWN_NUM];
+   static const UString* header_known_name[HEADER_KNOWN_NUM];
+   static header_index_entry header_index[U_HTTP_HEADER_INDEX_SIZE];
+
+   static void setHeaderKnown() U_NO_EXPORT;
+   static void setHeaderIndex(const UString& request) U_NO_EXPORT;
+   static const char* findHeaderValue(const UString& request, const UString& name, bool nocase) __pure U_NO_EXPORT;
+   static const char* getHeaderValuePtr(const UString& request, const UString& name, uint32_t hash, bool nocase) U_NO_EXPORT;
+
    static UString getHTMLDirectoryList() U_NO_EXPORT;
 
+#ifdef U_HTTP_CACHE_REQUEST
+   typedef struct micro_cache_entry {
+      UStringRep* key;
+      UStringRep* response;
+      time_t expire;
+      uint32_t hash;
+   } micro_cache_entry;
+
+   static ULock* micro_cache_lock;
+   static UCache* micro_cache_shared;
+   static micro_cache_entry* micro_cache;
+   static uint32_t micro_cache_key_len, micro_cache_hash; // NB: key of the current request (0 -> not cacheable)...
+   static char micro_cache_key[U_MICRO_CACHE_KEY_SIZE];
+
+   static bool isMicroCacheMaskMatch(UString* mask) __pure U_NO_EXPORT;
+   static void setMicroCacheEntry(micro_cache_entry* e, const UString& key, const UString& response, uint32_t ttl) U_NO_EXPORT;
+#endif
+
 #ifdef DEBUG
    static bool cache_file_check_memory();
    static void check_memory(UStringRep* key, void* value) U_NO_EXPORT;
@@ -894,11 +983,60 @@ private:
    static void updateUploadProgress(int byte_read) U_NO_EXPORT;
 #endif
 
+   // NB: the most common request (HTTP/1.1 GET/HEAD of a small file in cache) is served with the response built when the file is
+   //     cached (shared between the children), before it we write only the status line, Date and Connection (refreshed at most
+   //     once per second)...
+
+   static time_t ready_response_time;
+   static uint32_t ready_response_prefix_len[3];
+   static char ready_response_prefix[3][U_READY_RESPONSE_PREFIX]; // NB: no Connection, 'close', 'Keep-Alive'...
+
+   static bool processReadyResponse() U_NO_EXPORT;
+   static void setReadyResponsePrefix() U_NO_EXPORT;
+
+   static void getSizeForCacheFileShared(UStringRep* key, void* value) U_NO_EXPORT;
+   static void moveDataInCacheFileShared(UStringRep* key, void* value) U_NO_EXPORT;
+
 #if defined(HAVE_SYS_INOTIFY_H) && defined(U_HTTP_INOTIFY_SUPPORT)
+   // NB: with preforked children only one of them read the event of file system (inotify owner), it publish the change in a log
+   //     (circular buffer) in the shared data and the other children replay them on their index before serving a request...
+
+   typedef struct cache_file_event {
+      uint32_t mask, len;
+      char path[U_CACHE_FILE_EVENT_PATH];
+   } cache_file_event;
+
+   typedef struct cache_file_log {
+      uint32_t generation; // NB: number of event published by the inotify owner...
+      cache_file_event event[U_CACHE_FILE_EVENT_MAX];
+   } cache_file_log;
+
+   static cache_file_log* ptr_cache_file_log;
+   static uint32_t cache_file_generation; // NB: number of event of the log already applied by this process...
+
+   static void checkCacheFileLog() U_NO_EXPORT;
+   static void manageInotifyEvent(uint32_t mask) U_NO_EXPORT;
+   static void setExpireForAllEntry(UStringRep* key, void* value) U_NO_EXPORT;
    static void getInotifyPathDirectory(UStringRep* key, void* value) U_NO_EXPORT;
-   static void checkInotifyForCache(int wd, char* name, uint32_t len) U_NO_EXPORT;
+   static bool checkInotifyForCache(int wd, char* name, uint32_t len) U_NO_EXPORT;
 #endif
 
+   // NB: with preforked children every process keep a copy of the session data read from the shard in a private cache (one entry
+   //     for slot of sequence counter), the copy is valid without taking the lock of the shard while the counter is not changed...
+
+   typedef struct session_cache {
+      UStringRep* key;
+      UStringRep* data;
+      uint32_t seq;
+   } session_cache;
+
+   static session_cache* vsession_cache;
+   static uint32_t session_slot;
+
+   static URDB* getSessionShard(const UString& key) U_NO_EXPORT;
+   static void setSessionCache(const UString& key, const UString& data, uint32_t seq) U_NO_EXPORT;
+   static void checkForExpiredSession(UStringRep* key, UStringRep* data) U_NO_EXPORT;
+
    static void checkPath() U_NO_EXPORT;
    static void in_CREATE() U_NO_EXPORT;
    static void in_DELETE() U_NO_EXPORT;
@@ -912,6 +1050,8 @@ private:
    static bool isRequestTooLarge(UString& buffer) U_NO_EXPORT;
    static void setCGIShellScript(UString& command) U_NO_EXPORT;
    static bool runDynamicPage(UString* penvironment) U_NO_EXPORT;
+   static int  connectCGIPool(ucgi* cgi, const UString& command, bool& bspawn) U_NO_EXPORT;
+   static bool processCGIPool(ucgi* cgi, const UString& command, UString* penvironment) U_NO_EXPORT;
    static void removeDataSession(const UString& token) U_NO_EXPORT;
    static void checkIfUSP(UStringRep* key, void* value) U_NO_EXPORT;
    static void checkIfLink(UStringRep* key, void* value) U_NO_EXPORT;
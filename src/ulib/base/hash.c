@@ -470,12 +470,27 @@ uint32_t __pure u_hash(unsigned char* restrict bp, uint32_t len, bool ignore_cas
 
    k1 = 0;
 
-   switch (len & 3)
+   /* NB: with ignore_case also the tail must be lowered... */
+
+   if (ignore_case)
       {
-      case 3: k1 ^= tail[2] << 16;
-      case 2: k1 ^= tail[1] <<  8;
-      case 1: k1 ^= tail[0];
-              k1 *= c1; k1 = rotl32(k1,15); k1 *= c2; h1 ^= k1;
+      switch (len & 3)
+         {
+         case 3: k1 ^= u__tolower(tail[2]) << 16;
+         case 2: k1 ^= u__tolower(tail[1]) <<  8;
+         case 1: k1 ^= u__tolower(tail[0]);
+                 k1 *= c1; k1 = rotl32(k1,15); k1 *= c2; h1 ^= k1;
+         }
+      }
+   else
+      {
+      switch (len & 3)
+         {
+         case 3: k1 ^= tail[2] << 16;
+         case 2: k1 ^= tail[1] <<  8;
+         case 1: k1 ^= tail[0];
+                 k1 *= c1; k1 = rotl32(k1,15); k1 *= c2; h1 ^= k1;
+         }
       }
 
    /* finalization */
@@ -44,6 +44,13 @@
 #  endif
 #endif
 
+/* NB: the SSE2/AVX2 code is compiled with the attribute target, so we don't need -msse2/-mavx2 for all the library... */
+
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) && (defined(__x86_64__) || defined(__i386__))
+#  define U_SIMD_SUPPORT
+#  include <immintrin.h>
+#endif
+
 /* Match */
 
 int        u_pfn_flags;
@@ -52,6 +59,7 @@ bPFpcupcud u_pfn_match = u_dosmatch_with_OR;
 /* Services */
 
 int              u_num_cpu       = -1;
+int              u_simd_level    = -1;
 const char*      u_short_units[] = { "B", "KB", "MB", "GB", "TB", 0 };
 struct uhttpinfo u_http_info;
 
@@ -500,6 +508,164 @@ char* u_getPathRelativ(const char* restrict path, uint32_t* restrict ptr_path_le
    return (char*)path;
 }
 
+/* SIMD scanning of the HTTP request: the instruction set is selected at runtime (cpuid) with fallback to the scalar code */
+
+void u_init_simd(void)
+{
+   U_INTERNAL_TRACE("u_init_simd()")
+
+   u_simd_level = 0;
+
+#ifdef U_SIMD_SUPPORT
+   __builtin_cpu_init(); /* NB: we can be called before the constructors... */
+
+        if (__builtin_cpu_supports("avx2")) u_simd_level = 2;
+   else if (__builtin_cpu_supports("sse2")) u_simd_level = 1;
+#endif
+
+   U_INTERNAL_PRINT("u_simd_level = %d", u_simd_level)
+}
+
+#ifdef U_SIMD_SUPPORT
+/* For every position p we check in parallel the two sequences that end the header: p[-1..2] == U_CRLF2 and p[0..1] == U_LF2 */
+
+__attribute__((target("sse2"))) static const char* u_findEndHeader_sse2(const char* restrict str, const char* restrict end)
+{
+   int mask;
+   __m128i b0, b1, b2, b3, is_lf;
+   const char* restrict p = str + 1;
+   const __m128i cr = _mm_set1_epi8('\r'), lf = _mm_set1_epi8('\n');
+
+   for (; (p + 16 + 2) <= end; p += 16)
+      {
+      b0 = _mm_loadu_si128((const __m128i*)(p - 1));
+      b1 = _mm_loadu_si128((const __m128i*) p);
+      b2 = _mm_loadu_si128((const __m128i*)(p + 1));
+      b3 = _mm_loadu_si128((const __m128i*)(p + 2));
+
+      is_lf = _mm_cmpeq_epi8(b1, lf);
+
+      mask = _mm_movemask_epi8(_mm_or_si128(_mm_and_si128(_mm_and_si128(is_lf, _mm_cmpeq_epi8(b0, cr)),
+                                                          _mm_and_si128(_mm_cmpeq_epi8(b2, cr), _mm_cmpeq_epi8(b3, lf))),
+                                            _mm_and_si128(is_lf, _mm_cmpeq_epi8(b2, lf))));
+
+      if (mask) return p + __builtin_ctz(mask);
+      }
+
+   return p;
+}
+
+__attribute__((target("avx2"))) static const char* u_findEndHeader_avx2(const char* restrict str, const char* restrict end)
+{
+   uint32_t mask;
+   __m256i b0, b1, b2, b3, is_lf;
+   const char* restrict p = str + 1;
+   const __m256i cr = _mm256_set1_epi8('\r'), lf = _mm256_set1_epi8('\n');
+
+   for (; (p + 32 + 2) <= end; p += 32)
+      {
+      b0 = _mm256_loadu_si256((const __m256i*)(p - 1));
+      b1 = _mm256_loadu_si256((const __m256i*) p);
+      b2 = _mm256_loadu_si256((const __m256i*)(p + 1));
+      b3 = _mm256_loadu_si256((const __m256i*)(p + 2));
+
+      is_lf = _mm256_cmpeq_epi8(b1, lf);
+
+      mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(_mm256_and_si256(_mm256_and_si256(is_lf, _mm256_cmpeq_epi8(b0, cr)),
+                                                                              _mm256_and_si256(_mm256_cmpeq_epi8(b2, cr), _mm256_cmpeq_epi8(b3, lf))),
+                                                             _mm256_and_si256(is_lf, _mm256_cmpeq_epi8(b2, lf))));
+
+      if (mask) return p + __builtin_ctz(mask);
+      }
+
+   return p;
+}
+
+/* The char of URI that stop the scanning of the request line: ' ', '?' and the control char (0x00-0x1f, 0x7f-0x9f, see u__iscntrl()) */
+
+__attribute__((target("sse2"))) static const char* u_skipUriChar_sse2(const char* restrict s, const char* restrict end)
+{
+   int mask;
+   __m128i x, y;
+   const __m128i sp   = _mm_set1_epi8(' '),
+                 qm   = _mm_set1_epi8('?'),
+                 del  = _mm_set1_epi8(0x7f),
+                 c1f  = _mm_set1_epi8(0x1f),
+                 c80  = _mm_set1_epi8((char)0x80);
+
+   for (; (s + 16) <= end; s += 16)
+      {
+      x = _mm_loadu_si128((const __m128i*)s);
+      y = _mm_sub_epi8(x, c80);
+
+      mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, sp),                      _mm_cmpeq_epi8(x, qm)),
+                                            _mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(x, c1f), c1f), /* x <= 0x1f */
+                                                         _mm_or_si128(_mm_cmpeq_epi8(x, del),
+                                                                      _mm_cmpeq_epi8(_mm_max_epu8(y, c1f), c1f))))); /* 0x80 <= x <= 0x9f */
+
+      if (mask) return s + __builtin_ctz(mask);
+      }
+
+   return s;
+}
+
+__attribute__((target("avx2"))) static const char* u_skipUriChar_avx2(const char* restrict s, const char* restrict end)
+{
+   uint32_t mask;
+   __m256i x, y;
+   const __m256i sp   = _mm256_set1_epi8(' '),
+                 qm   = _mm256_set1_epi8('?'),
+                 del  = _mm256_set1_epi8(0x7f),
+                 c1f  = _mm256_set1_epi8(0x1f),
+                 c80  = _mm256_set1_epi8((char)0x80);
+
+   for (; (s + 32) <= end; s += 32)
+      {
+      x = _mm256_loadu_si256((const __m256i*)s);
+      y = _mm256_sub_epi8(x, c80);
+
+      mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, sp),                         _mm256_cmpeq_epi8(x, qm)),
+                                                             _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(x, c1f), c1f),
+                                                                             _mm256_or_si256(_mm256_cmpeq_epi8(x, del),
+                                                                                             _mm256_cmpeq_epi8(_mm256_max_epu8(y, c1f), c1f)))));
+
+      if (mask) return s + __builtin_ctz(mask);
+      }
+
+   return s;
+}
+#endif
+
+const char* u_skipUriChar(const char* restrict s, const char* restrict end)
+{
+   U_INTERNAL_TRACE("u_skipUriChar(%p,%p)", s, end)
+
+   U_INTERNAL_ASSERT_POINTER(s)
+
+#ifdef U_SIMD_SUPPORT
+   if (u_simd_level < 0) u_init_simd();
+
+        if (u_simd_level == 2) s = u_skipUriChar_avx2(s, end);
+   else if (u_simd_level == 1) s = u_skipUriChar_sse2(s, end);
+#endif
+
+   while (s < end)
+      {
+      unsigned char c = *(const unsigned char* restrict)s;
+
+      if (c == ' ' ||
+          c == '?' ||
+          u__iscntrl(c))
+         {
+         break;
+         }
+
+      ++s;
+      }
+
+   return s;
+}
+
 /* find sequence of U_LF2 or U_CRLF2 */
 
 uint32_t u_findEndHeader(const char* restrict str, uint32_t n)
@@ -514,6 +680,19 @@ uint32_t u_findEndHeader(const char* restrict str, uint32_t n)
 
    U_INTERNAL_ASSERT_POINTER(str)
 
+#ifdef U_SIMD_SUPPORT
+   /* NB: the vector code return the first newline of the sequence (or where to continue), the check below is the same... */
+
+   if (n >= 64 &&
+       str[0] != '\n') /* NB: the vector code load also the char before the newline... */
+      {
+      if (u_simd_level < 0) u_init_simd();
+
+           if (u_simd_level == 2) ptr = u_findEndHeader_avx2(str, end);
+      else if (u_simd_level == 1) ptr = u_findEndHeader_sse2(str, end);
+      }
+#endif
+
    while (ptr < end)
       {
       p = (const char* restrict) memchr(ptr, '\n', end - ptr);
@@ -161,7 +161,8 @@ const char* UEventTime::dump(bool _reset) const
    *UObjectIO::os << '\n'
                   << "ctime   " << "{ " << ctime.tv_sec
                                 << " "  << ctime.tv_usec
-                                << " }";
+                                << " }"                      << '\n'
+                  << "ptimer  (UTimer " << (void*)ptimer << ')';
 
    if (_reset)
       {
@@ -25,6 +25,10 @@
 char*    UFile::cwd_save;
 char*    UFile::pfree;
 uint32_t UFile::nfree;
+int      UFile::huge_page;
+uint32_t UFile::nr_huge_page;
+uint32_t UFile::nr_huge_page_fallback;
+uint64_t UFile::size_huge_page_advise;
 uint32_t UFile::cwd_save_len;
 #ifdef DEBUG
 int      UFile::num_file_object;
@@ -401,7 +405,16 @@ char* UFile::mmap(uint32_t* plength, int _fd, int prot, int flags, uint32_t offs
 
    U_INTERNAL_ASSERT_EQUALS(*plength & U_PAGEMASK, 0)
 
-   if ((flags & MAP_SHARED) != 0) return (char*) U_SYSCALL(mmap, "%d,%u,%d,%d,%d,%u", 0, *plength, prot, flags, -1, 0);
+   if ((flags & MAP_SHARED) != 0)
+      {
+      if (huge_page &&
+          *plength >= U_HUGE_PAGE_SIZE)
+         {
+         return mmapHugePage(plength, prot, flags);
+         }
+
+      return (char*) U_SYSCALL(mmap, "%d,%u,%d,%d,%d,%u", 0, *plength, prot, flags, -1, 0);
+      }
 
    char* _ptr;
    bool _abort = false;
@@ -454,6 +467,10 @@ try_from_file_system:
 #if defined(__linux__) && defined(ENABLE_THREAD)
    U_INTERNAL_DUMP("plength = %u nfree = %u pfree = %p", *plength, nfree, pfree)
 
+#  ifdef HAVE_PTHREAD_H
+   UMemoryPool::lock(); // NB: the area can be shared by more thread...
+#  endif
+
    if (pfree == 0)
       {
 #  ifdef DEBUG
@@ -476,10 +493,18 @@ try_from_file_system:
          nfree = 0;
          pfree = 0;
          }
+      else if (huge_page)
+         {
+         adviseHugePage(pfree, nfree);
+         }
       }
 
    if (*plength > nfree)
       {
+#  ifdef HAVE_PTHREAD_H
+      UMemoryPool::unlock();
+#  endif
+
 #  ifdef DEBUG
       U_WARNING("we are going to allocate %u bytes (%u KB) (pid %P) - nfree = %u", *plength, *plength / 1024, nfree);
 #  endif
@@ -492,6 +517,10 @@ try_from_file_system:
 
          goto try_from_file_system;
          }
+
+      if (huge_page) adviseHugePage(_ptr, *plength);
+
+      return _ptr; // NB: we don't take it from the area...
       }
 
    _ptr   = pfree;
@@ -505,6 +534,10 @@ try_from_file_system:
       }
 
    U_INTERNAL_DUMP("plength = %u nfree = %u pfree = %p", *plength, nfree, pfree)
+
+#  ifdef HAVE_PTHREAD_H
+   UMemoryPool::unlock();
+#  endif
 #else
 #  ifdef DEBUG
    U_WARNING("we are going to malloc %u bytes (%u KB) (pid %P)", *plength, *plength / 1024);
@@ -516,6 +549,125 @@ try_from_file_system:
    return _ptr;
 }
 
+U_NO_EXPORT void UFile::adviseHugePage(char* ptr, uint32_t length)
+{
+   U_TRACE(1, "UFile::adviseHugePage(%p,%u)", ptr, length)
+
+   U_INTERNAL_ASSERT_MAJOR(huge_page, 0)
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+   // NB: only the part of the area aligned to the size of the huge page can be backed by huge page...
+
+   char* start = (char*)(((long)ptr + U_HUGE_PAGE_MASK) & ~(long)U_HUGE_PAGE_MASK);
+   char* end   = (char*)(((long)ptr + length)           & ~(long)U_HUGE_PAGE_MASK);
+
+   if (end > start &&
+       U_SYSCALL(madvise, "%p,%lu,%d", start, end - start, MADV_HUGEPAGE) == 0)
+      {
+      size_huge_page_advise += (end - start);
+      }
+#endif
+}
+
+U_NO_EXPORT char* UFile::mmapHugePage(uint32_t* plength, int prot, int flags)
+{
+   U_TRACE(1, "UFile::mmapHugePage(%p,%d,%d)", plength, prot, flags)
+
+   U_INTERNAL_ASSERT_MAJOR(huge_page, 0)
+
+   char* _ptr;
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+   if (huge_page == 2)
+      {
+      uint32_t length = (*plength + U_HUGE_PAGE_MASK) & ~U_HUGE_PAGE_MASK;
+
+      _ptr = (char*) U_SYSCALL(mmap, "%d,%u,%d,%d,%d,%u", 0, length, prot, flags | MAP_HUGETLB, -1, 0);
+
+      if (_ptr != (char*)MAP_FAILED)
+         {
+         *plength = length; // NB: the caller must unmap all the area...
+
+         nr_huge_page += length / U_HUGE_PAGE_SIZE;
+
+         U_RETURN(_ptr);
+         }
+
+      ++nr_huge_page_fallback; // NB: there are not enough huge page reserved (see /proc/sys/vm/nr_hugepages)...
+      }
+#endif
+
+   _ptr = (char*) U_SYSCALL(mmap, "%d,%u,%d,%d,%d,%u", 0, *plength, prot, flags, -1, 0);
+
+   if (_ptr != (char*)MAP_FAILED) adviseHugePage(_ptr, *plength);
+
+   U_RETURN(_ptr);
+}
+
+void UFile::setHugePage(int mode)
+{
+   U_TRACE(0, "UFile::setHugePage(%d)", mode)
+
+   U_INTERNAL_ASSERT_RANGE(0, mode, 2)
+
+   huge_page = mode;
+
+#if defined(__linux__) && defined(ENABLE_THREAD)
+   // NB: the area for the allocation can be already mapped...
+
+   if (huge_page &&
+       pfree)
+      {
+#  ifdef HAVE_PTHREAD_H
+      UMemoryPool::lock();
+#  endif
+
+      adviseHugePage(pfree, nfree);
+
+#  ifdef HAVE_PTHREAD_H
+      UMemoryPool::unlock();
+#  endif
+      }
+#endif
+}
+
+uint32_t UFile::writeHugePageInfo(char* buffer, uint32_t buffer_size)
+{
+   U_TRACE(1, "UFile::writeHugePageInfo(%p,%u)", buffer, buffer_size)
+
+   // NB: the transparent huge page really obtained are given by the kernel (AnonHugePages)...
+
+   uint32_t anon_huge_page = 0;
+
+#ifdef __linux__
+   int _fd = U_SYSCALL(open, "%S,%d", "/proc/self/smaps_rollup", O_RDONLY);
+
+   if (_fd != -1)
+      {
+      char content[4096];
+
+      ssize_t n = U_SYSCALL(read, "%d,%p,%u", _fd, content, sizeof(content)-1);
+
+      if (n > 0)
+         {
+         content[n] = '\0';
+
+         const char* ptr = strstr(content, "AnonHugePages:");
+
+         if (ptr) anon_huge_page = strtoul(ptr + U_CONSTANT_SIZE("AnonHugePages:"), 0, 10);
+         }
+
+      (void) U_SYSCALL(close, "%d", _fd);
+      }
+#endif
+
+   uint32_t n = u__snprintf(buffer, buffer_size, "huge page: mode %s, %u page(s) of %u KB with MAP_HUGETLB (%u fallback), %llu KB advised, %u KB of transparent huge page",
+                            (huge_page == 2 ? "hugetlb" : huge_page == 1 ? "transparent" : "disabled"),
+                            nr_huge_page, U_HUGE_PAGE_SIZE / 1024, nr_huge_page_fallback, size_huge_page_advise / 1024, anon_huge_page);
+
+   U_RETURN(n);
+}
+
 bool UFile::memmap(int prot, UString* str, uint32_t offset, uint32_t length)
 {
    U_TRACE(0, "UFile::memmap(%d,%p,%u,%u)", prot, str, offset, length)
@@ -39,6 +39,47 @@ const char*  UMemoryPool::func_call;
 sig_atomic_t UMemoryPool::index_stack_busy = -1;
 #endif
 
+#if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+static pthread_mutex_t depot_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void UMemoryPool::lock()
+{
+   U_TRACE(0, "UMemoryPool::lock()")
+
+   (void) pthread_mutex_lock(&depot_lock);
+}
+
+void UMemoryPool::unlock()
+{
+   U_TRACE(0, "UMemoryPool::unlock()")
+
+   (void) pthread_mutex_unlock(&depot_lock);
+}
+#endif
+
+#ifdef U_MEMORY_POOL_THREAD_CACHE
+// magazine of blocks of the thread for each 'type' stack...
+
+typedef struct umagazine {
+   uint32_t len, num_alloc, num_free;
+   void* block[U_MAGAZINE_SIZE];
+} umagazine;
+
+// NB: with the model initial-exec the access don't need a call to __tls_get_addr() (libulib is never loaded with dlopen())...
+
+static __thread umagazine magazine[U_NUM_STACK_TYPE] __attribute__((tls_model("initial-exec"))); // 10
+
+// NB: the counters of the magazine are added to the global statistics with the lock of the depot...
+
+static void u_add_magazine_stat(umagazine* pmag, umemorypoolstat* pstat)
+{
+   pstat->num_alloc += pmag->num_alloc;
+   pstat->num_free  += pmag->num_free;
+
+   pmag->num_alloc = pmag->num_free = 0;
+}
+#endif
+
 /*
 uint32_t UMemoryPool::stackIndexToSize(uint32_t sz)
 {
@@ -250,6 +291,8 @@ public:
          pointer_block = (void**) UFile::mmap(&size, -1, PROT_READ | PROT_WRITE, U_MAP_ANON, 0);
          len = space   = (size / type);
 
+         UMemoryPool::pool_stat[0].size += size;
+
 #     if defined(DEBUG)
          UMemoryPool::index_stack_busy = -1;
 
@@ -264,6 +307,8 @@ public:
 
          uint32_t new_len = len + num_entry;
 
+         UMemoryPool::pool_stat[index].size += num_entry * type;
+
          U_INTERNAL_DUMP("num_entry = %u new_len = %u", num_entry, new_len)
 
          char* eblock = pblock + (num_entry * type);
@@ -308,7 +353,16 @@ public:
       U_INTERNAL_ASSERT_MINOR(index, U_NUM_STACK_TYPE) // 10
       U_INTERNAL_ASSERT_DIFFERS(index, (uint32_t)UMemoryPool::index_stack_busy)
 
-      if (len == 0) allocateMemoryBlocks(space);
+      umemorypoolstat* pstat = UMemoryPool::pool_stat+index;
+
+      if (len == 0)
+         {
+         ++pstat->num_miss;
+
+         allocateMemoryBlocks(space);
+         }
+
+      if (++pstat->in_use > pstat->max_in_use) pstat->max_in_use = pstat->in_use;
 
 #  ifdef DEBUG
       UMemoryPool::index_stack_busy = index;
@@ -359,6 +413,8 @@ public:
 
       pointer_block[len++] = (void*)ptr;
 
+      UMemoryPool::pool_stat[index].in_use--;
+
 #  if defined(DEBUG)
       UMemoryPool::index_stack_busy = -1;
 
@@ -438,7 +494,15 @@ void UMemoryPool::addMemoryBlocks(int stack_index, uint32_t n)
                         pstack->pop_cnt, pstack->push_cnt,
                         pstack->num_call_allocateMemoryBlocks);
 
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   lock();
+#  endif
+
    pstack->allocateMemoryBlocks(pstack->len + n);
+
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   unlock();
+#  endif
 #endif
 }
 
@@ -458,7 +522,15 @@ void UMemoryPool::allocateMemoryBlocks(int stack_index, uint32_t n)
                         pstack->pop_cnt, pstack->push_cnt,
                         pstack->num_call_allocateMemoryBlocks);
 
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   lock();
+#  endif
+
    if (n > pstack->len) pstack->allocateMemoryBlocks(n);
+
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   unlock();
+#  endif
 #endif
 }
 
@@ -470,9 +542,48 @@ void UMemoryPool::push(void* ptr, int stack_index)
 
 #if !defined(ENABLE_MEMPOOL) || !defined(__linux__)
    U_SYSCALL_VOID(free, "%p", ptr);
+#elif defined(U_MEMORY_POOL_THREAD_CACHE)
+   umagazine* pmag = magazine+stack_index;
+
+   pmag->num_free++;
+
+   if (stack_index)
+      {
+      U_INTERNAL_DUMP("magazine[%d].len = %u", stack_index, pmag->len)
+
+      if (pmag->len == U_MAGAZINE_SIZE)
+         {
+         // NB: the magazine is full, we give back half of it to the depot...
+
+         UStackMemoryPool* pstack = (UStackMemoryPool*)(UStackMemoryPool::mem_stack+stack_index);
+
+         lock();
+
+         u_add_magazine_stat(pmag, pool_stat+stack_index);
+
+         do {
+            void* _ptr = pmag->block[--pmag->len];
+
+            U_ASSERT(check(_ptr))
+
+            pstack->push(_ptr);
+            }
+         while (pmag->len > (U_MAGAZINE_SIZE / 2));
+
+         unlock();
+         }
+
+#  ifdef DEBUG
+      (void) U_SYSCALL(memset, "%p,%d,%u", ptr, 0, U_STACK_INDEX_TO_SIZE(stack_index)); // NB: in debug mode the memory area is zeroed to enhance showing bugs...
+#  endif
+
+      pmag->block[pmag->len++] = ptr;
+      }
 #else
    U_ASSERT(check(ptr))
 
+   pool_stat[stack_index].num_free++;
+
    if (stack_index) ((UStackMemoryPool*)(UStackMemoryPool::mem_stack+stack_index))->push(ptr);
 #endif
 }
@@ -488,6 +599,22 @@ void* UMemoryPool::pop(int stack_index)
 #else
    UStackMemoryPool* pstack = (UStackMemoryPool*)(UStackMemoryPool::mem_stack+stack_index);
 
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   umagazine* pmag = magazine+stack_index;
+
+   U_INTERNAL_DUMP("magazine[%d].len = %u", stack_index, pmag->len)
+
+   pmag->num_alloc++;
+
+   if (pmag->len == 0)
+      {
+      // NB: the magazine is empty, we refill half of it from the depot...
+
+      lock();
+
+      u_add_magazine_stat(pmag, pool_stat+stack_index);
+#  endif
+
 #  ifdef DEBUG
    if (pstack->index &&
        pstack->len == 0)
@@ -499,9 +626,27 @@ void* UMemoryPool::pop(int stack_index)
       }
 #  endif
 
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+      do {
+         void* _ptr = pstack->pop();
+
+         U_ASSERT(check(_ptr))
+
+         pmag->block[pmag->len++] = _ptr;
+         }
+      while (pmag->len < (U_MAGAZINE_SIZE / 2));
+
+      unlock();
+      }
+
+   void* ptr = pmag->block[--pmag->len];
+#  else
    void* ptr = pstack->pop();
 
+   pool_stat[stack_index].num_alloc++;
+
    U_ASSERT(check(ptr))
+#  endif
 #endif
 
    U_RETURN(ptr);
@@ -586,6 +731,10 @@ void UMemoryPool::deallocate(void* ptr, uint32_t length)
    U_TRACE(1, "UMemoryPool::deallocate(%p,%u)", ptr, length)
 
 #if defined(ENABLE_MEMPOOL) && defined(__linux__) && defined(ENABLE_THREAD)
+#  ifdef HAVE_PTHREAD_H
+   lock();
+#  endif
+
    if (UFile::isLastAllocation(ptr, length))
       {
       UFile::pfree  = (char*)ptr;
@@ -610,11 +759,42 @@ void UMemoryPool::deallocate(void* ptr, uint32_t length)
       (void) U_SYSCALL(munmap, "%p,%lu", (void*)ptr, length);
 #  endif
       }
+
+#  ifdef HAVE_PTHREAD_H
+   unlock();
+#  endif
 #else
    U_SYSCALL_VOID(free, "%p", ptr);
 #endif
 }
 
+void UMemoryPool::flushThreadCache()
+{
+   U_TRACE(0, "UMemoryPool::flushThreadCache()")
+
+#ifdef U_MEMORY_POOL_THREAD_CACHE
+   lock();
+
+   u_add_magazine_stat(magazine, pool_stat);
+
+   // NB: the blocks of the stack 0 are never given back (see push())...
+
+   for (int stack_index = 1; stack_index < U_NUM_STACK_TYPE; ++stack_index)
+      {
+      umagazine*        pmag   = magazine+stack_index;
+      UStackMemoryPool* pstack = (UStackMemoryPool*)(UStackMemoryPool::mem_stack+stack_index);
+
+      U_INTERNAL_DUMP("magazine[%d].len = %u", stack_index, pmag->len)
+
+      u_add_magazine_stat(pmag, pool_stat+stack_index);
+
+      while (pmag->len) pstack->push(pmag->block[--pmag->len]);
+      }
+
+   unlock();
+#endif
+}
+
 void UMemoryPool::_free(void* ptr, uint32_t num, uint32_t type_size)
 {
    U_TRACE(1, "UMemoryPool::_free(%p,%u,%u)", ptr, num, type_size)
@@ -638,6 +818,254 @@ void UMemoryPool::_free(void* ptr, uint32_t num, uint32_t type_size)
 #endif
 }
 
+uint32_t UMemoryPool::writeInfo(char* buffer, uint32_t buffer_size)
+{
+   U_TRACE(0, "UMemoryPool::writeInfo(%p,%u)", buffer, buffer_size)
+
+   uint32_t n = 0;
+
+#if !defined(ENABLE_MEMPOOL) || !defined(__linux__)
+   n = u__snprintf(buffer, buffer_size, "memory pool: not enabled\n", 0);
+#else
+   uint64_t held = 0;
+   umemorypoolstat* pstat;
+
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   lock();
+#  endif
+
+   for (int stack_index = 0; stack_index < U_NUM_STACK_TYPE; ++stack_index)
+      {
+      pstat = pool_stat+stack_index;
+
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+      u_add_magazine_stat(magazine+stack_index, pstat);
+#  endif
+
+      held += pstat->size;
+
+      n += u__snprintf(buffer + n, buffer_size - n,
+                       "memory pool stack[%u]: type %4u alloc %10llu free %10llu miss %5u in use %7u max %7u held %7u KB\n",
+                       stack_index, U_STACK_INDEX_TO_SIZE(stack_index), pstat->num_alloc, pstat->num_free,
+                       pstat->num_miss, pstat->in_use, pstat->max_in_use, pstat->size / 1024);
+      }
+
+#  ifdef U_MEMORY_POOL_THREAD_CACHE
+   unlock();
+#  endif
+
+   n += u__snprintf(buffer + n, buffer_size - n, "memory pool: %llu KB held by the stacks\n", held / 1024);
+#endif
+
+   U_RETURN(n);
+}
+
+// request-scoped arena
+
+char*        UMemoryArena::base;
+char*        UMemoryArena::limit;
+char*        UMemoryArena::next_chunk;
+#ifdef ENABLE_THREAD
+__thread bool UMemoryArena::active __attribute__((tls_model("initial-exec")));
+#else
+bool         UMemoryArena::active;
+#endif
+bool         UMemoryArena::bclear;
+uint32_t     UMemoryArena::num_live;
+uint64_t     UMemoryArena::total_size;
+uint32_t     UMemoryArena::num_request;
+uint32_t     UMemoryArena::max_size;
+uint32_t     UMemoryArena::request_size;
+uint32_t     UMemoryArena::num_fallback;
+uint32_t     UMemoryArena::num_pinned;
+uarenachunk* UMemoryArena::current;
+uarenachunk* UMemoryArena::free_chunk;
+
+bool UMemoryArena::init(uint32_t sz)
+{
+   U_TRACE(1, "UMemoryArena::init(%u)", sz)
+
+   U_INTERNAL_ASSERT_EQUALS(base, 0)
+
+   sz = (sz + (U_ARENA_CHUNK_SIZE - 1)) & ~(U_ARENA_CHUNK_SIZE - 1);
+
+   if (sz == 0) U_RETURN(false);
+
+   // NB: we reserve one chunk more to align the area to the size of the chunk (the pages are really allocated only when used)...
+
+   char* ptr = (char*) U_SYSCALL(mmap, "%d,%u,%d,%d,%d,%u", 0, sz + U_ARENA_CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+   if (ptr == (char*)MAP_FAILED) U_RETURN(false);
+
+   base       =
+   next_chunk = (char*)(((long)ptr + (U_ARENA_CHUNK_SIZE - 1)) & ~(long)(U_ARENA_CHUNK_SIZE - 1));
+   limit      = base + sz;
+
+   U_INTERNAL_DUMP("base = %p limit = %p", base, limit)
+
+   U_RETURN(true);
+}
+
+void UMemoryArena::clear()
+{
+   U_TRACE(1, "UMemoryArena::clear()")
+
+   if (base)
+      {
+      U_INTERNAL_DUMP("num_request = %u max_size = %u num_fallback = %u num_pinned = %u num_live = %u", num_request, max_size, num_fallback, num_pinned, num_live)
+
+      active = false;
+      bclear = true;
+
+      // NB: if some string allocated on the arena is still alive (cache, session, ...) we keep the range [base,limit), otherwise
+      //     isArena() is false for it and its release go to the pool. The area is unmapped with the release of the last one...
+
+      if (num_live) return;
+
+      // NB: we don't know the real start of the mapping (see init()), so we unmap only the aligned part...
+
+      (void) U_SYSCALL(munmap, "%p,%lu", base, limit - base);
+
+      base = limit = next_chunk = 0;
+      current = free_chunk = 0;
+      bclear = false;
+      }
+}
+
+U_NO_EXPORT bool UMemoryArena::newChunk()
+{
+   U_TRACE(0, "UMemoryArena::newChunk()")
+
+   U_INTERNAL_DUMP("current = %p free_chunk = %p next_chunk = %p", current, free_chunk, next_chunk)
+
+   uarenachunk* chunk;
+
+   if (free_chunk)
+      {
+      chunk      = free_chunk;
+      free_chunk = free_chunk->next;
+      }
+   else if (next_chunk < limit)
+      {
+      chunk       = (uarenachunk*)next_chunk;
+      next_chunk += U_ARENA_CHUNK_SIZE;
+      }
+   else
+      {
+      U_RETURN(false);
+      }
+
+   // NB: the current chunk is full but some string on it is still alive, it go back to the free list with the death of the last one...
+
+   if (current) ++num_pinned;
+
+   chunk->next = 0;
+   chunk->live = 0;
+   chunk->used = sizeof(uarenachunk);
+
+   current = chunk;
+
+   U_RETURN(true);
+}
+
+void* UMemoryArena::allocate(uint32_t sz)
+{
+   U_TRACE(0, "UMemoryArena::allocate(%u)", sz)
+
+   U_INTERNAL_ASSERT(active)
+   U_INTERNAL_ASSERT_POINTER(base)
+
+   sz = (sz + (sizeof(long) - 1)) & ~(sizeof(long) - 1); // memory aligned
+
+   U_INTERNAL_ASSERT(sz <= (U_ARENA_CHUNK_SIZE - sizeof(uarenachunk)))
+
+   if ((current == 0                               ||
+        (current->used + sz) > U_ARENA_CHUNK_SIZE) &&
+       newChunk() == false)
+      {
+      ++num_fallback;
+
+      U_RETURN((void*)0);
+      }
+
+   char* ptr = (char*)current + current->used;
+
+   current->used += sz;
+   current->live++;
+
+   ++num_live;
+
+   request_size += sz;
+
+   U_INTERNAL_DUMP("current = %p live = %u used = %u", current, current->live, current->used)
+
+   U_RETURN(ptr);
+}
+
+void UMemoryArena::release(void* ptr)
+{
+   U_TRACE(0, "UMemoryArena::release(%p)", ptr)
+
+   U_INTERNAL_ASSERT(isArena(ptr))
+
+   uarenachunk* chunk = (uarenachunk*)(base + (((char*)ptr - base) & ~(long)(U_ARENA_CHUNK_SIZE - 1)));
+
+   U_INTERNAL_DUMP("chunk = %p live = %u used = %u", chunk, chunk->live, chunk->used)
+
+   U_INTERNAL_ASSERT_MAJOR(chunk->live, 0)
+   U_INTERNAL_ASSERT_MAJOR(num_live, 0)
+
+   if (--num_live == 0 &&
+       bclear)
+      {
+      clear(); // NB: the last string of the arena is dead, we can unmap the area...
+
+      return;
+      }
+
+   if (--chunk->live == 0)
+      {
+      if (chunk == current) chunk->used = sizeof(uarenachunk); // NB: rewind in one shot...
+      else
+         {
+         U_INTERNAL_ASSERT_MAJOR(num_pinned, 0)
+
+         --num_pinned;
+
+         chunk->next = free_chunk;
+         free_chunk  = chunk;
+         }
+      }
+}
+
+void UMemoryArena::end()
+{
+   U_TRACE(0, "UMemoryArena::end()")
+
+   U_INTERNAL_ASSERT(active)
+
+   active = false;
+
+   ++num_request;
+
+   total_size += request_size;
+
+   if (request_size > max_size) max_size = request_size;
+
+   U_INTERNAL_DUMP("request_size = %u max_size = %u num_request = %u", request_size, max_size, num_request)
+}
+
+uint32_t UMemoryArena::writeInfo(char* buffer, uint32_t buffer_size)
+{
+   U_TRACE(0, "UMemoryArena::writeInfo(%p,%u)", buffer, buffer_size)
+
+   uint32_t n = u__snprintf(buffer, buffer_size, "request arena: %u KB reserved, %u KB used, %u request(s), average %u bytes, max %u bytes, %u fallback, %u pinned chunk(s)",
+                            (uint32_t)((limit - base) / 1024), (uint32_t)((next_chunk - base) / 1024), num_request,
+                            (num_request ? (uint32_t)(total_size / num_request) : 0), max_size, num_fallback, num_pinned);
+
+   U_RETURN(n);
+}
+
 #ifdef DEBUG
 void UStackMemoryPool::paint(ostream& os) // paint info
 {
@@ -761,6 +1189,21 @@ void UMemoryPool::writeInfoTo(const char* format, ...)
 }
 #endif
 
+// NB: the blocks of mem_block are counted as held by the stacks from the start...
+
+umemorypoolstat UMemoryPool::pool_stat[U_NUM_STACK_TYPE] = { // 10
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_0 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_1 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_2 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_3 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_4 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_5 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_6 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_7 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_8 * U_NUM_ENTRY_MEM_BLOCK },
+   { 0, 0, 0, 0, 0, U_STACK_TYPE_9 * U_NUM_ENTRY_MEM_BLOCK }
+};
+
 #if defined(ENABLE_MEMPOOL) && defined(__linux__)
 char UStackMemoryPool::mem_block[U_SIZE_MEM_BLOCK];
 // ----------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 bool        UClientImage_Base::bIPv6;
 bool        UClientImage_Base::pipeline;
 bool        UClientImage_Base::write_off;
+bool        UClientImage_Base::bcork;
 uint32_t    UClientImage_Base::rstart;
 uint32_t    UClientImage_Base::counter;
 uint32_t    UClientImage_Base::size_request;
@@ -26,9 +27,13 @@ UString*    UClientImage_Base::rbuffer;
 UString*    UClientImage_Base::wbuffer;
 UString*    UClientImage_Base::request; // NB: it is only a pointer, not a string object...
 UString*    UClientImage_Base::pbuffer;
+UString*    UClientImage_Base::qbuffer;
 UString*    UClientImage_Base::environment;
 UString*    UClientImage_Base::msg_welcome;
 
+UClientImage_Base* UClientImage_Base::first_idle;
+UClientImage_Base* UClientImage_Base::last_idle;
+
 #ifdef USE_LIBSSL
 SSL_CTX* UClientImage_Base::ctx;
 #endif
@@ -126,10 +131,20 @@ UClientImage_Base::UClientImage_Base()
    socket     = 0;
    logbuf     = (UServer_Base::isLog() ? U_NEW(UString(200U)) : 0);
    last_event = u_now->tv_sec;
+   prev_idle  = next_idle = 0;
+
+   start = count = nrequest = 0;
 
-   start = count = 0;
+   request_start = 0;
+   request_in    = request_out = request_code = 0;
    state = sfd = bclose = 0;
 
+   range_part = 0;
+   vrange     = 0;
+   range_num  = range_index = range_pos = 0;
+
+   disk_io_gen = 0;
+
    U_INTERNAL_DUMP("socket = %p", socket)
 
    U_INTERNAL_ASSERT_EQUALS(socket, 0)
@@ -147,6 +162,9 @@ UClientImage_Base::~UClientImage_Base()
 
    delete socket;
 
+   if (vrange)     resetRange();
+   if (range_part) delete range_part;
+
    if (logbuf)
       {
 #  ifndef ENABLE_NEW_VECTOR
@@ -267,6 +285,7 @@ void UClientImage_Base::init()
    U_INTERNAL_ASSERT_EQUALS(rbuffer,0)
    U_INTERNAL_ASSERT_EQUALS(wbuffer,0)
    U_INTERNAL_ASSERT_EQUALS(pbuffer,0)
+   U_INTERNAL_ASSERT_EQUALS(qbuffer,0)
    U_INTERNAL_ASSERT_EQUALS(_buffer,0)
    U_INTERNAL_ASSERT_EQUALS(_encoded,0)
 
@@ -274,6 +293,7 @@ void UClientImage_Base::init()
    rbuffer     = U_NEW(UString(U_CAPACITY));
    wbuffer     = U_NEW(UString);
    pbuffer     = U_NEW(UString);
+   qbuffer     = U_NEW(UString(U_CAPACITY));
    environment = U_NEW(UString(U_CAPACITY));
 
    // NB: these are for ULib Servlet Page (USP) - USP_PRINTF...
@@ -299,6 +319,7 @@ void UClientImage_Base::clear()
       delete body;
       delete wbuffer;
       delete pbuffer;
+      delete qbuffer;
       delete rbuffer;
       delete environment;
 
@@ -476,7 +497,9 @@ bool UClientImage_Base::newConnection()
 
    U_INTERNAL_DUMP("fd = %d sock_fd = %d", UEventFd::fd, socket->iSockDesc)
 
-   UEventFd::fd = socket->iSockDesc;
+   UEventFd::fd  = socket->iSockDesc;
+   nrequest      = 0;
+   request_start = 0;
 
    if (logbuf)
       {
@@ -513,10 +536,14 @@ bool UClientImage_Base::newConnection()
          }
 
       // NB: we don't need to call U_gettimeofday because we have log enabled...
-
-      last_event = u_now->tv_sec;
+      }
+   else
+      {
+      U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
       }
 
+   setLastEvent();
+
    U_RETURN(true);
 }
 
@@ -536,16 +563,73 @@ int UClientImage_Base::handlerResponse()
       logResponse();
       }
 
-   uint32_t sz1    = wbuffer->size(),
+   uint32_t sz0    = qbuffer->size(),
+            sz1    = wbuffer->size(),
             sz2    =    body->size(),
-            ncount = sz1;
-   const char* ptr = wbuffer->data();
+            ncount = sz1 + sz2;
+
+   U_INTERNAL_DUMP("pipeline = %b rstart = %u size_request = %u rbuffer->size() = %u sz0 = %u", pipeline, rstart, size_request, rbuffer->size(), sz0)
+
+   if (pipeline &&
+       (rstart + size_request) < rbuffer->size())
+      {
+      // NB: we have other request available in pipeline, we queue the response...
+
+      if ((sz0 + ncount) <= U_MAX_SIZE_RESPONSE_QUEUE)
+         {
+                   (void) qbuffer->append(*wbuffer);
+         if (sz2)  (void) qbuffer->append(*body);
+
+         if ((bclose & U_CLOSE) != 0)
+            {
+            U_INTERNAL_ASSERT_MAJOR(sfd, 0)
+
+            UFile::close(sfd);
+            }
+
+         U_RETURN(U_NOTIFIER_OK);
+         }
+
+#  if defined(LINUX) || defined(__LINUX__) || defined(__linux__)
+      if (bcork == false)
+         {
+         bcork = true;
+
+         socket->setTcpCork(1U); // NB: the queue is full, we write it but we avoid to send partial frames until the end of the pipeline...
+         }
+#  endif
+      }
+
+   int iovcnt = 0;
+   struct iovec _iov[3];
+
+   if (sz0)
+      {
+      ncount += sz0;
+
+      _iov[iovcnt].iov_base = (caddr_t)qbuffer->data();
+      _iov[iovcnt].iov_len  = sz0;
 
-   struct iovec _iov[2] = { { (caddr_t)ptr,          sz1 },
-                            { (caddr_t)body->data(), sz2 } };
+      ++iovcnt;
+      }
 
-   int iBytesWrite = (sz2 ? (ncount += sz2, USocketExt::writev(socket, _iov, 2, ncount, UServer_Base::timeoutMS))
-                          :                 USocketExt::write( socket,        ptr, sz1, UServer_Base::timeoutMS));
+   _iov[iovcnt].iov_base = (caddr_t)wbuffer->data();
+   _iov[iovcnt].iov_len  = sz1;
+
+   ++iovcnt;
+
+   if (sz2)
+      {
+      _iov[iovcnt].iov_base = (caddr_t)body->data();
+      _iov[iovcnt].iov_len  = sz2;
+
+      ++iovcnt;
+      }
+
+   int iBytesWrite = (iovcnt > 1 ? USocketExt::writev(socket, _iov, iovcnt, ncount, UServer_Base::timeoutMS)
+                                 : USocketExt::write( socket, wbuffer->data(), sz1, UServer_Base::timeoutMS));
+
+   if (sz0) qbuffer->setEmpty();
 
    if (iBytesWrite == (int)ncount)
       {
@@ -559,7 +643,20 @@ int UClientImage_Base::handlerResponse()
       U_RETURN(U_NOTIFIER_OK);
       }
 
-   U_INTERNAL_ASSERT_EQUALS(_iov[0].iov_len + _iov[1].iov_len, ncount - iBytesWrite)
+   if (iovcnt == 1 &&
+       iBytesWrite > 0)
+      {
+      _iov[0].iov_len  -= iBytesWrite;
+      _iov[0].iov_base  = (char*)_iov[0].iov_base + iBytesWrite;
+      }
+
+#ifdef DEBUG
+   uint32_t sum = 0;
+
+   for (int i = 0; i < iovcnt; ++i) sum += _iov[i].iov_len;
+
+   U_INTERNAL_ASSERT_EQUALS(sum, ncount - iBytesWrite)
+#endif
 
 #ifndef U_CLIENT_RESPONSE_PARTIAL_WRITE_SUPPORT
    if (socket->isOpen() &&
@@ -611,7 +708,7 @@ int UClientImage_Base::handlerResponse()
          if (sfd != -1)
             {
             if (UFile::_unlink(path) &&
-                (ncount -= iBytesWrite, UFile::writev(sfd, _iov, 2) == (int)ncount))
+                (ncount -= iBytesWrite, UFile::writev(sfd, _iov, iovcnt) == (int)ncount))
                {
                if (UServer_Base::isLog())
                   {
@@ -658,6 +755,56 @@ partial:
 #endif
 }
 
+// manage idle connection
+
+void UClientImage_Base::eraseIdle()
+{
+   U_TRACE(0, "UClientImage_Base::eraseIdle()")
+
+   U_INTERNAL_DUMP("prev_idle = %p next_idle = %p first_idle = %p last_idle = %p", prev_idle, next_idle, first_idle, last_idle)
+
+   if (prev_idle) prev_idle->next_idle = next_idle;
+   else
+      {
+      if (first_idle != this) return; // NB: not in the list...
+
+      first_idle = next_idle;
+      }
+
+   if (next_idle) next_idle->prev_idle = prev_idle;
+   else
+      {
+      U_INTERNAL_ASSERT_EQUALS(last_idle, this)
+
+      last_idle = prev_idle;
+      }
+
+   prev_idle = next_idle = 0;
+}
+
+void UClientImage_Base::setLastEvent()
+{
+   U_TRACE(0, "UClientImage_Base::setLastEvent()")
+
+   last_event = u_now->tv_sec;
+
+   // NB: u_now don't go back, so appending at the tail the list remain ordered by last_event...
+
+   if (last_idle != this)
+      {
+      eraseIdle();
+
+      prev_idle = last_idle;
+
+      if (last_idle) last_idle->next_idle = this;
+      else           first_idle           = this;
+
+      last_idle = this;
+      }
+
+   U_INTERNAL_ASSERT_EQUALS(next_idle, 0)
+}
+
 // define method VIRTUAL of class UEventFd
 
 int UClientImage_Base::handlerError(int sock_state)
@@ -729,7 +876,11 @@ int UClientImage_Base::handlerRead()
 loop:
    ++counter;
 
-   U_INTERNAL_DUMP("counter = %u", counter)
+   U_INTERNAL_DUMP("counter = %u nrequest = %u", counter, nrequest)
+
+   request_start = UServer_Base::metricsRequestBegin();
+
+   if (UMemoryArena::base) UMemoryArena::begin(); // NB: the strings created while we process the request are allocated on the arena...
 
    if (UServer_Base::isLog())
       {
@@ -747,10 +898,18 @@ loop:
    if (state == U_PLUGIN_HANDLER_FINISHED &&
        UServer_Base::bpluginsHandlerRequest)
       {
+      if (isResponseQueued()) (void) flushResponseQueue(); // NB: the plugins of the request phase can write directly on the socket...
+
       state = UServer_Base::pluginsHandlerRequest(); // manage request...
       }
 
-   if (write_off) write_off = false;
+   setRequestMetrics();
+
+   if (write_off)
+      {
+      write_off   = false;
+      request_out = 0; // NB: the plugin has written directly on the socket...
+      }
    else
       {
       U_INTERNAL_DUMP("wbuffer(%u) = %.*S", wbuffer->size(), U_STRING_TO_TRACE(*wbuffer))
@@ -778,7 +937,21 @@ loop:
             socket->setTcpCork(1U); // On Linux, sendfile() depends on the TCP_CORK socket option to avoid undesirable packet boundaries...
 #        endif
 
-            if (USocketExt::write(socket, *wbuffer, UServer_Base::timeoutMS) == false)
+            bool result;
+
+            if (isResponseQueued() == false) result = USocketExt::write(socket, *wbuffer, UServer_Base::timeoutMS);
+            else
+               {
+               // NB: the header of the response go out together with the queue of the responses for pipelined requests...
+
+               (void) qbuffer->append(*wbuffer);
+
+               result = USocketExt::write(socket, *qbuffer, UServer_Base::timeoutMS);
+
+               qbuffer->setEmpty();
+               }
+
+            if (result == false)
                {
                state = U_PLUGIN_HANDLER_ERROR;
 
@@ -791,13 +964,22 @@ loop:
       }
 
 next:
+   if (request_start &&
+       isPendingWrite() == false)
+      {
+      endRequestMetrics();
+      }
+
+   if (UMemoryArena::active) UMemoryArena::end();
+
 #ifdef U_HTTP_CACHE_REQUEST
    if ((state & U_PLUGIN_HANDLER_AGAIN) != 0)
       {
       if ((state & U_PLUGIN_HANDLER_ERROR) != 0) state = U_PLUGIN_HANDLER_ERROR;
+      else if (pipeline)                         state = U_PLUGIN_HANDLER_FINISHED; // NB: response from cache for a pipelined request, we go on with the next...
       else
          {
-         last_event = u_now->tv_sec;
+         setLastEvent();
 
          U_RETURN(U_NOTIFIER_OK);
          }
@@ -817,10 +999,17 @@ next:
    if (socket->isClosed()                  ||
        (state    == U_PLUGIN_HANDLER_ERROR &&
         pipeline == false)                 ||
-        UServer_Base::flag_loop == false)
+        UServer_Base::flag_loop == false   ||
+        UServer_Base::flag_drain)
       {
       if (UServer_Base::isParallelization()) U_EXIT(0);
-  
+
+      if (bcork ||
+          isResponseQueued())
+         {
+         (void) flushResponseQueue();
+         }
+
       resetPipeline();
 
       U_INTERNAL_ASSERT_MAJOR(UEventFd::fd, 0)
@@ -860,8 +1049,10 @@ next:
 
                if (pbuffer->size() < 18) pbuffer->reserve(U_CAPACITY);
 
+#           ifndef U_HTTP_CACHE_REQUEST // NB: with the cache of request the response can be reused (UHTTP::manageRequest() clear it if needed)...
                   body->clear();
                wbuffer->clear();
+#           endif
 
                goto loop;
                }
@@ -869,15 +1060,48 @@ next:
          }
 
       pbuffer->clear();
+
+      if (bcork ||
+          isResponseQueued())
+         {
+         if (flushResponseQueue() == false) U_RETURN(U_NOTIFIER_DELETE);
+         }
       }
 
    if (UServer_Base::isLog() == false) U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
 
-   last_event = u_now->tv_sec;
+   setLastEvent();
 
    U_RETURN(U_NOTIFIER_OK);
 }
 
+bool UClientImage_Base::flushResponseQueue()
+{
+   U_TRACE(0, "UClientImage_Base::flushResponseQueue()")
+
+   U_INTERNAL_DUMP("qbuffer(%u) = %.*S bcork = %b", qbuffer->size(), U_STRING_TO_TRACE(*qbuffer), bcork)
+
+   bool result = true;
+
+   if (qbuffer->empty() == false)
+      {
+      if (socket->isOpen()) result = USocketExt::write(socket, *qbuffer, UServer_Base::timeoutMS);
+
+      qbuffer->setEmpty();
+      }
+
+#if defined(LINUX) || defined(__LINUX__) || defined(__linux__)
+   if (bcork)
+      {
+      bcork = false;
+
+      if (socket->isOpen()) socket->setTcpCork(0U);
+      }
+#endif
+
+   U_RETURN(result);
+}
+
 int UClientImage_Base::handlerWrite()
 {
    U_TRACE(0, "UClientImage_Base::handlerWrite()")
@@ -890,15 +1114,84 @@ int UClientImage_Base::handlerWrite()
    U_INTERNAL_ASSERT_EQUALS(write_off, false)
    U_INTERNAL_ASSERT_EQUALS(UEventFd::fd, socket->iSockDesc)
 
-   bool bwrite  = (UEventFd::op_mask == U_WRITE_OUT);
-   off_t offset = start;
+   off_t offset;
+   int32_t value;
+   uint32_t n;
+   bool bwrite = (UEventFd::op_mask == U_WRITE_OUT);
 
    U_INTERNAL_DUMP("bwrite = %b", bwrite)
 
+loop:
+   if (count == 0)
+      {
+      // NB: multi-range response, the segment of the file is completed: we write the header of the next part (or the closing boundary)
+      //     without blocking, if the socket buffer is full we go on at the next U_WRITE_OUT from range_pos...
+
+      U_INTERNAL_ASSERT_MAJOR(range_num, 0)
+
+      range_segment* r = vrange + range_index;
+
+      U_INTERNAL_DUMP("range_index = %u range_num = %u range_pos = %u r->len = %u", range_index, range_num, range_pos, r->len)
+
+      value = socket->send(range_part->c_pointer(range_pos), r->len);
+
+      if (value <= 0)
+         {
+         U_INTERNAL_DUMP("errno = %d", errno)
+
+         if (value == 0 ||
+             errno != EAGAIN)
+            {
+            U_RETURN(U_NOTIFIER_DELETE);
+            }
+
+         goto pending;
+         }
+
+      range_pos += value;
+      r->len    -= value;
+
+      if (r->len) goto loop; // NB: we go on until EAGAIN (the event of write can be edge-triggered)...
+
+      if (++range_index < range_num)
+         {
+         start = r[1].start;
+         count = r[1].count;
+
+         goto loop;
+         }
+
+      resetRange();
+
+      goto completed;
+      }
+
+   n      = count;
+   offset = start;
+
+   if (UServer_Base::isDiskIO())
+      {
+      // NB: we send at most a segment of U_DISK_IO_WINDOW bytes, and if the data at the offset are not in page cache the
+      //     segment is read by a thread of disk I/O while the connection wait without event of write (see UServer_Base)...
+
+      if (n > U_DISK_IO_WINDOW) n = U_DISK_IO_WINDOW;
+
+      if (UServer_Base::flag_loop                        &&
+          UServer_Base::isDataNotResident(sfd, start, n) &&
+          UServer_Base::readDataAsync(this, n))
+         {
+         UEventFd::op_mask = 0;
+
+         if (UNotifier::find(UEventFd::fd)) UNotifier::modify(this);
+
+         goto end;
+         }
+      }
+
 #ifdef __MINGW32__
-   int32_t value = U_SYSCALL(sendfile, "%d,%d,%p,%u", socket->getFd(), sfd, &offset, count);
+   value = U_SYSCALL(sendfile, "%d,%d,%p,%u", socket->getFd(), sfd, &offset, n);
 #else
-   int32_t value = U_SYSCALL(sendfile, "%d,%d,%p,%u",    UEventFd::fd, sfd, &offset, count);
+   value = U_SYSCALL(sendfile, "%d,%d,%p,%u",    UEventFd::fd, sfd, &offset, n);
 #endif
 
    if (value <= 0)
@@ -906,6 +1199,8 @@ int UClientImage_Base::handlerWrite()
       U_INTERNAL_DUMP("errno = %d", errno)
 
       if (errno != EAGAIN) U_RETURN(U_NOTIFIER_DELETE);
+
+      if (range_num) goto pending; // NB: the socket buffer is full after the header of a part...
       }
    else
       {
@@ -919,10 +1214,12 @@ int UClientImage_Base::handlerWrite()
                                     U_STRING_TO_TRACE(*UServer_Base::mod_name), value, sfd, count, counter);
          }
 
-      if (isPendingWrite())
+      if (count)
          {
          start += value;
 
+         if ((uint32_t)value == n) goto loop; // NB: the segment is limited by U_DISK_IO_WINDOW and the socket can accept other data...
+pending:
          if (bwrite == false)
             {
             UEventFd::op_mask = U_WRITE_OUT;
@@ -930,8 +1227,10 @@ int UClientImage_Base::handlerWrite()
             if (UNotifier::find(UEventFd::fd)) UNotifier::modify(this);
             }
          }
+      else if (range_num) goto loop; // NB: multi-range response, the header of the next part...
       else
          {
+completed:
 #     ifdef U_CLIENT_RESPONSE_PARTIAL_WRITE_SUPPORT
          if (bwrite &&
              UServer_Base::isLog())
@@ -942,8 +1241,14 @@ int UClientImage_Base::handlerWrite()
             }
 #     endif
 
+         if (request_start) endRequestMetrics(); // NB: the response is completed...
+
          if ((bclose & U_CLOSE) != 0) UFile::close(sfd);
-         if ((bclose & U_YES)   != 0) U_RETURN(U_NOTIFIER_DELETE);
+         if ((bclose & U_YES)   != 0 ||
+             UServer_Base::flag_drain)     // NB: graceful stop, the response is completed...
+            {
+            U_RETURN(U_NOTIFIER_DELETE);
+            }
 
          UEventFd::op_mask = U_READ_IN;
 
@@ -951,6 +1256,7 @@ int UClientImage_Base::handlerWrite()
          }
       }
 
+end:
 #if defined(LINUX) || defined(__LINUX__) || defined(__linux__)
    if (bwrite == false) socket->setTcpCork(0U); // On Linux, sendfile() depends on TCP_CORK option to avoid undesirable packet boundaries
 #endif
@@ -958,6 +1264,53 @@ int UClientImage_Base::handlerWrite()
    U_RETURN(U_NOTIFIER_OK);
 }
 
+void UClientImage_Base::setRequestMetrics()
+{
+   U_TRACE(0, "UClientImage_Base::setRequestMetrics()")
+
+   request_in   = (size_request ? size_request : rbuffer->size());
+   request_out  = wbuffer->size() + body->size() + count;
+   request_code = u_http_info.nResponseCode;
+
+   if (range_num)
+      {
+      // NB: multi-range response, the other segments of the file and the header of the parts are sent by handlerWrite()...
+
+      for (uint32_t i = 1; i < range_num; ++i) request_out += vrange[i].count;
+
+      request_out += range_part->size();
+      }
+
+   U_INTERNAL_DUMP("request_in = %u request_out = %u request_code = %u", request_in, request_out, request_code)
+}
+
+void UClientImage_Base::endRequestMetrics()
+{
+   U_TRACE(0, "UClientImage_Base::endRequestMetrics()")
+
+   U_INTERNAL_ASSERT_MAJOR(request_start, 0)
+
+   UServer_Base::metricsRequestEnd(request_start, request_code, request_in, request_out, (nrequest++ > 0));
+
+   request_start = 0;
+}
+
+void UClientImage_Base::resetRange()
+{
+   U_TRACE(0, "UClientImage_Base::resetRange()")
+
+   U_INTERNAL_ASSERT_POINTER(vrange)
+   U_INTERNAL_ASSERT_POINTER(range_part)
+   U_INTERNAL_ASSERT_MAJOR(range_num, 0)
+
+   UMemoryPool::_free(vrange, range_num, sizeof(range_segment));
+
+   vrange    = 0;
+   range_num = range_index = range_pos = 0;
+
+   range_part->setEmpty(); // NB: the buffer is reused by the next multi-range response on this connection...
+}
+
 void UClientImage_Base::handlerDelete()
 {
    U_TRACE(0, "UClientImage_Base::handlerDelete()")
@@ -968,6 +1321,8 @@ void UClientImage_Base::handlerDelete()
 
    UServer_Base::handlerCloseConnection(this);
 
+   eraseIdle();
+
    if (socket->isOpen()) socket->closesocket();
 
    --UNotifier::num_connection;
@@ -988,6 +1343,10 @@ void UClientImage_Base::handlerDelete()
 
       if ((bclose & U_CLOSE) != 0) UFile::close(sfd);
 
+      if (range_num) resetRange();
+
+      ++disk_io_gen; // NB: the completion of a read in progress on a thread of disk I/O (if any) must be ignored...
+
       // reset
 
       count             = 0;
@@ -1018,10 +1377,17 @@ const char* UClientImage_Base::dump(bool _reset) const
                   << "state                              " << state              << '\n'
                   << "start                              " << start              << '\n'
                   << "count                              " << count              << '\n'
+                  << "nrequest                           " << nrequest           << '\n'
+                  << "range_num                          " << range_num          << '\n'
+                  << "range_pos                          " << range_pos          << '\n'
+                  << "range_index                        " << range_index        << '\n'
+                  << "disk_io_gen                        " << disk_io_gen        << '\n'
                   << "bIPv6                              " << bIPv6              << '\n'
                   << "bclose                             " << bclose             << '\n'
                   << "write_off                          " << write_off          << '\n'
                   << "last_event                         " << last_event         << '\n'
+                  << "prev_idle       (UClientImage_Base " << (void*)prev_idle   << ")\n"
+                  << "next_idle       (UClientImage_Base " << (void*)next_idle   << ")\n"
                   << "socket          (USocket           " << (void*)socket      << ")\n"
                   << "body            (UString           " << (void*)body        << ")\n"
                   << "logbuf          (UString           " << (void*)logbuf      << ")\n"
@@ -1029,6 +1395,7 @@ const char* UClientImage_Base::dump(bool _reset) const
                   << "wbuffer         (UString           " << (void*)wbuffer     << ")\n"
                   << "request         (UString           " << (void*)request     << ")\n"
                   << "pbuffer         (UString           " << (void*)pbuffer     << ")\n"
+                  << "range_part      (UString           " << (void*)range_part  << ")\n"
                   << "environment     (UString           " << (void*)environment << ")\n"
                   << "msg_welcome     (UString           " << (void*)msg_welcome << ')';
 
@@ -95,12 +95,6 @@ typedef struct {
 #define FCGI_AUTHORIZER 2
 #define FCGI_FILTER     3
 
-typedef struct {
-   u_short role;
-   u_char  flags;
-   u_char  reserved[5];
-} FCGI_BeginRequestBody;
-
 /*
  * Values for protocolStatus component of FCGI_EndRequestBody
  */
@@ -115,42 +109,12 @@ typedef struct {
    u_char reserved[3];
 } FCGI_EndRequestBody;
 
-typedef struct {
-   FCGI_Header           header;
-   FCGI_BeginRequestBody body;
-} FCGI_BeginRequestRecord;
-
 typedef struct {
    FCGI_Header         header;
    FCGI_EndRequestBody body;
 } FCGI_EndRequestRecord;
 
-// Initialize a fast CGI header record
-
-static FCGI_BeginRequestRecord beginRecord;
-
-void UFCGIPlugIn::set_FCGIBeginRequest()
-{
-   U_TRACE(0, "UFCGIPlugIn::set_FCGIBeginRequest()")
-
-   beginRecord.header.version    = FCGI_VERSION_1;
-   beginRecord.header.request_id = htons((uint16_t)u_pid); // NB: we aren't supporting multiplexing than we use always the same request-id...
-
-   beginRecord.body.role         = htons(FCGI_RESPONDER);
-   beginRecord.body.flags        = fcgi_keep_conn;
-}
-
-void UFCGIPlugIn::fill_FCGIBeginRequest(u_char type, u_short content_length)
-{
-   U_TRACE(0, "UFCGIPlugIn::fill_FCGIBeginRequest(%C,%d)", type, content_length)
-
-// beginRecord.header.version        = FCGI_VERSION_1;
-   beginRecord.header.type           = type;
-// beginRecord.header.request_id     = htons((uint16_t)u_pid);
-   beginRecord.header.content_length = htons(content_length);
-// beginRecord.header.padding_length = padding_length;
-// beginRecord.header.reserved       = 0;
-}
+// NB: the request is built by UHTTP::getFCGIRequest() (shared with the pool of runner of CGI_POOL)...
 
 // ---------------------------------------------------------------------------------------------------------------
 // END Fast CGI stuff
@@ -256,8 +220,6 @@ int UFCGIPlugIn::handlerInit()
 
          U_SRV_LOG("initialization of plugin success");
 
-         set_FCGIBeginRequest();
-
          // NB: FCGI is NOT a static page...
 
          if (UHTTP::valias == 0) UHTTP::valias = U_NEW(UVector<UString>(2U));
@@ -288,18 +250,9 @@ int UFCGIPlugIn::handlerRequest()
 
    if (u_dosmatch_with_OR(U_HTTP_URI_TO_PARAM, U_STRING_TO_PARAM(*UHTTP::fcgi_uri_mask), 0))
       {
-      fill_FCGIBeginRequest(FCGI_BEGIN_REQUEST, sizeof(FCGI_BeginRequestBody));
-
       FCGI_Header* h;
-      char* equalPtr;
-      char* envp[128];
-      uint32_t clength, pos, size;
-      unsigned char  headerBuff[8];
-      unsigned char* headerBuffPtr;
-      UString request(U_CAPACITY), params(U_CAPACITY);
-      int nameLen, valueLen, headerLen, byte_to_read, i, n;
-
-      (void) request.append((const char*)&beginRecord, sizeof(FCGI_BeginRequestRecord));
+      int byte_to_read;
+      uint32_t clength, pos;
 
       // Set environment for the FCGI application server
 
@@ -312,85 +265,9 @@ int UFCGIPlugIn::handlerRequest()
          U_RETURN(U_PLUGIN_HANDLER_ERROR);
          }
 
-      n = u_split(U_STRING_TO_PARAM(environment), envp, 0);
-
-      U_INTERNAL_ASSERT_MINOR(n, 128)
-
-      for (i = 0; i < n; ++i)
-         {
-         equalPtr = strchr(envp[i], '=');
-
-         U_INTERNAL_ASSERT_POINTER(equalPtr)
-
-          nameLen = (equalPtr - envp[i]);
-         valueLen = u__strlen(++equalPtr, __PRETTY_FUNCTION__);
-
-         U_INTERNAL_ASSERT_MAJOR( nameLen, 0)
-         U_INTERNAL_ASSERT_MAJOR(valueLen, 0)
-
-         // Builds a name-value pair header from the name length and the value length
-
-         headerBuffPtr = headerBuff;
-
-         if (nameLen < 0x80) *headerBuffPtr++ = (unsigned char) nameLen;
-         else
-            {
-            *headerBuffPtr++ = (unsigned char) ((nameLen >> 24) | 0x80);
-            *headerBuffPtr++ = (unsigned char)  (nameLen >> 16);
-            *headerBuffPtr++ = (unsigned char)  (nameLen >>  8);
-            *headerBuffPtr++ = (unsigned char)   nameLen;
-            }
-
-         if (valueLen < 0x80) *headerBuffPtr++ = (unsigned char) valueLen;
-         else
-            {
-            *headerBuffPtr++ = (unsigned char) ((valueLen >> 24) | 0x80);
-            *headerBuffPtr++ = (unsigned char)  (valueLen >> 16);
-            *headerBuffPtr++ = (unsigned char)  (valueLen >>  8);
-            *headerBuffPtr++ = (unsigned char)   valueLen;
-            }
-
-         headerLen = headerBuffPtr - headerBuff;
-
-         U_INTERNAL_ASSERT_MAJOR(valueLen, 0)
-
-         (void) params.append((const char*)headerBuff, headerLen);
-         (void) params.append(envp[i], nameLen);
-         (void) params.append(equalPtr, valueLen);
-         }
-
-      fill_FCGIBeginRequest(FCGI_PARAMS, params.size());
-
-      (void) request.append((const char*)&beginRecord, FCGI_HEADER_LEN);
-      (void) request.append(params);
-
-      // maybe we have some data to put on stdin of cgi process (POST)
-
-      U_INTERNAL_DUMP("UClientImage_Base::body(%u) = %.*S", UClientImage_Base::body->size(), U_STRING_TO_TRACE(*UClientImage_Base::body))
+      // NB: we aren't supporting multiplexing than we use always the same request-id...
 
-      size = UClientImage_Base::body->size();
-
-      if (size)
-         {
-         U_INTERNAL_ASSERT(UHTTP::isPOST())
-
-         fill_FCGIBeginRequest(FCGI_PARAMS, 0);
-
-         (void) request.append((const char*)&beginRecord, FCGI_HEADER_LEN);
-         }
-
-      fill_FCGIBeginRequest(FCGI_STDIN, size);
-
-      (void) request.append((const char*)&beginRecord, FCGI_HEADER_LEN);
-
-      if (size)
-         {
-         (void) request.append(*UClientImage_Base::body);
-
-         fill_FCGIBeginRequest(FCGI_STDIN, 0);
-
-         (void) request.append((const char*)&beginRecord, FCGI_HEADER_LEN);
-         }
+      UString request = UHTTP::getFCGIRequest(environment, (uint16_t)u_pid, fcgi_keep_conn);
 
       // Send request and read fast cgi header+record
 
@@ -38,6 +38,14 @@ const UString* UHttpPlugIn::str_MAINTENANCE_MODE;
 const UString* UHttpPlugIn::str_APACHE_LIKE_LOG;
 const UString* UHttpPlugIn::str_USP_AUTOMATIC_ALIASING;
 const UString* UHttpPlugIn::str_CACHE_FILE_STORE;
+const UString* UHttpPlugIn::str_STATUS_URI;
+const UString* UHttpPlugIn::str_MICRO_CACHE_SIZE;
+const UString* UHttpPlugIn::str_MICRO_CACHE_TTL;
+const UString* UHttpPlugIn::str_MICRO_CACHE_SHARED;
+const UString* UHttpPlugIn::str_MICRO_CACHE_MAX_TTL;
+const UString* UHttpPlugIn::str_CACHE_FILE_SHARED;
+
+UString* UHttpPlugIn::status_uri;
 
 void UHttpPlugIn::str_allocate()
 {
@@ -59,6 +67,12 @@ void UHttpPlugIn::str_allocate()
    U_INTERNAL_ASSERT_EQUALS(str_APACHE_LIKE_LOG,0)
    U_INTERNAL_ASSERT_EQUALS(str_USP_AUTOMATIC_ALIASING,0)
    U_INTERNAL_ASSERT_EQUALS(str_CACHE_FILE_STORE,0)
+   U_INTERNAL_ASSERT_EQUALS(str_STATUS_URI,0)
+   U_INTERNAL_ASSERT_EQUALS(str_MICRO_CACHE_SIZE,0)
+   U_INTERNAL_ASSERT_EQUALS(str_MICRO_CACHE_TTL,0)
+   U_INTERNAL_ASSERT_EQUALS(str_MICRO_CACHE_SHARED,0)
+   U_INTERNAL_ASSERT_EQUALS(str_CACHE_FILE_SHARED,0)
+   U_INTERNAL_ASSERT_EQUALS(str_MICRO_CACHE_MAX_TTL,0)
 
    static ustringrep stringrep_storage[] = {
       { U_STRINGREP_FROM_CONSTANT("CACHE_FILE_MASK") },
@@ -76,7 +90,13 @@ void UHttpPlugIn::str_allocate()
       { U_STRINGREP_FROM_CONSTANT("MAINTENANCE_MODE") },
       { U_STRINGREP_FROM_CONSTANT("APACHE_LIKE_LOG") },
       { U_STRINGREP_FROM_CONSTANT("USP_AUTOMATIC_ALIASING") },
-      { U_STRINGREP_FROM_CONSTANT("CACHE_FILE_STORE") }
+      { U_STRINGREP_FROM_CONSTANT("CACHE_FILE_STORE") },
+      { U_STRINGREP_FROM_CONSTANT("STATUS_URI") },
+      { U_STRINGREP_FROM_CONSTANT("MICRO_CACHE_SIZE") },
+      { U_STRINGREP_FROM_CONSTANT("MICRO_CACHE_TTL") },
+      { U_STRINGREP_FROM_CONSTANT("MICRO_CACHE_SHARED") },
+      { U_STRINGREP_FROM_CONSTANT("CACHE_FILE_SHARED") },
+      { U_STRINGREP_FROM_CONSTANT("MICRO_CACHE_MAX_TTL") }
    };
 
    U_NEW_ULIB_OBJECT(str_CACHE_FILE_MASK,                            U_STRING_FROM_STRINGREP_STORAGE(0));
@@ -95,6 +115,12 @@ void UHttpPlugIn::str_allocate()
    U_NEW_ULIB_OBJECT(str_APACHE_LIKE_LOG,                            U_STRING_FROM_STRINGREP_STORAGE(13));
    U_NEW_ULIB_OBJECT(str_USP_AUTOMATIC_ALIASING,                     U_STRING_FROM_STRINGREP_STORAGE(14));
    U_NEW_ULIB_OBJECT(str_CACHE_FILE_STORE,                           U_STRING_FROM_STRINGREP_STORAGE(15));
+   U_NEW_ULIB_OBJECT(str_STATUS_URI,                                 U_STRING_FROM_STRINGREP_STORAGE(16));
+   U_NEW_ULIB_OBJECT(str_MICRO_CACHE_SIZE,                           U_STRING_FROM_STRINGREP_STORAGE(17));
+   U_NEW_ULIB_OBJECT(str_MICRO_CACHE_TTL,                            U_STRING_FROM_STRINGREP_STORAGE(18));
+   U_NEW_ULIB_OBJECT(str_MICRO_CACHE_SHARED,                         U_STRING_FROM_STRINGREP_STORAGE(19));
+   U_NEW_ULIB_OBJECT(str_CACHE_FILE_SHARED,                          U_STRING_FROM_STRINGREP_STORAGE(20));
+   U_NEW_ULIB_OBJECT(str_MICRO_CACHE_MAX_TTL,                        U_STRING_FROM_STRINGREP_STORAGE(21));
 }
 
 UHttpPlugIn::~UHttpPlugIn()
@@ -102,6 +128,8 @@ UHttpPlugIn::~UHttpPlugIn()
    U_TRACE_UNREGISTER_OBJECT(0, UHttpPlugIn)
 
    UHTTP::dtor(); // delete global HTTP context...
+
+   if (status_uri) delete status_uri;
 }
 
 // define method VIRTUAL of class UEventFd
@@ -133,6 +161,7 @@ int UHttpPlugIn::handlerConfig(UFileConfig& cfg)
    // ------------------------------------------------------------------------------------------------------------------------------------------------
    // ALIAS                        vector of URI redirection (request -> alias)
    // REWRITE_RULE_NF              vector of URI rewrite rule applied after checks that files do not exist (regex1 -> uri1 ...)
+   // CGI_POOL                     vector of mask (DOS regexp) of CGI served by a pool of runner pre-spawned (FastCGI responder) and number of runner (mask1 num1 ...)
    // USP_AUTOMATIC_ALIASING       USP page that is recognized automatically as alias of all uri request without suffix
    //
    // MAINTENANCE_MODE             to switch the site to a maintenance page only
@@ -143,9 +172,17 @@ int UHttpPlugIn::handlerConfig(UFileConfig& cfg)
    // TELNET_ENABLE                accept fragmentation of header request (as happen with telnet)
    // CACHE_FILE_MASK              mask (DOS regexp) of pathfile that be cached in memory
    // CACHE_FILE_STORE             pathfile of memory cache stored on filesystem
+   // CACHE_FILE_SHARED            max size of the area mmap-ed shared (read-only) by the preforked children with the content of memory cache (default 0 - none)
    //
    // MIN_SIZE_FOR_SENDFILE        for major size it is better to use sendfile() to serve static content
    //
+   // MICRO_CACHE_SIZE             number of entries of the micro-cache of the responses (GET/HEAD) of every child (default 0 - disabled)
+   // MICRO_CACHE_TTL              time to live (sec) of the entries when the response don't have 'Cache-Control: max-age' (default 1)
+   // MICRO_CACHE_MAX_TTL          max time to live (sec) of the entries, also with 'Cache-Control: max-age' (default 5)
+   // MICRO_CACHE_SHARED           size of the area mmap-ed shared by the preforked children as second level of the micro-cache (default 0 - none)
+   //
+   // STATUS_URI                   URI that show the runtime statistics of the server (per-child metrics, memory pool, ...) - protect it with URI_PROTECTED_MASK
+   //
    // VIRTUAL_HOST                 flag to activate practice of maintaining more than one server on one machine,
    //                              as differentiated by their apparent hostname
    // DIGEST_AUTHENTICATION        flag authentication method (yes = digest, no = basic)
@@ -193,6 +230,18 @@ int UHttpPlugIn::handlerConfig(UFileConfig& cfg)
 
          UHTTP::vRewriteRule->push_back(rule);
          }
+
+      tmp.clear();
+      }
+
+   if (cfg.loadVector(tmp, "CGI_POOL") &&
+       tmp.empty() == false)
+      {
+      U_INTERNAL_ASSERT_EQUALS(UHTTP::vcgi_pool_mask,0)
+
+      UHTTP::vcgi_pool_mask = UVector<UString>::duplicate(&tmp);
+
+      tmp.clear();
       }
 
    if (cfg.loadTable())
@@ -203,6 +252,17 @@ int UHttpPlugIn::handlerConfig(UFileConfig& cfg)
       UHTTP::request_read_timeout            = cfg.readLong(*str_REQUEST_READ_TIMEOUT);
       UHTTP::min_size_for_sendfile           = cfg.readLong(*str_MIN_SIZE_FOR_SENDFILE);
       UHTTP::enable_caching_by_proxy_servers = cfg.readBoolean(*str_ENABLE_CACHING_BY_PROXY_SERVERS);
+      UHTTP::cache_file_shared_size          = cfg.readLong(*str_CACHE_FILE_SHARED);
+
+#  ifdef U_HTTP_CACHE_REQUEST
+      UHTTP::micro_cache_size        = cfg.readLong(*str_MICRO_CACHE_SIZE);
+      UHTTP::micro_cache_ttl         = cfg.readLong(*str_MICRO_CACHE_TTL, 1);
+      UHTTP::micro_cache_max_ttl     = cfg.readLong(*str_MICRO_CACHE_MAX_TTL, 5);
+      UHTTP::micro_cache_shared_size = cfg.readLong(*str_MICRO_CACHE_SHARED);
+
+      U_INTERNAL_DUMP("UHTTP::micro_cache_size = %u UHTTP::micro_cache_ttl = %u UHTTP::micro_cache_max_ttl = %u UHTTP::micro_cache_shared_size = %u",
+                       UHTTP::micro_cache_size,     UHTTP::micro_cache_ttl,     UHTTP::micro_cache_max_ttl,     UHTTP::micro_cache_shared_size)
+#  endif
 
       U_INTERNAL_DUMP("UHTTP::limit_request_body = %u", UHTTP::limit_request_body)
 
@@ -281,6 +341,17 @@ int UHttpPlugIn::handlerConfig(UFileConfig& cfg)
 
       if (x.empty() == false) UHTTP::maintenance_mode_page = U_NEW(UString(x));
 
+      x = cfg[*str_STATUS_URI];
+
+      if (x.empty() == false)
+         {
+         U_INTERNAL_ASSERT_EQUALS(status_uri, 0)
+
+         if (x.first_char() != '/') (void) x.insert(0, '/');
+
+         status_uri = U_NEW(UString(x));
+         }
+
       x = cfg[*str_USP_AUTOMATIC_ALIASING];
 
       if (x.empty() == false)
@@ -369,6 +440,12 @@ int UHttpPlugIn::handlerRun()
 
    // NB: we use this method because now we have the shared data allocated by UServer...
 
+#ifdef U_HTTP_CACHE_REQUEST
+   UHTTP::initRequestCache();
+#endif
+
+   UHTTP::initCacheFileShared();
+
    if (UServer_Base::isLog()) UServer_Base::mod_name->snprintf("[usp_init] ", 0);
 
    UHTTP::cache_file->callForAllEntry(UHTTP::callInitForAllUSP);
@@ -389,6 +466,43 @@ int UHttpPlugIn::handlerStop()
    U_RETURN(U_PLUGIN_HANDLER_GO_ON);
 }
 
+U_NO_EXPORT void UHttpPlugIn::setStatusResponse()
+{
+   U_TRACE(0, "UHttpPlugIn::setStatusResponse()")
+
+   char buffer[4096];
+   uint32_t n;
+   UString body(U_CAPACITY), ctype(U_CONSTANT_TO_PARAM("text/plain" U_CRLF));
+
+   body.snprintf("pid %P\n", 0);
+
+   UServer_Base::writeMetrics(body); // NB: the size depend on the number of child and plugin, the string grow as needed...
+
+   (void) body.append(buffer, UMemoryPool::writeInfo(buffer, sizeof(buffer)));
+
+   if (UMemoryArena::base)
+      {
+      n = UMemoryArena::writeInfo(buffer, sizeof(buffer) - 1);
+
+      buffer[n++] = '\n';
+
+      (void) body.append(buffer, n);
+      }
+
+   if (UFile::huge_page)
+      {
+      n = UFile::writeHugePageInfo(buffer, sizeof(buffer) - 1);
+
+      buffer[n++] = '\n';
+
+      (void) body.append(buffer, n);
+      }
+
+   u_http_info.nResponseCode = HTTP_OK;
+
+   UHTTP::setResponse(&ctype, &body);
+}
+
 // Connection-wide hooks
 
 int UHttpPlugIn::handlerREAD()
@@ -443,6 +557,15 @@ int UHttpPlugIn::handlerRequest()
             goto end;
             }
 
+         if (status_uri              &&
+             UHTTP::isGETorHEAD()    &&
+             U_HTTP_URI_EQUAL(*status_uri))
+            {
+            setStatusResponse();
+
+            goto end;
+            }
+
          UHTTP::setNotFound(); // set not found error response...
          }
       break;
@@ -12,6 +12,7 @@
 // ============================================================================
 
 #include <ulib/db/rdb.h>
+#include <ulib/timer.h>
 #include <ulib/command.h>
 #include <ulib/notifier.h>
 #include <ulib/file_config.h>
@@ -76,19 +77,25 @@
 
 #define U_DEFAULT_PORT 80
 
-int                               UServer_Base::sfd;
 int                               UServer_Base::port;
-int                               UServer_Base::bclose;
 int                               UServer_Base::iAddressType;
 int                               UServer_Base::iBackLog = SOMAXCONN;
 int                               UServer_Base::timeoutMS = -1;
 int                               UServer_Base::cgi_timeout;
 int                               UServer_Base::verify_mode;
+int                               UServer_Base::child_index;
 int                               UServer_Base::preforked_num_kids;
+int                               UServer_Base::disk_io_thread;
+int                               UServer_Base::nupgrade_fd;
+int*                              UServer_Base::vreuseport_fd;
+int*                              UServer_Base::vupgrade_fd;
 bool                              UServer_Base::bssl;
 bool                              UServer_Base::bipc;
 bool                              UServer_Base::flag_loop;
+bool                              UServer_Base::flag_drain;
+bool                              UServer_Base::plugin_timing;
 bool                              UServer_Base::public_address;
+bool                              UServer_Base::enable_reuseport;
 bool                              UServer_Base::monitoring_process;
 bool                              UServer_Base::bpluginsHandlerReset;
 bool                              UServer_Base::bpluginsHandlerRequest;
@@ -99,13 +106,13 @@ bool                              UServer_Base::flag_use_tcp_optimization;
 ULog*                             UServer_Base::log;
 char*                             UServer_Base::client_address;
 pid_t                             UServer_Base::pid;
-time_t                            UServer_Base::expire;
+pid_t                             UServer_Base::upgrade_pid;
+pid_t*                            UServer_Base::vchild_pid;
 time_t                            UServer_Base::last_event;
 int32_t                           UServer_Base::oClientImage;
-uint32_t                          UServer_Base::start;
-uint32_t                          UServer_Base::count;
 uint32_t                          UServer_Base::map_size;
 uint32_t                          UServer_Base::vplugin_size;
+uint32_t                          UServer_Base::vhook_size[U_NUM_HOOK];
 uint32_t                          UServer_Base::shared_data_add;
 UString*                          UServer_Base::mod_name;
 UString*                          UServer_Base::host;
@@ -124,9 +131,11 @@ UString*                          UServer_Base::IP_address;
 UString*                          UServer_Base::allow_IP;
 UString*                          UServer_Base::allow_IP_prv;
 UString*                          UServer_Base::document_root;
+UString*                          UServer_Base::cwd_startup;
 USocket*                          UServer_Base::socket;
 UProcess*                         UServer_Base::proc;
 UEventFd*                         UServer_Base::handler_inotify;
+UEventFd*                         UServer_Base::handler_disk_io;
 UEventTime*                       UServer_Base::ptime;
 UServer_Base*                     UServer_Base::pthis;
 UVector<UString>*                 UServer_Base::vplugin_name;
@@ -139,6 +148,11 @@ UVector<UIPAllow*>*               UServer_Base::vallow_IP;
 UVector<UIPAllow*>*               UServer_Base::vallow_IP_prv;
 UVector<UServerPlugIn*>*          UServer_Base::vplugin;
 UServer_Base::shared_data*        UServer_Base::ptr_shared_data;
+UServer_Base::child_metrics*      UServer_Base::pmetrics;
+UServer_Base::child_metrics*      UServer_Base::ptr_child_metrics;
+UServer_Base::plugin_hook*        UServer_Base::vhook[U_NUM_HOOK];
+UServer_Base::plugin_hook_stat*   UServer_Base::phook_stat;
+UServer_Base::plugin_hook_stat*   UServer_Base::ptr_hook_stat;
 UVector<UServer_Base::file_LOG*>* UServer_Base::vlog;
 
 const UString* UServer_Base::str_ENABLE_IPV6;
@@ -181,6 +195,12 @@ const UString* UServer_Base::str_USE_TCP_OPTIMIZATION;
 const UString* UServer_Base::str_LISTEN_BACKLOG;
 const UString* UServer_Base::str_SET_REALTIME_PRIORITY;
 const UString* UServer_Base::str_ENABLE_RFC1918_FILTER;
+const UString* UServer_Base::str_ENABLE_REUSEPORT;
+const UString* UServer_Base::str_REQ_ARENA_SIZE;
+const UString* UServer_Base::str_HUGE_PAGES;
+const UString* UServer_Base::str_PLUGIN_TIMING;
+const UString* UServer_Base::str_DISK_IO_THREAD;
+const UString* UServer_Base::str_TIMER_TICK;
 
 #if defined(HAVE_PTHREAD_H) && defined(ENABLE_THREAD)
 #  include <ulib/thread.h>
@@ -260,6 +280,145 @@ public:
       while (UServer_Base::flag_loop) UNotifier::waitForEvent(UServer_Base::ptime);
       }
 };
+
+#  if defined(HAVE_EVENTFD) && defined(HAVE_PREADV2) && defined(HAVE_EPOLL_WAIT) && !defined(USE_LIBEVENT)
+#     include <sys/uio.h>
+#     include <sys/eventfd.h>
+#     ifdef RWF_NOWAIT
+#        define U_DISK_IO_SUPPORT
+#     endif
+#  endif
+
+#  ifdef U_DISK_IO_SUPPORT
+#define U_DISK_IO_QUEUE 1024 // NB: max number of read in progress (must be a power of 2)...
+
+typedef struct disk_io_job {
+   UClientImage_Base* pclient;
+   uint32_t gen, start, count;
+   int fd;
+} disk_io_job;
+
+class UDiskIOThread : public UThread {
+public:
+
+   char* buffer; // NB: the data read are only for the page cache...
+
+   UDiskIOThread() : UThread(false, false)
+      {
+      uint32_t sz = U_DISK_IO_WINDOW;
+
+      buffer = UFile::mmap(&sz, -1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS);
+      }
+
+   // NB: the requests [rtail, rhead) and the completions [dtail, dhead) are in two circular buffers protected by the same mutex,
+   //     and njob (read not yet managed by the event loop) is never over U_DISK_IO_QUEUE...
+
+   static pthread_mutex_t mutex;
+   static pthread_cond_t cond;
+   static uint32_t rhead, rtail, dhead, dtail, njob;
+   static disk_io_job vreq[U_DISK_IO_QUEUE], vdone[U_DISK_IO_QUEUE];
+
+   virtual void run()
+      {
+      U_TRACE(0, "UDiskIOThread::run()")
+
+      // NB: the signals are managed by the main thread...
+
+      sigset_t mask;
+
+      (void) sigfillset(&mask);
+
+      (void) U_SYSCALL(pthread_sigmask, "%d,%p,%p", SIG_BLOCK, &mask, 0);
+
+      disk_io_job job;
+      uint64_t one = 1;
+
+      (void) U_SYSCALL(pthread_mutex_lock, "%p", &mutex);
+
+      while (UServer_Base::flag_loop)
+         {
+         if (rtail == rhead)
+            {
+            (void) U_SYSCALL(pthread_cond_wait, "%p,%p", &cond, &mutex);
+
+            continue;
+            }
+
+         job = vreq[rtail++ & (U_DISK_IO_QUEUE-1)];
+
+         (void) U_SYSCALL(pthread_mutex_unlock, "%p", &mutex);
+
+         // NB: we read the segment so that the sendfile() of the event loop find the data in page cache...
+
+         (void) U_SYSCALL(pread, "%d,%p,%u,%u", job.fd, buffer, job.count, job.start);
+
+         (void) U_SYSCALL(pthread_mutex_lock, "%p", &mutex);
+
+         vdone[dhead++ & (U_DISK_IO_QUEUE-1)] = job;
+
+         (void) U_SYSCALL(write, "%d,%p,%u", UServer_Base::handler_disk_io->fd, &one, sizeof(uint64_t));
+         }
+
+      (void) U_SYSCALL(pthread_mutex_unlock, "%p", &mutex);
+      }
+};
+
+pthread_mutex_t UDiskIOThread::mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  UDiskIOThread::cond  = PTHREAD_COND_INITIALIZER;
+uint32_t        UDiskIOThread::rhead;
+uint32_t        UDiskIOThread::rtail;
+uint32_t        UDiskIOThread::dhead;
+uint32_t        UDiskIOThread::dtail;
+uint32_t        UDiskIOThread::njob;
+disk_io_job     UDiskIOThread::vreq[U_DISK_IO_QUEUE];
+disk_io_job     UDiskIOThread::vdone[U_DISK_IO_QUEUE];
+
+class U_NO_EXPORT UDiskIOFd : public UEventFd {
+public:
+
+   // Allocator e Deallocator
+   U_MEMORY_ALLOCATOR
+   U_MEMORY_DEALLOCATOR
+
+   // COSTRUTTORI
+
+   UDiskIOFd()
+      {
+      U_TRACE_REGISTER_OBJECT(0, UDiskIOFd, "")
+      }
+
+   virtual ~UDiskIOFd()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, UDiskIOFd)
+      }
+
+   // define method VIRTUAL of class UEventFd
+
+   virtual int handlerRead()
+      {
+      U_TRACE(0, "UDiskIOFd::handlerRead()")
+
+      uint64_t value;
+
+      // NB: all the read completed since the last notify are managed in one pass...
+
+      if (U_SYSCALL(read, "%d,%p,%u", UEventFd::fd, &value, sizeof(uint64_t)) == (ssize_t)sizeof(uint64_t)) UServer_Base::handlerDiskIO();
+
+      U_RETURN(U_NOTIFIER_OK);
+      }
+
+   virtual void handlerDelete()
+      {
+      U_TRACE(0, "UDiskIOFd::handlerDelete()")
+
+      UEventFd::fd = 0; // NB: the object is owned by UServer_Base...
+      }
+
+private:
+   UDiskIOFd(const UDiskIOFd&) : UEventFd() {}
+   UDiskIOFd& operator=(const UDiskIOFd&)   { return *this; }
+};
+#  endif
 #endif
 
 #ifndef __MINGW32__
@@ -310,6 +469,12 @@ void UServer_Base::str_allocate()
    U_INTERNAL_ASSERT_EQUALS(str_LISTEN_BACKLOG,0)
    U_INTERNAL_ASSERT_EQUALS(str_SET_REALTIME_PRIORITY,0)
    U_INTERNAL_ASSERT_EQUALS(str_ENABLE_RFC1918_FILTER,0)
+   U_INTERNAL_ASSERT_EQUALS(str_ENABLE_REUSEPORT,0)
+   U_INTERNAL_ASSERT_EQUALS(str_REQ_ARENA_SIZE,0)
+   U_INTERNAL_ASSERT_EQUALS(str_HUGE_PAGES,0)
+   U_INTERNAL_ASSERT_EQUALS(str_PLUGIN_TIMING,0)
+   U_INTERNAL_ASSERT_EQUALS(str_DISK_IO_THREAD,0)
+   U_INTERNAL_ASSERT_EQUALS(str_TIMER_TICK,0)
 
    static ustringrep stringrep_storage[] = {
    { U_STRINGREP_FROM_CONSTANT("ENABLE_IPV6") },
@@ -351,7 +516,13 @@ void UServer_Base::str_allocate()
    { U_STRINGREP_FROM_CONSTANT("USE_TCP_OPTIMIZATION") },
    { U_STRINGREP_FROM_CONSTANT("LISTEN_BACKLOG") },
    { U_STRINGREP_FROM_CONSTANT("SET_REALTIME_PRIORITY") },
-   { U_STRINGREP_FROM_CONSTANT("ENABLE_RFC1918_FILTER") }
+   { U_STRINGREP_FROM_CONSTANT("ENABLE_RFC1918_FILTER") },
+   { U_STRINGREP_FROM_CONSTANT("ENABLE_REUSEPORT") },
+   { U_STRINGREP_FROM_CONSTANT("REQ_ARENA_SIZE") },
+   { U_STRINGREP_FROM_CONSTANT("HUGE_PAGES") },
+   { U_STRINGREP_FROM_CONSTANT("PLUGIN_TIMING") },
+   { U_STRINGREP_FROM_CONSTANT("DISK_IO_THREAD") },
+   { U_STRINGREP_FROM_CONSTANT("TIMER_TICK") }
    };
 
    U_NEW_ULIB_OBJECT(str_ENABLE_IPV6,           U_STRING_FROM_STRINGREP_STORAGE(0));
@@ -394,6 +565,12 @@ void UServer_Base::str_allocate()
    U_NEW_ULIB_OBJECT(str_LISTEN_BACKLOG,        U_STRING_FROM_STRINGREP_STORAGE(37));
    U_NEW_ULIB_OBJECT(str_SET_REALTIME_PRIORITY, U_STRING_FROM_STRINGREP_STORAGE(38));
    U_NEW_ULIB_OBJECT(str_ENABLE_RFC1918_FILTER, U_STRING_FROM_STRINGREP_STORAGE(39));
+   U_NEW_ULIB_OBJECT(str_ENABLE_REUSEPORT,      U_STRING_FROM_STRINGREP_STORAGE(40));
+   U_NEW_ULIB_OBJECT(str_REQ_ARENA_SIZE,        U_STRING_FROM_STRINGREP_STORAGE(41));
+   U_NEW_ULIB_OBJECT(str_HUGE_PAGES,            U_STRING_FROM_STRINGREP_STORAGE(42));
+   U_NEW_ULIB_OBJECT(str_PLUGIN_TIMING,         U_STRING_FROM_STRINGREP_STORAGE(43));
+   U_NEW_ULIB_OBJECT(str_DISK_IO_THREAD,        U_STRING_FROM_STRINGREP_STORAGE(44));
+   U_NEW_ULIB_OBJECT(str_TIMER_TICK,            U_STRING_FROM_STRINGREP_STORAGE(45));
 }
 
 UServer_Base::UServer_Base(UFileConfig* cfg)
@@ -417,6 +594,7 @@ UServer_Base::UServer_Base(UFileConfig* cfg)
    allow_IP      = U_NEW(UString);
    allow_IP_prv  = U_NEW(UString);
    document_root = U_NEW(UString);
+   cwd_startup   = U_NEW(UString(u_cwd, u_cwd_len)); // NB: before the chdir() to DOCUMENT_ROOT (see loadConfigParam())...
 
    if (str_ENABLE_IPV6 == 0) str_allocate();
 
@@ -516,6 +694,20 @@ UServer_Base::~UServer_Base()
 
    U_INTERNAL_ASSERT_POINTER(socket)
 
+   if (vreuseport_fd)
+      {
+      for (int i = 1; i < preforked_num_kids; ++i) (void) U_SYSCALL(close, "%d", vreuseport_fd[i]);
+
+      UMemoryPool::_free(vreuseport_fd, preforked_num_kids, sizeof(int));
+      }
+
+   if (vchild_pid) UMemoryPool::_free(vchild_pid, preforked_num_kids, sizeof(pid_t));
+
+   for (int k = 0; k < U_NUM_HOOK; ++k)
+      {
+      if (vhook[k]) UMemoryPool::_free(vhook[k], vplugin_size, sizeof(plugin_hook));
+      }
+
    delete socket;
 
 #ifndef __MINGW32__
@@ -559,6 +751,7 @@ UServer_Base::~UServer_Base()
    delete allow_IP;
    delete allow_IP_prv;
    delete document_root;
+   delete cwd_startup;
 
    UEventFd::fd = 0; // NB: to avoid delete itself...
 
@@ -589,6 +782,7 @@ void UServer_Base::loadConfigParam(UFileConfig& cfg)
    // LISTEN_BACKLOG        max number of ready to be delivered connections to accept()
    // USE_TCP_OPTIMIZATION  flag indicating the use of TCP/IP options to optimize data transmission (DEFER_ACCEPT, QUICKACK)
    // SET_REALTIME_PRIORITY flag indicating that the preforked processes will be scheduled under the real-time policies SCHED_FIFO
+   // ENABLE_REUSEPORT      flag indicating that every preforked process accept connections on its own listening socket (SO_REUSEPORT)
    //
    // PID_FILE      write pid on file indicated
    // WELCOME_MSG   message of welcome to send initially to client
@@ -601,9 +795,15 @@ void UServer_Base::loadConfigParam(UFileConfig& cfg)
    //
    // PLUGIN        list of plugins to load, a flexible way to add specific functionality to the server
    // PLUGIN_DIR    directory of plugins to load
+   // PLUGIN_TIMING measure with the time stamp counter of the cpu the latency of the connection-wide hooks of every plugin (default no)
    //
    // REQ_TIMEOUT   timeout for request from client
    // CGI_TIMEOUT   timeout for cgi execution
+   // TIMER_TICK    resolution (ms) of the wheel of the internal timer (UTimer), a coarser tick reduce the work for many alarm (default 1)
+   //
+   // REQ_ARENA_SIZE size of the area reserved for the request-scoped allocation of strings (default 0 - disabled)
+   // HUGE_PAGES     back the big memory area with huge page (yes = transparent huge page, hugetlb = MAP_HUGETLB with fallback) (default no)
+   // DISK_IO_THREAD number of threads (for every process) that read from disk the data of the file not in page cache (default 0 - disabled)
    //
    // MAX_KEEP_ALIVE Specifies the maximum number of requests that can be served through a Keep-Alive (Persistent) session.
    //                (Value <= 0 will disable Keep-Alive) (default 1020)
@@ -635,6 +835,8 @@ void UServer_Base::loadConfigParam(UFileConfig& cfg)
    cgi_timeout                = cfg.readLong(*str_CGI_TIMEOUT);
    enable_rfc1918_filter      = cfg.readBoolean(*str_ENABLE_RFC1918_FILTER);
    set_realtime_priority      = cfg.readBoolean(*str_SET_REALTIME_PRIORITY);
+   plugin_timing              = cfg.readBoolean(*str_PLUGIN_TIMING);
+   disk_io_thread             = cfg.readLong(*str_DISK_IO_THREAD);
    UNotifier::max_connection  = cfg.readLong(*str_MAX_KEEP_ALIVE);
    u_printf_string_max_length = cfg.readLong(*str_LOG_MSG_SIZE);
 
@@ -647,6 +849,10 @@ void UServer_Base::loadConfigParam(UFileConfig& cfg)
 
    if (cgi_timeout) UCommand::setTimeout(cgi_timeout);
 
+   long timer_tick = cfg.readLong(*str_TIMER_TICK);
+
+   if (timer_tick > 0) UTimer::setTick(timer_tick);
+
    UClientImage_Base::setMsgWelcome(cfg[*str_MSG_WELCOME]);
 
 #ifdef USE_LIBSSL
@@ -690,6 +896,8 @@ next:
 
    if (isPreForked()) monitoring_process = true;
 
+   enable_reuseport = cfg.readBoolean(*str_ENABLE_REUSEPORT);
+
    x = cfg[*str_USE_TCP_OPTIMIZATION];
 
    if (x.empty() == false) flag_use_tcp_optimization = x.strtob();
@@ -705,6 +913,37 @@ next:
 
    if (log_file->empty() == false) log = U_NEW(ULog(*log_file, cfg.readLong(*str_LOG_FILE_SZ), "(pid %P) %10D> "));
 
+   // huge page for the big memory area (shared data, memory pool, cache of documents, ...)
+
+   UString huge_page = cfg[*str_HUGE_PAGES];
+
+   if (huge_page.empty() == false)
+      {
+      int mode = (huge_page.equal(U_CONSTANT_TO_PARAM("hugetlb")) ? 2 : huge_page.strtob() ? 1 : 0);
+
+      if (mode)
+         {
+         UFile::setHugePage(mode);
+
+         U_SRV_LOG("Enabled huge page for the big memory area (%s)", (mode == 2 ? "MAP_HUGETLB" : "madvise(MADV_HUGEPAGE)"));
+         }
+      }
+
+   // request-scoped arena for the strings created while we process a request (see UMemoryArena)...
+
+   uint32_t arena_size = cfg.readLong(*str_REQ_ARENA_SIZE);
+
+   if (arena_size &&
+       UMemoryArena::base == 0)
+      {
+      if (UMemoryArena::init(arena_size) == false) U_WARNING("Reservation of %u bytes for the request arena FAILED", arena_size);
+      else
+         {
+         U_SRV_LOG("Reserved %u KB for the request arena (%u chunks of %u KB)", arena_size / 1024,
+                   (uint32_t)((UMemoryArena::limit - UMemoryArena::base) / U_ARENA_CHUNK_SIZE), U_ARENA_CHUNK_SIZE / 1024);
+         }
+      }
+
    // If you want the webserver to run as a process of a defined user, you can do it.
    // For the change of user to work, it's necessary to execute the server with root privileges.
    // If it's started by a user that that doesn't have root privileges, this step will be omitted.
@@ -950,6 +1189,8 @@ int UServer_Base::loadPlugins(UString& plugin_dir, const UString& plugin_list, U
 
    delete vplugin_name_static;
 
+   buildHookList();
+
    if (cfg)
       {
       // NB: we load configuration in reverse order respect to config var PLUGIN...
@@ -986,29 +1227,136 @@ end:
 
 // manage plugin handler hooks...
 
+static const char* hook_name[U_NUM_HOOK] = { "READ", "Request", "Reset" };
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#  define U_HOOK_TIMING_UNIT "cycle"
+
+static inline uint64_t u_get_hook_tick()
+{
+   uint32_t lo, hi;
+
+   __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+
+   return ((uint64_t)hi << 32) | lo;
+}
+#else
+#  define U_HOOK_TIMING_UNIT "nsec"
+
+static inline uint64_t u_get_hook_tick()
+{
+   struct timespec ts;
+
+   (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+#endif
+
+static inline void u_set_hook_stat(UServer_Base::plugin_hook_stat* pstat, uint64_t tick)
+{
+   uint32_t i = 0;
+
+   for (uint64_t x = (tick >> 8); x && i < (U_NUM_HOOK_BUCKET - 1); x >>= 1) ++i;
+
+   // NB: plain store, only this process write on its area...
+
+   pstat->count++;
+   pstat->total += tick;
+   pstat->histogram[i]++;
+
+   if (pstat->max < tick) pstat->max = tick;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wpmf-conversions"
+#endif
+
+U_NO_EXPORT void UServer_Base::buildHookList()
+{
+   U_TRACE(0, "UServer_Base::buildHookList()")
+
+   U_INTERNAL_ASSERT_POINTER(vplugin)
+   U_INTERNAL_ASSERT_MAJOR(vplugin_size, 0)
+
+   typedef int (UServerPlugIn::*hook_pmf)();
+
+   static const hook_pmf vpmf[U_NUM_HOOK] = { &UServerPlugIn::handlerREAD, &UServerPlugIn::handlerRequest, &UServerPlugIn::handlerReset };
+
+   UServerPlugIn base;
+   UServerPlugIn* _plugin;
+   uint32_t i, j, k, n;
+
+   for (k = 0; k < U_NUM_HOOK; ++k)
+      {
+      U_INTERNAL_ASSERT_EQUALS(vhook[k], 0)
+
+      vhook[k] = (plugin_hook*) UMemoryPool::_malloc(vplugin_size, sizeof(plugin_hook));
+
+      for (j = n = 0; j < vplugin_size; ++j)
+         {
+         i       = (k == U_HOOK_READ ? vplugin_size - 1 - j : j); // NB: we call handlerREAD() in reverse order respect to config var PLUGIN...
+         _plugin = vplugin->at(i);
+
+#     if defined(__GNUC__) && !defined(__clang__)
+         // NB: with the GNU extension for bound pointer to member function we get the address of the function that the virtual call
+         //     on the object would call: if it is the one of the base class the hook do nothing (U_PLUGIN_HANDLER_GO_ON) and we skip it.
+         //     With the plugins loaded as shared module the inline default hook can have more copies, and then the plugin stay on the list...
+
+         typedef int (*hook_fn)(UServerPlugIn*);
+
+         if ((hook_fn)(_plugin->*vpmf[k]) == (hook_fn)(base.*vpmf[k])) continue;
+#     endif
+
+         vhook[k][n].plugin = _plugin;
+         vhook[k][n].index  = i;
+
+         ++n;
+         }
+
+      vhook_size[k] = n;
+
+      U_INTERNAL_DUMP("vhook_size[%u] = %u", k, n)
+
+      U_SRV_LOG("Dispatch list of the hook handler%s(): %u of %u plugin", hook_name[k], n, vplugin_size);
+      }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+// NB: the connection-wide hooks are called through the dispatch list, optionally with the timing of every call (PLUGIN_TIMING)...
+
 #define U_PLUGIN_HANDLER(xxx)                                                             \
                                                                                           \
 int UServer_Base::pluginsHandler##xxx()                                                   \
 {                                                                                         \
    U_TRACE(0, "UServer_Base::pluginsHandler"#xxx"()")                                     \
                                                                                           \
-   U_INTERNAL_ASSERT_POINTER(vplugin)                                                     \
-   U_INTERNAL_ASSERT_MAJOR(vplugin_size, 0)                                               \
+   U_INTERNAL_ASSERT_POINTER(vhook[U_HOOK_##xxx])                                         \
                                                                                           \
    int result;                                                                            \
-   uint32_t i = 0;                                                                        \
-   UServerPlugIn* _plugin;                                                                \
+   uint64_t tick;                                                                         \
+   plugin_hook* ptr  = vhook[U_HOOK_##xxx];                                               \
+   plugin_hook* last = ptr + vhook_size[U_HOOK_##xxx];                                    \
                                                                                           \
-   do {                                                                                   \
-      _plugin = vplugin->at(i);                                                           \
+   for (; ptr < last; ++ptr)                                                              \
+      {                                                                                   \
+      if (isLog()) mod_name->snprintf("[%.*s] ", U_STRING_TO_TRACE(vplugin_name->at(ptr->index))); \
                                                                                           \
-      if (isLog()) mod_name->snprintf("[%.*s] ", U_STRING_TO_TRACE(vplugin_name->at(i))); \
+      if (phook_stat == 0) result = ptr->plugin->handler##xxx();                          \
+      else                                                                                \
+         {                                                                                \
+         tick   = u_get_hook_tick();                                                      \
+         result = ptr->plugin->handler##xxx();                                            \
                                                                                           \
-      result = _plugin->handler##xxx();                                                   \
+         u_set_hook_stat(phook_stat + (ptr->index * U_NUM_HOOK) + U_HOOK_##xxx, u_get_hook_tick() - tick); \
+         }                                                                                \
                                                                                           \
       if (result != U_PLUGIN_HANDLER_GO_ON) goto end;                                     \
       }                                                                                   \
-   while (++i < vplugin_size);                                                            \
                                                                                           \
    result = U_PLUGIN_HANDLER_FINISHED;                                                    \
                                                                                           \
@@ -1019,6 +1367,7 @@ end:
 }
 
 // Connection-wide hooks
+U_PLUGIN_HANDLER(READ) // NB: we call handlerREAD() in reverse order respect to config var PLUGIN...
 U_PLUGIN_HANDLER(Request)
 U_PLUGIN_HANDLER(Reset)
 
@@ -1062,15 +1411,29 @@ U_PLUGIN_HANDLER_REVERSE(Run)  // NB: we call handlerRun()  in reverse order res
 U_PLUGIN_HANDLER_REVERSE(Fork) // NB: we call handlerFork() in reverse order respect to config var PLUGIN...
 U_PLUGIN_HANDLER_REVERSE(Stop) // NB: we call handlerStop() in reverse order respect to config var PLUGIN...
 
-// Connection-wide hooks
-U_PLUGIN_HANDLER_REVERSE(READ) // NB: we call handlerREAD() in reverse order respect to config var PLUGIN...
-
 void UServer_Base::init()
 {
    U_TRACE(1, "UServer_Base::init()")
 
    U_INTERNAL_ASSERT_POINTER(socket)
 
+#if defined(HAVE_EPOLL_WAIT) && !defined(USE_LIBEVENT)
+   // NB: with the pool of preforked processes the signals (SIGHUP, SIGTERM, SIGCHLD) are delivered as readable event (signalfd)
+   //     to the event loop of the children and to the monitoring process, so they don't interrupt the system call (EINTR).
+   //     The signals must be blocked before to create any thread (ex: UTimeThread), because the mask is inherited...
+
+   if (isPreForked() &&
+       UInterrupt::initSignalFd())
+      {
+      UInterrupt::insertSignalFd( SIGHUP, (sighandler_t)UServer_Base::handlerForSigHUP);
+      UInterrupt::insertSignalFd(SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM);
+      UInterrupt::insertSignalFd(SIGCHLD, (sighandler_t)UServer_Base::handlerForSigCHLD);
+      UInterrupt::insertSignalFd(SIGUSR2, (sighandler_t)UServer_Base::handlerForSigUSR2);
+      UInterrupt::insertSignalFd(SIGQUIT, (sighandler_t)UServer_Base::handlerForSigQUIT);
+      UInterrupt::insertSignalFd(SIGWINCH,(sighandler_t)UServer_Base::handlerForSigWINCH);
+      }
+#endif
+
 #ifndef __MINGW32__
 #  ifdef USE_LIBSSL
    if (bssl == false)
@@ -1087,7 +1450,18 @@ void UServer_Base::init()
       }
 #endif
 
-   if (socket->setServer(*server, port, iBackLog) == false)
+   initUpgrade();
+
+   if (vupgrade_fd)
+      {
+      // NB: binary upgrade, the listening socket is already bound and in listen state (inherited from the old server)...
+
+      socket->iSockDesc = vupgrade_fd[0];
+      socket->iState    = USocket::LOGIN;
+
+      socket->setLocal();
+      }
+   else if (socket->setServer(*server, port, iBackLog) == false)
       {
       if (server->empty()) *server = U_STRING_FROM_CONSTANT("*");
 
@@ -1327,6 +1701,15 @@ void UServer_Base::init()
 
    U_INTERNAL_DUMP("log_shared = %b log_rotate_size = %u", log_shared, log_rotate_size)
 
+   // NB: the slot of the per-child metrics (one for every preforked child) are in the shared data, plus a cache line to align them...
+
+   ptr_child_metrics = (child_metrics*) getOffsetToDataShare((isPreForked() ? preforked_num_kids : 1) * sizeof(child_metrics) + 64);
+
+   if (plugin_timing)
+      {
+      ptr_hook_stat = (plugin_hook_stat*) getOffsetToDataShare((isPreForked() ? preforked_num_kids : 1) * vplugin_size * U_NUM_HOOK * sizeof(plugin_hook_stat) + 64);
+      }
+
    if (pluginsHandlerInit() != U_PLUGIN_HANDLER_FINISHED)
       {
       U_ERROR("Plugins initialization FAILED. Going down...");
@@ -1350,6 +1733,19 @@ void UServer_Base::init()
       U_INTERNAL_ASSERT_EQUALS(U_TOT_CONNECTION, 0)
       U_INTERNAL_ASSERT_DIFFERS(ptr_shared_data, MAP_FAILED)
 
+      ptr_child_metrics = (child_metrics*) (((ptrdiff_t)getPointerToDataShare(ptr_child_metrics) + 63) & ~63);
+      pmetrics          = ptr_child_metrics;
+
+      pmetrics->pid = u_pid;
+
+      if (ptr_hook_stat)
+         {
+         ptr_hook_stat = (plugin_hook_stat*) (((ptrdiff_t)getPointerToDataShare(ptr_hook_stat) + 63) & ~63);
+         phook_stat    = ptr_hook_stat;
+
+         U_SRV_LOG("Enabled the timing of the connection-wide hooks of the plugins (unit: %s)", U_HOOK_TIMING_UNIT);
+         }
+
       if (log_shared)
          {
          U_INTERNAL_ASSERT_POINTER(log)
@@ -1395,7 +1791,7 @@ void UServer_Base::init()
 
    // init notifier event manager...
 
-   UNotifier::min_connection = (isClassic() == false) + (handler_inotify != 0);
+   UNotifier::min_connection = (isClassic() == false) + (handler_inotify != 0) + (UInterrupt::handler_signalfd != 0);
    UNotifier::max_connection = (UNotifier::max_connection ? UNotifier::max_connection : 1020) + (UNotifier::num_connection = UNotifier::min_connection);
 
    uint32_t n = (((UNotifier::max_connection * sizeof(UClientImage_Base)) + U_PAGEMASK) & ~U_PAGEMASK) / sizeof(UClientImage_Base);
@@ -1439,6 +1835,13 @@ void UServer_Base::init()
 
    UNotifier::init(false);
 
+   if (UInterrupt::handler_signalfd)
+      {
+      UNotifier::insert(UInterrupt::handler_signalfd); // NB: we ask to be notified for signals (signalfd)
+
+      U_SRV_LOG("Signals SIGHUP, SIGTERM and SIGCHLD are delivered as readable event (signalfd)");
+      }
+
 #if defined(HAVE_PTHREAD_H) && defined(ENABLE_THREAD) && defined(HAVE_EPOLL_WAIT) && !defined(USE_LIBEVENT) && defined(U_SERVER_THREAD_APPROACH_SUPPORT)
    if (preforked_num_kids == -1) goto next; 
 #endif
@@ -1467,77 +1870,666 @@ void UServer_Base::init()
 
    if (preforked_num_kids) socket->flags |= O_NONBLOCK; // NB: for nodog it is blocking...
 
+   if (enable_reuseport)
+      {
+#  ifdef SO_REUSEPORT
+      if (isPreForked() &&
+          bipc == false)
+         {
+         initReusePort();
+         }
+      else
+#  endif
+         {
+         enable_reuseport = false;
+
+         U_SRV_LOG("The \"ENABLE_REUSEPORT\" directive makes sense only with a pool of preforked processes on TCP socket, ignored");
+         }
+      }
+
    UNotifier::insert(pthis); // NB: we ask to be notified for request of connection (=> accept)
 
 next:
+   if (vupgrade_fd)
+      {
+      // NB: the old server can have a different number of listening sockets (SO_REUSEPORT), we close the ones we don't use...
+
+      for (int i = (vreuseport_fd ? preforked_num_kids : 1); i < nupgrade_fd; ++i) (void) U_SYSCALL(close, "%d", vupgrade_fd[i]);
+
+      UMemoryPool::_free(vupgrade_fd, nupgrade_fd, sizeof(int));
+
+      vupgrade_fd = 0;
+      }
+
    (void) U_SYSCALL(fcntl, "%d,%d,%d", socket->iSockDesc, F_SETFL, socket->flags);
 }
 
-bool UServer_Base::addLog(UFile* _log, int flags)
+/* With SO_REUSEPORT the kernel distributes the incoming connections among a group of listening sockets bound to
+ * the same address, so every preforked child can accept on its own queue instead of competing (thundering herd)
+ * on the shared one. The sockets of the group are created and kept by the monitoring parent: the respawned child
+ * inherit the same socket (and the pending connections on it) of the child that it replace...
+ */
+
+U_NO_EXPORT void UServer_Base::initReusePort()
 {
-   U_TRACE(0, "UServer_Base::addLog(%p,%d)", _log, flags)
+   U_TRACE(1, "UServer_Base::initReusePort()")
 
-   U_INTERNAL_ASSERT_POINTER(vlog)
+   U_INTERNAL_ASSERT(isPreForked())
+   U_INTERNAL_ASSERT_EQUALS(vreuseport_fd, 0)
 
-   if (_log->creat(flags, PERM_FILE))
+   vreuseport_fd    = (int*) UMemoryPool::_malloc(preforked_num_kids, sizeof(int), true);
+   vreuseport_fd[0] = socket->iSockDesc; // NB: the first child use the main listening socket...
+
+   for (int i = 1; i < preforked_num_kids; ++i)
       {
-      file_LOG* item = U_NEW(file_LOG);
+      if (i < nupgrade_fd)
+         {
+         vreuseport_fd[i] = vupgrade_fd[i]; // NB: binary upgrade, the socket of the group inherited from the old server...
 
-      item->LOG   = _log;
-      item->flags = flags;
+         continue;
+         }
 
-      vlog->push_back(item);
+      USocket _socket(UClientImage_Base::bIPv6);
 
-      U_RETURN(true);
-      }
+      if (_socket.USocket::socket(SOCK_STREAM)                      == false ||
+          _socket.USocket::setServer(*server, port, iBackLog) == false)
+         {
+         U_ERROR("Run as server with local address '%.*s:%d' with SO_REUSEPORT FAILED...", U_STRING_TO_TRACE(*server), port);
+         }
 
-   U_RETURN(false);
-}
+      // NB: the same setting of the main listening socket (see init())...
 
-void UServer_Base::reopenLog()
-{
-   U_TRACE(0, "UServer_Base::reopenLog()")
+      _socket.setTcpNoDelay(1U);
 
-   file_LOG* item;
+#  ifndef __MINGW32__
+      if (flag_use_tcp_optimization)
+         {
+         _socket.setTcpFastOpen(5U);
+         _socket.setTcpDeferAccept(1U);
+         _socket.setTcpQuickAck(0U);
+         }
+#  endif
 
-   for (uint32_t i = 0, n = vlog->size(); i < n; ++i)
-      {
-      item = (*vlog)[i];
+      (void) U_SYSCALL(fcntl, "%d,%d,%d", _socket.iSockDesc, F_SETFL, socket->flags);
 
-      item->LOG->reopen(item->flags);
+      vreuseport_fd[i] = _socket.iSockDesc;
+
+      _socket.iSockDesc = -1; // NB: to avoid the close on destructor...
       }
+
+   U_SRV_LOG("Created a group of %d listening sockets with SO_REUSEPORT, one for every preforked process", preforked_num_kids);
 }
 
-U_NO_EXPORT void UServer_Base::logMemUsage(const char* signame)
+U_NO_EXPORT void UServer_Base::setReusePortChild()
 {
-   U_TRACE(0, "UServer_Base::logMemUsage(%S)", signame)
+   U_TRACE(1, "UServer_Base::setReusePortChild()")
 
-   U_INTERNAL_ASSERT(isLog())
+   U_INTERNAL_ASSERT(proc->child())
+   U_INTERNAL_ASSERT_POINTER(vreuseport_fd)
+   U_INTERNAL_ASSERT_RANGE(0,child_index,preforked_num_kids-1)
 
-   unsigned long vsz, rss;
+   // NB: we put the socket of this child on the descriptor of the main listening socket, so the event manager
+   //     and the accept() continue to work unchanged. It must happen before UNotifier::init() after fork()...
 
-   u_get_memusage(&vsz, &rss);
+   if (child_index) (void) U_SYSCALL(dup2, "%d,%d", vreuseport_fd[child_index], socket->iSockDesc);
 
-   ULog::log("%s (Interrupt): "
-             "address space usage: %.2f MBytes - "
-                       "rss usage: %.2f MBytes\n", signame,
-             (double)vsz / (1024.0 * 1024.0),
-             (double)rss / (1024.0 * 1024.0));
+   for (int i = 1; i < preforked_num_kids; ++i) (void) U_SYSCALL(close, "%d", vreuseport_fd[i]);
+
+   UMemoryPool::_free(vreuseport_fd, preforked_num_kids, sizeof(int));
+
+   vreuseport_fd = 0;
+
+   U_SRV_LOG("Child (index %d) accept connections on its own listening socket (SO_REUSEPORT)", child_index);
 }
 
-RETSIGTYPE UServer_Base::handlerForSigHUP(int signo)
+/* Binary upgrade without downtime: on SIGWINCH the process that own the listening sockets start the new binary and
+ * pass them to it by inheritance (the descriptors are listed in the environment variable USERVER_LISTEN_FD). The new
+ * server don't bind() again, so the connections pending on the listen queue are not lost, it load the configuration,
+ * init the plugins (and the file cache), start the children and then send SIGQUIT to the old server that stop to
+ * accept and exit when the connections in progress are completed (graceful stop)...
+ */
+
+U_NO_EXPORT void UServer_Base::initUpgrade()
 {
-   U_TRACE(0, "[SIGHUP] UServer_Base::handlerForSigHUP(%d)", signo)
+   U_TRACE(1, "UServer_Base::initUpgrade()")
 
-   U_INTERNAL_ASSERT_POINTER(pthis)
+   U_INTERNAL_ASSERT_EQUALS(vupgrade_fd, 0)
 
-   U_INTERNAL_ASSERT(proc->parent())
+   const char* ptr = (const char*) U_SYSCALL(getenv, "%S", "USERVER_LISTEN_FD");
 
-   // NB: for logrotate...
+   if (ptr == 0) return;
 
-   if (isLog())
-      {
-      logMemUsage("SIGHUP");
+   const char* old_pid = (const char*) U_SYSCALL(getenv, "%S", "USERVER_UPGRADE_PID");
+
+   upgrade_pid = (old_pid ? atoi(old_pid) : 0);
+   nupgrade_fd = 1;
+
+   for (const char* s = ptr; *s; ++s) if (*s == ',') ++nupgrade_fd;
+
+   vupgrade_fd = (int*) UMemoryPool::_malloc(nupgrade_fd, sizeof(int), true);
+
+   for (int i = 0; i < nupgrade_fd; ++i)
+      {
+      vupgrade_fd[i] = strtol(ptr, (char**)&ptr, 10);
+
+      if (vupgrade_fd[i] <= STDERR_FILENO) U_ERROR("Binary upgrade: invalid listening socket from environment (USERVER_LISTEN_FD). Going down...");
+
+      if (*ptr == ',') ++ptr;
+      }
+
+   // NB: the variables must not be inherited by the process that we create (ex: CGI) and by the next upgrade...
+
+   (void) U_SYSCALL(unsetenv, "%S", "USERVER_LISTEN_FD");
+   (void) U_SYSCALL(unsetenv, "%S", "USERVER_UPGRADE_PID");
+
+   U_SRV_LOG("Binary upgrade: inherited %d listening socket(s) from the old server (pid %d)", nupgrade_fd, upgrade_pid);
+}
+
+U_NO_EXPORT void UServer_Base::stopOldServer()
+{
+   U_TRACE(0, "UServer_Base::stopOldServer()")
+
+   U_INTERNAL_ASSERT_MAJOR(upgrade_pid, 0)
+
+   // NB: we are ready to accept on the inherited listening sockets, so the old server can stop gracefully...
+
+   (void) UProcess::kill(upgrade_pid, SIGQUIT);
+
+   U_SRV_LOG("Binary upgrade: sent SIGQUIT to the old server (pid %d) for a graceful stop", upgrade_pid);
+
+   upgrade_pid = 0;
+}
+
+U_NO_EXPORT void UServer_Base::execNewBinary()
+{
+   U_TRACE(1, "UServer_Base::execNewBinary()")
+
+   U_INTERNAL_ASSERT_POINTER(socket)
+
+   // NB: we rebuild the command line (arguments of main()) from /proc, so the new binary load the same configuration...
+
+   int fd = UFile::open("/proc/self/cmdline", O_RDONLY, PERM_FILE);
+
+   if (fd == -1) return;
+
+   int argc = 0;
+   char* argv[64];
+   char cmdline[4096];
+
+   ssize_t len = U_SYSCALL(read, "%d,%p,%u", fd, cmdline, sizeof(cmdline)-1);
+
+   UFile::close(fd);
+
+   if (len <= 0) return;
+
+   cmdline[len] = '\0';
+
+   for (char* ptr = cmdline, *end = cmdline + len; ptr < end && argc < 63; ptr += u__strlen(ptr, __PRETTY_FUNCTION__) + 1) argv[argc++] = ptr;
+
+   argv[argc] = 0;
+
+   char buffer[32];
+   char listen_fd[512];
+   uint32_t n = u__snprintf(listen_fd, sizeof(listen_fd), "%d", socket->iSockDesc);
+
+   if (vreuseport_fd)
+      {
+      for (int i = 1; i < preforked_num_kids; ++i) n += u__snprintf(listen_fd+n, sizeof(listen_fd)-n, ",%d", vreuseport_fd[i]);
+      }
+
+   (void) u__snprintf(buffer, sizeof(buffer), "%d", u_pid);
+
+   (void) U_SYSCALL(setenv, "%S,%S,%d", "USERVER_LISTEN_FD",   listen_fd, 1);
+   (void) U_SYSCALL(setenv, "%S,%S,%d", "USERVER_UPGRADE_PID", buffer,    1);
+
+   // NB: the new binary must inherit only the listening sockets, and it must not inherit the mask of the signals managed with signalfd...
+
+   for (int i = STDERR_FILENO + 1, max = sysconf(_SC_OPEN_MAX); i < max && i < 65536; ++i)
+      {
+      bool blisten = (i == socket->iSockDesc);
+
+      if (vreuseport_fd)
+         {
+         for (int j = 1; j < preforked_num_kids && blisten == false; ++j) blisten = (i == vreuseport_fd[j]);
+         }
+
+      if (blisten) (void) U_SYSCALL(fcntl, "%d,%d,%d", i, F_SETFD, 0);
+      else         (void)          ::close(i);
+      }
+
+   sigset_t mask;
+
+   (void) U_SYSCALL(sigemptyset, "%p", &mask);
+   (void) U_SYSCALL(sigprocmask, "%d,%p,%p", SIG_SETMASK, &mask, 0);
+
+   // NB: the path of the binary (argv[0]) can be relative to the working directory of the start...
+
+   (void) UFile::chdir(cwd_startup->c_str(), false);
+
+   U_EXEC(u_progpath, argv, environ);
+}
+
+U_NO_EXPORT void UServer_Base::drainConnection()
+{
+   U_TRACE(1, "UServer_Base::drainConnection()")
+
+   U_INTERNAL_ASSERT_POINTER(socket)
+   U_INTERNAL_ASSERT_EQUALS(flag_drain, false)
+
+   flag_drain = true;
+
+   // NB: we stop to accept new connection, the listening socket can be shared with the new server so we must not call shutdown()
+   //     and we must remove it from the epoll set (the registration is removed only when all the descriptors of the socket are closed)...
+
+   if (pthis->UEventFd::fd)
+      {
+      if (isClassic() == false)
+         {
+#     if defined(HAVE_EPOLL_WAIT) && !defined(USE_LIBEVENT)
+         if (UNotifier::epollfd > 0) (void) U_SYSCALL(epoll_ctl, "%d,%d,%d,%p", UNotifier::epollfd, EPOLL_CTL_DEL, pthis->UEventFd::fd, (struct epoll_event*)1);
+#     endif
+
+         UNotifier::erase(pthis);
+
+         --UNotifier::num_connection;
+         --UNotifier::min_connection;
+         }
+
+      (void) U_SYSCALL(close, "%d", socket->iSockDesc);
+
+      socket->iSockDesc   = -1;
+      pthis->UEventFd::fd = 0;
+      }
+
+   // NB: we close the connections that are waiting for a new request (keep-alive), the others are closed after the response...
+
+   UClientImage_Base* next;
+   uint32_t nclose = 0, nwait = 0;
+
+   for (UClientImage_Base* item = UClientImage_Base::first_idle; item; item = next)
+      {
+      next = item->next_idle;
+
+      if (item->isPendingWrite()) ++nwait;
+      else
+         {
+         ++nclose;
+
+         UNotifier::erase((UEventFd*)item);
+         }
+      }
+
+   U_SRV_LOG("Graceful stop: stopped to accept, closed %u idle connection, waiting for %u connection in progress", nclose, nwait);
+}
+
+RETSIGTYPE UServer_Base::handlerForSigWINCH(int signo)
+{
+   U_TRACE(0, "[SIGWINCH] UServer_Base::handlerForSigWINCH(%d)", signo)
+
+   U_INTERNAL_ASSERT_POINTER(proc)
+
+   if (proc->child()) return; // NB: only the process that own the listening sockets can start the new binary...
+
+   // NB: the memory mapped log (LOG_FILE_SZ) can't be shared by two servers, the old one truncate the file when it go down...
+
+   if (bipc       ||
+       flag_drain ||
+       preforked_num_kids < 0 ||
+       (isLog() && ULog::isMemoryMapped()))
+      {
+      U_SRV_LOG("SIGWINCH (Interrupt): binary upgrade not available (thread approach, UNIX domain socket, memory mapped log or graceful stop in progress), ignored");
+
+      return;
+      }
+
+   if (isLog()) ULog::log("SIGWINCH (Interrupt): binary upgrade, starting the new binary %S\n", u_progpath);
+
+   // NB: double fork, the new server must not be our child (the monitoring process respawn and wait the children) and it must
+   //     not be in our process group (the SIGTERM that we send to the process group when we go down must not reach it)...
+
+   pid_t pid_first = U_FORK();
+
+   if (pid_first == 0)
+      {
+      (void) U_SYSCALL_NO_PARAM(setsid);
+
+      if (U_FORK() == 0) execNewBinary();
+
+      ::_exit(0);
+      }
+
+   if (pid_first > 0) (void) UProcess::waitpid(pid_first, 0, 0);
+}
+
+RETSIGTYPE UServer_Base::handlerForSigQUIT(int signo)
+{
+   U_TRACE(0, "[SIGQUIT] UServer_Base::handlerForSigQUIT(%d)", signo)
+
+   U_INTERNAL_ASSERT_POINTER(proc)
+
+   if (preforked_num_kids < 0) // NB: thread approach, the event loop threads share the listening socket...
+      {
+      handlerForSigTERM(signo);
+
+      return;
+      }
+
+   if (isLog()) logMemUsage("SIGQUIT");
+
+   if (monitoring_process &&
+       proc->parent())
+      {
+      // NB: the monitoring process don't respawn the children anymore, it forward the signal to every preforked child
+      //     (not to the process group, we can have CGI process there) and it exit when all the children are exited...
+
+      flag_loop = false;
+
+      if (vchild_pid)
+         {
+         for (int i = 0; i < preforked_num_kids; ++i)
+            {
+            if (vchild_pid[i]) UProcess::kill(vchild_pid[i], SIGQUIT);
+            }
+         }
+
+      return;
+      }
+
+   if (flag_drain == false) drainConnection();
+}
+
+bool UServer_Base::addLog(UFile* _log, int flags)
+{
+   U_TRACE(0, "UServer_Base::addLog(%p,%d)", _log, flags)
+
+   U_INTERNAL_ASSERT_POINTER(vlog)
+
+   if (_log->creat(flags, PERM_FILE))
+      {
+      file_LOG* item = U_NEW(file_LOG);
+
+      item->LOG   = _log;
+      item->flags = flags;
+
+      vlog->push_back(item);
+
+      U_RETURN(true);
+      }
+
+   U_RETURN(false);
+}
+
+void UServer_Base::reopenLog()
+{
+   U_TRACE(0, "UServer_Base::reopenLog()")
+
+   file_LOG* item;
+
+   for (uint32_t i = 0, n = vlog->size(); i < n; ++i)
+      {
+      item = (*vlog)[i];
+
+      item->LOG->reopen(item->flags);
+      }
+}
+
+U_NO_EXPORT void UServer_Base::logMemUsage(const char* signame)
+{
+   U_TRACE(0, "UServer_Base::logMemUsage(%S)", signame)
+
+   U_INTERNAL_ASSERT(isLog())
+
+   unsigned long vsz, rss;
+
+   u_get_memusage(&vsz, &rss);
+
+   ULog::log("%s (Interrupt): "
+             "address space usage: %.2f MBytes - "
+                       "rss usage: %.2f MBytes\n", signame,
+             (double)vsz / (1024.0 * 1024.0),
+             (double)rss / (1024.0 * 1024.0));
+}
+
+U_NO_EXPORT void UServer_Base::logMemoryArena()
+{
+   U_TRACE(0, "UServer_Base::logMemoryArena()")
+
+   U_INTERNAL_ASSERT(isLog())
+
+   if (UMemoryArena::num_request) // NB: the monitoring process don't process request...
+      {
+      char buffer[256];
+
+      (void) UMemoryArena::writeInfo(buffer, sizeof(buffer));
+
+      U_SRV_LOG("%s", buffer);
+      }
+}
+
+U_NO_EXPORT void UServer_Base::logMemoryPool(const char* signame)
+{
+   U_TRACE(0, "UServer_Base::logMemoryPool(%S)", signame)
+
+   U_INTERNAL_ASSERT(isLog())
+
+   char buffer[2048];
+
+   uint32_t n = UMemoryPool::writeInfo(buffer, sizeof(buffer));
+
+   if (UFile::huge_page)
+      {
+      n += UFile::writeHugePageInfo(buffer + n, sizeof(buffer) - n);
+
+      buffer[n++] = '\n';
+      }
+
+   ULog::log("%s (Interrupt): memory pool statistics\n%.*s", signame, n, buffer);
+}
+
+RETSIGTYPE UServer_Base::handlerForSigUSR2(int signo)
+{
+   U_TRACE(0, "[SIGUSR2] UServer_Base::handlerForSigUSR2(%d)", signo)
+
+   // NB: dump of the statistics of the memory pool (to size the 'type' stack and to spot leak under real traffic)...
+
+   if (isLog()) logMemoryPool("SIGUSR2");
+
+   U_INTERNAL_ASSERT_POINTER(proc)
+
+   // NB: the monitoring process forward the signal to every preforked child (not to the process group, we can have CGI process there)...
+
+   if (proc->parent() &&
+       vchild_pid)
+      {
+      for (int i = 0; i < preforked_num_kids; ++i)
+         {
+         if (vchild_pid[i]) UProcess::kill(vchild_pid[i], SIGUSR2);
+         }
+      }
+}
+
+// per-child metrics
+
+static inline uint64_t u_get_monotonic_usec()
+{
+#ifdef HAVE_CLOCK_GETTIME
+   struct timespec ts;
+
+   (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ((uint64_t)ts.tv_sec * 1000000ULL) + (ts.tv_nsec / 1000L);
+#else
+   struct timeval tv;
+
+   (void) gettimeofday(&tv, 0);
+
+   return ((uint64_t)tv.tv_sec * 1000000ULL) + tv.tv_usec;
+#endif
+}
+
+uint64_t UServer_Base::metricsRequestBegin()
+{
+   U_TRACE(0, "UServer_Base::metricsRequestBegin()")
+
+   uint64_t start = u_get_monotonic_usec();
+
+   U_RETURN(start);
+}
+
+void UServer_Base::metricsRequestEnd(uint64_t start, uint32_t code, uint32_t bytes_in, uint32_t bytes_out, bool bkeep_alive)
+{
+   U_TRACE(0, "UServer_Base::metricsRequestEnd(%llu,%u,%u,%u,%b)", start, code, bytes_in, bytes_out, bkeep_alive)
+
+   U_INTERNAL_ASSERT_POINTER(pmetrics)
+
+   uint32_t i    = 0;
+   uint64_t usec = u_get_monotonic_usec() - start;
+
+   U_INTERNAL_DUMP("usec = %llu", usec)
+
+   while (usec > 1 &&
+          i < (U_NUM_LATENCY_BUCKET - 1))
+      {
+      usec >>= 1;
+
+      ++i;
+      }
+
+   // NB: plain store, only this process write on its slot...
+
+   pmetrics->num_request++;
+   pmetrics->latency[i]++;
+   pmetrics->bytes_in  += bytes_in;
+   pmetrics->bytes_out += bytes_out;
+
+   if (bkeep_alive) pmetrics->num_keep_alive++; // NB: the connection was already used (keep-alive or pipeline)...
+
+   code /= 100;
+
+   if (code >= 1 &&
+       code <= 5)
+      {
+      pmetrics->status[code-1]++;
+      }
+}
+
+void UServer_Base::writeMetrics(UString& buffer)
+{
+   U_TRACE(0, "UServer_Base::writeMetrics(%p)", &buffer)
+
+   if (ptr_child_metrics == 0) return;
+
+   // NB: the other process write their slot while we read it, but every counter is a aligned word of 64 bit,
+   //     so we read a coherent value (maybe not the last one) and the sum is good enough for monitoring...
+
+   int i, j, nslot = (isPreForked() ? preforked_num_kids : 1);
+   child_metrics total, *ptr;
+
+   (void) U_SYSCALL(memset, "%p,%d,%u", &total, 0, sizeof(child_metrics));
+
+   for (i = 0; i < nslot; ++i)
+      {
+      ptr = ptr_child_metrics + i;
+
+      total.num_request    += ptr->num_request;
+      total.num_keep_alive += ptr->num_keep_alive;
+      total.bytes_in       += ptr->bytes_in;
+      total.bytes_out      += ptr->bytes_out;
+      total.cache_hit      += ptr->cache_hit;
+      total.cache_miss     += ptr->cache_miss;
+
+      for (j = 0; j < 5;                    ++j) total.status[j]  += ptr->status[j];
+      for (j = 0; j < U_NUM_LATENCY_BUCKET; ++j) total.latency[j] += ptr->latency[j];
+
+      // NB: the size of the output depend on the number of child and of plugin, so we make room before every line...
+
+      (void) buffer.reserve(buffer.size() + 200U);
+
+      buffer.snprintf_add("child[%d]: pid %ld request %llu keep_alive %llu bytes_in %llu bytes_out %llu\n",
+                          i, ptr->pid, ptr->num_request, ptr->num_keep_alive, ptr->bytes_in, ptr->bytes_out);
+      }
+
+   (void) buffer.reserve(buffer.size() + 500U + U_NUM_LATENCY_BUCKET * 50U);
+
+   buffer.snprintf_add("request: %llu\n"
+                       "keep_alive: %llu\n"
+                       "bytes_in: %llu\n"
+                       "bytes_out: %llu\n"
+                       "cache_hit: %llu\n"
+                       "cache_miss: %llu\n"
+                       "status_1xx: %llu\n"
+                       "status_2xx: %llu\n"
+                       "status_3xx: %llu\n"
+                       "status_4xx: %llu\n"
+                       "status_5xx: %llu\n",
+                       total.num_request, total.num_keep_alive, total.bytes_in, total.bytes_out, total.cache_hit, total.cache_miss,
+                       total.status[0], total.status[1], total.status[2], total.status[3], total.status[4]);
+
+   // NB: latency_usec_lt_N is the number of request served in less than N microsecond (and at least N/2)...
+
+   for (j = 0; j < (U_NUM_LATENCY_BUCKET - 1); ++j) buffer.snprintf_add("latency_usec_lt_%u: %llu\n", 2U << j, total.latency[j]);
+
+   buffer.snprintf_add("latency_usec_ge_%u: %llu\n", 1U << j, total.latency[j]);
+
+   if (ptr_hook_stat)
+      {
+      uint32_t k;
+      plugin_hook_stat hook, *pstat;
+
+      for (uint32_t m = 0; m < vplugin_size; ++m)
+         {
+         for (k = 0; k < U_NUM_HOOK; ++k)
+            {
+            (void) U_SYSCALL(memset, "%p,%d,%u", &hook, 0, sizeof(plugin_hook_stat));
+
+            for (i = 0; i < nslot; ++i)
+               {
+               pstat = ptr_hook_stat + ((i * vplugin_size + m) * U_NUM_HOOK) + k;
+
+               hook.count += pstat->count;
+               hook.total += pstat->total;
+
+               if (hook.max < pstat->max) hook.max = pstat->max;
+
+               for (j = 0; j < U_NUM_HOOK_BUCKET; ++j) hook.histogram[j] += pstat->histogram[j];
+               }
+
+            if (hook.count == 0) continue;
+
+            (void) buffer.reserve(buffer.size() + 2U * vplugin_name->at(m).size() + 200U + U_NUM_HOOK_BUCKET * 50U);
+
+            buffer.snprintf_add("hook[%.*s:%s]: count %llu total %llu max %llu avg %llu (%s)\n",
+                                U_STRING_TO_TRACE(vplugin_name->at(m)), hook_name[k],
+                                hook.count, hook.total, hook.max, hook.total / hook.count, U_HOOK_TIMING_UNIT);
+
+            buffer.snprintf_add("hook_histogram[%.*s:%s]:", U_STRING_TO_TRACE(vplugin_name->at(m)), hook_name[k]);
+
+            for (j = 0; j < (U_NUM_HOOK_BUCKET - 1); ++j)
+               {
+               if (hook.histogram[j]) buffer.snprintf_add(" lt_%llu %llu", 1ULL << (j + 8), hook.histogram[j]);
+               }
+
+            if (hook.histogram[j]) buffer.snprintf_add(" ge_%llu %llu", 1ULL << (j + 7), hook.histogram[j]);
+
+            buffer.push_back('\n');
+            }
+         }
+      }
+}
+
+RETSIGTYPE UServer_Base::handlerForSigHUP(int signo)
+{
+   U_TRACE(0, "[SIGHUP] UServer_Base::handlerForSigHUP(%d)", signo)
+
+   U_INTERNAL_ASSERT_POINTER(pthis)
+
+   U_INTERNAL_ASSERT(proc->parent())
+
+   // NB: for logrotate...
+
+   if (isLog())
+      {
+      logMemUsage("SIGHUP");
 
       ULog::reopen();
       }
@@ -1552,16 +2544,25 @@ RETSIGTYPE UServer_Base::handlerForSigHUP(int signo)
 
    pthis->handlerSignal(); // manage before regenering preforked pool of children...
 
-   // NB: we can't use UInterrupt::erase() because it restore the old action (UInterrupt::init)...
-   UInterrupt::setHandlerForSignal(SIGTERM, (sighandler_t)SIG_IGN);
+   if (UInterrupt::handler_signalfd)
+      {
+      sendSigTERM();
 
-   sendSigTERM();
+      UInterrupt::discardSignal(SIGTERM); // NB: SIGTERM is blocked, and the instance sent to ourselves is pending...
+      }
+   else
+      {
+      // NB: we can't use UInterrupt::erase() because it restore the old action (UInterrupt::init)...
+      UInterrupt::setHandlerForSignal(SIGTERM, (sighandler_t)SIG_IGN);
 
-#ifdef USE_LIBEVENT
-   UInterrupt::setHandlerForSignal(SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); //  sync signal
-#else
-   UInterrupt::insert(             SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); // async signal
-#endif
+      sendSigTERM();
+
+#  ifdef USE_LIBEVENT
+      UInterrupt::setHandlerForSignal(SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); //  sync signal
+#  else
+      UInterrupt::insert(             SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); // async signal
+#  endif
+      }
 
    if (isPreForked()) U_TOT_CONNECTION = 0;
 
@@ -1580,13 +2581,27 @@ RETSIGTYPE UServer_Base::handlerForSigHUP(int signo)
 #endif
 }
 
+RETSIGTYPE UServer_Base::handlerForSigCHLD(int signo)
+{
+   U_TRACE(0, "[SIGCHLD] UServer_Base::handlerForSigCHLD(%d)", signo)
+
+   // NB: with signalfd we are notified of the exit of a child, the monitoring process reap it with waitpid()...
+
+   U_INTERNAL_ASSERT_POINTER(proc)
+   U_INTERNAL_ASSERT(proc->parent())
+}
+
 RETSIGTYPE UServer_Base::handlerForSigTERM(int signo)
 {
    U_TRACE(0, "[SIGTERM] UServer_Base::handlerForSigTERM(%d)", signo)
 
    flag_loop = false;
 
-   if (isLog()) logMemUsage("SIGTERM");
+   if (isLog())
+      {
+      logMemUsage("SIGTERM");
+      logMemoryArena();
+      }
 
    U_INTERNAL_ASSERT_POINTER(proc)
 
@@ -1597,6 +2612,8 @@ RETSIGTYPE UServer_Base::handlerForSigTERM(int signo)
 
       sendSigTERM();
 
+      if (UInterrupt::handler_signalfd) UInterrupt::discardSignal(SIGTERM); // NB: SIGTERM is blocked, and the instance sent to ourselves is pending...
+
 #  if defined(HAVE_PTHREAD_H) && defined(ENABLE_THREAD)
       if (u_pthread_time) ((UTimeThread*)u_pthread_time)->suspend();
 #  endif
@@ -1607,7 +2624,8 @@ RETSIGTYPE UServer_Base::handlerForSigTERM(int signo)
       (void) UDispatcher::exit(0);
 #  endif
 
-      UInterrupt::erase(SIGTERM); // async signal
+      if (UInterrupt::handler_signalfd) UInterrupt::eraseSignalFd(SIGTERM); // signalfd
+      else                              UInterrupt::erase(SIGTERM);         // async signal
 
 #  ifdef DEBUG
       if (UObjectDB::fd > 0) U_WRITE_MEM_POOL_INFO_TO("mempool.%N.%P.sigTERM", 0) // to get the value to based WiAuth portal
@@ -1632,6 +2650,8 @@ int UServer_Base::handlerRead() // This method is called to accept a new connect
 {
    U_TRACE(1, "UServer_Base::handlerRead()")
 
+   if (flag_drain) U_RETURN(U_NOTIFIER_OK); // NB: graceful stop, event already collected for the listening socket that we have closed...
+
 #ifdef U_HTTP_CACHE_REQUEST
    uint32_t counter = 0;
 #endif
@@ -1930,13 +2950,9 @@ bool UServer_Base::handlerTimeoutConnection(void* cimg)
 
    if (cimg)
       {
-      U_INTERNAL_DUMP("pthis = %p handler_inotify = %p ", pthis, handler_inotify)
+      // NB: only the connection on the list of idle connection arrive here (see UClientImage_Base::setLastEvent())...
 
-      if (cimg == pthis ||
-          cimg == handler_inotify)
-         {
-         U_RETURN(false);
-         }
+      U_INTERNAL_ASSERT_RANGE(vClientImage, (UClientImage_Base*)cimg, eClientImage)
 
       from_handlerTime = true;
       }
@@ -1994,7 +3010,28 @@ int UServer_Base::UTimeoutConnection::handlerTime()
          }
 #  endif
 
-      UNotifier::callForAllEntryDynamic(handlerTimeoutConnection);
+      // NB: the list of idle connection is ordered by last_event, so we stop at the first connection not expired...
+
+      U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
+
+      uint32_t n = 0;
+      UClientImage_Base* item;
+
+      while ((item = UClientImage_Base::first_idle) &&
+             (u_now->tv_sec - item->last_event) >= ptime->UTimeVal::tv_sec)
+         {
+         (void) handlerTimeoutConnection(item);
+
+         UNotifier::erase((UEventFd*)item);
+
+         U_INTERNAL_ASSERT_DIFFERS(item, UClientImage_Base::first_idle)
+
+         ++n;
+         }
+
+      U_INTERNAL_DUMP("n = %u", n)
+
+      if (n) U_SRV_LOG("handlerTime: closed %u idle connection(s) (timeout), %u clients still connected", n, UNotifier::num_connection - UNotifier::min_connection);
       }
 
    // ---------------
@@ -2007,6 +3044,154 @@ int UServer_Base::UTimeoutConnection::handlerTime()
    U_RETURN(0);
 }
 
+// DISK_IO_THREAD
+
+U_NO_EXPORT void UServer_Base::initDiskIO()
+{
+   U_TRACE(1, "UServer_Base::initDiskIO()")
+
+   U_INTERNAL_ASSERT_MAJOR(disk_io_thread, 0)
+   U_INTERNAL_ASSERT_EQUALS(handler_disk_io, 0)
+
+#ifdef U_DISK_IO_SUPPORT
+   // NB: the threads are started by every process in the loop (after the fork), the connection that wait for the read is
+   //     without event of write, so we need the notifier with a set of event (epoll) and sendfile() (no SSL)...
+
+   if (bssl                      ||
+       isClassic()               ||
+       preforked_num_kids < 0)
+      {
+      U_SRV_LOG("DISK_IO_THREAD is not available with SSL, the classic model and the thread approach");
+
+      return;
+      }
+
+   int fd = U_SYSCALL(eventfd, "%u,%d", 0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+   if (fd == -1) return;
+
+   handler_disk_io = U_NEW(UDiskIOFd);
+
+   handler_disk_io->fd = fd;
+
+   UNotifier::insert(handler_disk_io);
+
+   ++UNotifier::min_connection;
+   ++UNotifier::num_connection;
+
+   UDiskIOThread* th;
+
+   for (int i = 0; i < disk_io_thread; ++i)
+      {
+      th = U_NEW(UDiskIOThread);
+
+      (void) th->start(0);
+      }
+
+   U_SRV_LOG("Started %d threads of disk I/O for the data of the file not in page cache (window %u KB)", disk_io_thread, U_DISK_IO_WINDOW / 1024);
+#else
+   U_SRV_LOG("Sorry, I was compiled without support for the threads of disk I/O so I can't accept DISK_IO_THREAD");
+#endif
+}
+
+bool UServer_Base::isDataNotResident(int fd, uint32_t offset, uint32_t count)
+{
+   U_TRACE(1, "UServer_Base::isDataNotResident(%d,%u,%u)", fd, offset, count)
+
+   U_INTERNAL_ASSERT_MAJOR(count, 0)
+
+#ifdef U_DISK_IO_SUPPORT
+   char c;
+   struct iovec iov = { &c, 1 };
+
+   // NB: with RWF_NOWAIT the read fail with EAGAIN if the page is not in page cache (it don't wait for the disk). We check the first
+   //     and the last page of the segment, the first is often read by the readahead of a previous read (or page fault) but not the rest...
+
+   if (count > U_DISK_IO_WINDOW) count = U_DISK_IO_WINDOW;
+
+   if ((U_SYSCALL(preadv2, "%d,%p,%d,%u,%d", fd, &iov, 1, offset,             RWF_NOWAIT) == -1 && errno == EAGAIN) ||
+       (U_SYSCALL(preadv2, "%d,%p,%d,%u,%d", fd, &iov, 1, offset + count - 1, RWF_NOWAIT) == -1 && errno == EAGAIN))
+      {
+      U_RETURN(true);
+      }
+#endif
+
+   U_RETURN(false);
+}
+
+bool UServer_Base::readDataAsync(UClientImage_Base* pclient, uint32_t count)
+{
+   U_TRACE(1, "UServer_Base::readDataAsync(%p,%u)", pclient, count)
+
+   U_INTERNAL_ASSERT_POINTER(pclient)
+   U_INTERNAL_ASSERT_POINTER(handler_disk_io)
+
+#ifdef U_DISK_IO_SUPPORT
+   bool result = false;
+
+   (void) U_SYSCALL(pthread_mutex_lock, "%p", &UDiskIOThread::mutex);
+
+   if (UDiskIOThread::njob < U_DISK_IO_QUEUE) // NB: otherwise the sendfile() of the event loop wait for the disk...
+      {
+      disk_io_job* job = UDiskIOThread::vreq + (UDiskIOThread::rhead++ & (U_DISK_IO_QUEUE-1));
+
+      job->pclient = pclient;
+      job->gen     = ++(pclient->disk_io_gen);
+      job->fd      = pclient->sfd;
+      job->start   = pclient->start;
+      job->count   = count;
+
+      ++UDiskIOThread::njob;
+
+      (void) U_SYSCALL(pthread_cond_signal, "%p", &UDiskIOThread::cond);
+
+      result = true;
+      }
+
+   (void) U_SYSCALL(pthread_mutex_unlock, "%p", &UDiskIOThread::mutex);
+
+   U_RETURN(result);
+#else
+   U_RETURN(false);
+#endif
+}
+
+void UServer_Base::handlerDiskIO()
+{
+   U_TRACE(0, "UServer_Base::handlerDiskIO()")
+
+#ifdef U_DISK_IO_SUPPORT
+   disk_io_job* job;
+   UClientImage_Base* pclient;
+
+   (void) U_SYSCALL(pthread_mutex_lock, "%p", &UDiskIOThread::mutex);
+
+   while (UDiskIOThread::dtail != UDiskIOThread::dhead)
+      {
+      job     = UDiskIOThread::vdone + (UDiskIOThread::dtail++ & (U_DISK_IO_QUEUE-1));
+      pclient = job->pclient;
+
+      --UDiskIOThread::njob;
+
+      U_INTERNAL_DUMP("job->gen = %u pclient->disk_io_gen = %u pclient->op_mask = %B", job->gen, pclient->disk_io_gen, pclient->UEventFd::op_mask)
+
+      // NB: if the connection is closed (or the object reused) while the thread was reading we have nothing to do...
+
+      if (job->gen == pclient->disk_io_gen &&
+          pclient->UEventFd::op_mask == 0)
+         {
+         U_ASSERT(pclient->isPendingWrite())
+
+         pclient->UEventFd::op_mask = U_WRITE_OUT; // NB: the socket is (probably) writable, so we have soon the event...
+
+         UNotifier::modify(pclient);
+         }
+      }
+
+   (void) U_SYSCALL(pthread_mutex_unlock, "%p", &UDiskIOThread::mutex);
+#endif
+}
+
 void UServer_Base::runLoop(const char* user)
 {
    U_TRACE(0, "UServer_Base::runLoop(%S)", user)
@@ -2023,6 +3208,20 @@ void UServer_Base::runLoop(const char* user)
       }
 #endif
 
+   if (disk_io_thread > 0) initDiskIO();
+
+   // NB: the preforked processes wait always with UNotifier::waitForEvent(), so the expire of the internal timer (UTimer) can be
+   //     delivered as readable event (timerfd) instead of SIGALRM. Otherwise (or without timerfd) we keep setitimer()...
+
+   if (isPreForked() &&
+       UTimer::initTimerFd())
+      {
+      ++UNotifier::min_connection;
+      ++UNotifier::num_connection;
+
+      U_SRV_LOG("The expire of the internal timer are delivered as readable event (timerfd)");
+      }
+
    if (isLog()) ULog::log("Waiting for connection\n");
 
 #if defined(HAVE_PTHREAD_H) && defined(ENABLE_THREAD) && defined(HAVE_EPOLL_WAIT) && !defined(USE_LIBEVENT) && defined(U_SERVER_THREAD_APPROACH_SUPPORT)
@@ -2040,6 +3239,14 @@ void UServer_Base::runLoop(const char* user)
          continue;
          }
 
+      if (flag_drain &&
+          UNotifier::num_connection <= UNotifier::min_connection)
+         {
+         U_SRV_LOG("Graceful stop: no more connection in progress, exiting");
+
+         break;
+         }
+
 #  if defined(HAVE_PTHREAD_H) && defined(ENABLE_THREAD) && defined(HAVE_EPOLL_WAIT) && !defined(USE_LIBEVENT) && defined(U_SERVER_THREAD_APPROACH_SUPPORT)
       if (preforked_num_kids == -1) goto next;
 #  endif
@@ -2126,9 +3333,18 @@ void UServer_Base::run()
 #ifdef USE_LIBEVENT
    UInterrupt::setHandlerForSignal( SIGHUP, (sighandler_t)UServer_Base::handlerForSigHUP);  //  sync signal
    UInterrupt::setHandlerForSignal(SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); //  sync signal
+   UInterrupt::setHandlerForSignal(SIGUSR2, (sighandler_t)UServer_Base::handlerForSigUSR2); //  sync signal
+   UInterrupt::setHandlerForSignal(SIGQUIT, (sighandler_t)UServer_Base::handlerForSigQUIT); //  sync signal
+   UInterrupt::setHandlerForSignal(SIGWINCH,(sighandler_t)UServer_Base::handlerForSigWINCH);//  sync signal
 #else
-   UInterrupt::insert(              SIGHUP, (sighandler_t)UServer_Base::handlerForSigHUP);  // async signal
-   UInterrupt::insert(             SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); // async signal
+   if (UInterrupt::handler_signalfd == 0) // NB: otherwise the signals are delivered as readable event (signalfd), see init()...
+      {
+      UInterrupt::insert(              SIGHUP, (sighandler_t)UServer_Base::handlerForSigHUP);  // async signal
+      UInterrupt::insert(             SIGTERM, (sighandler_t)UServer_Base::handlerForSigTERM); // async signal
+      UInterrupt::insert(             SIGUSR2, (sighandler_t)UServer_Base::handlerForSigUSR2); // async signal
+      UInterrupt::insert(             SIGQUIT, (sighandler_t)UServer_Base::handlerForSigQUIT); // async signal
+      UInterrupt::insert(            SIGWINCH, (sighandler_t)UServer_Base::handlerForSigWINCH);// async signal
+      }
 #endif
 
    const char* user = (as_user->empty() ? 0 : as_user->data());
@@ -2140,7 +3356,12 @@ void UServer_Base::run()
    //                                                                    >1 - pool of process serialize plus monitoring process
    // -------------------------------------------------------------------------------------------------------------------------
 
-   if (monitoring_process == false) runLoop(user);
+   if (monitoring_process == false)
+      {
+      if (upgrade_pid) stopOldServer();
+
+      runLoop(user);
+      }
    else
       {
       /**
@@ -2165,6 +3386,11 @@ void UServer_Base::run()
 
       U_INTERNAL_DUMP("nkids = %d baffinity = %b", nkids, baffinity)
 
+      // NB: we keep track of the slot of every preforked child, so that we can give to the respawned child
+      //     the same cpu and the same listening socket (SO_REUSEPORT) of the child that it replace...
+
+      if (isPreForked()) vchild_pid = (pid_t*) UMemoryPool::_malloc(preforked_num_kids, sizeof(pid_t), true);
+
 #  if defined(ENABLE_MEMPOOL) && !defined(__MINGW32__) && !defined(ENABLE_THREAD)
    // U_WRITE_MEM_POOL_INFO_TO("mempool.%N.%P.beforeFork", 0) // to get the value to based nodog
 #  endif
@@ -2175,6 +3401,13 @@ void UServer_Base::run()
 
          while (i < nkids)
             {
+            if (vchild_pid)
+               {
+               for (child_index = 0; vchild_pid[child_index]; ++child_index) {} // NB: we search for a free slot...
+
+               U_INTERNAL_ASSERT_MINOR(child_index, preforked_num_kids)
+               }
+
             if (proc->fork() &&
                 proc->parent())
                {
@@ -2187,7 +3420,21 @@ void UServer_Base::run()
 
                cpu_set_t cpuset;
 
-               if (baffinity) u_bind2cpu(pid, i); // Pin the process to a particular core...
+               if (vchild_pid)
+                  {
+                  vchild_pid[child_index] = pid;
+
+                  if (baffinity)
+                     {
+                     u_bind2cpu(pid, child_index); // Pin the process to a particular core...
+
+                     if (vreuseport_fd) USocket::setIncomingCPU(vreuseport_fd[child_index], child_index);
+                     }
+                  }
+               else if (baffinity)
+                  {
+                  u_bind2cpu(pid, i); // Pin the process to a particular core...
+                  }
 
                CPU_ZERO(&cpuset);
 
@@ -2239,8 +3486,42 @@ void UServer_Base::run()
                   u_never_need_group();
                   }
 
+               if (vreuseport_fd) setReusePortChild();
+
+               // NB: the metrics of a respawned child go on to accumulate in the slot of the child that it replace...
+
+               pmetrics      = ptr_child_metrics + child_index;
+               pmetrics->pid = u_pid;
+
+               if (ptr_hook_stat) phook_stat = ptr_hook_stat + (child_index * vplugin_size * U_NUM_HOOK);
+
+               if (UInterrupt::handler_signalfd)
+                  {
+                  // NB: SIGHUP, SIGCHLD and SIGWINCH are managed only by the monitoring process, and we must change the mask
+                  //     of signalfd before UNotifier::init() because it register again all the event on a new epoll...
+
+                  UInterrupt::setHandlerForSignal(SIGHUP, (sighandler_t)SIG_IGN);
+
+                  UInterrupt::eraseSignalFd(SIGHUP);
+                  UInterrupt::eraseSignalFd(SIGCHLD);
+                  UInterrupt::eraseSignalFd(SIGWINCH);
+                  }
+
                UNotifier::init(true);
 
+               if (handler_inotify &&
+                   child_index)
+                  {
+                  // NB: only the child of the first slot read the event of the file system (inotify), the others apply the change
+                  //     that it publish in the shared data (the instance of inotify is the same, one event go only to one reader)...
+
+                  UNotifier::erase(handler_inotify);
+
+                  --UNotifier::min_connection;
+
+                  handler_inotify = 0;
+                  }
+
                if (isLog()) ULog::setAsChild();
 
                // NB: we can't use UInterrupt::erase() because it restore the old action (UInterrupt::init)...
@@ -2261,11 +3542,23 @@ void UServer_Base::run()
             to_sleep.nanosleep();
             }
 
+         if (upgrade_pid) stopOldServer(); // NB: binary upgrade, all the children are started...
+
          /* wait for any children to exit, and then start some more */
 
          u_dont_need_root();
 
-         pid = UProcess::waitpid(pid_to_wait, &status, 0);
+         if (UInterrupt::handler_signalfd == 0) pid = UProcess::waitpid(pid_to_wait, &status, 0);
+         else
+            {
+            // NB: SIGCHLD, SIGHUP and SIGTERM are read from signalfd, so we wait for them without blocking on waitpid()...
+
+            while ((pid = UProcess::waitpid(pid_to_wait, &status, WNOHANG)) == 0 &&
+                   flag_loop)
+               {
+               UInterrupt::waitForSignalFd();
+               }
+            }
 
          if (pid > 0 &&
              flag_loop) // check for SIGTERM event...
@@ -2274,7 +3567,22 @@ void UServer_Base::run()
 
             --i;
 
-            baffinity = false;
+            if (vchild_pid)
+               {
+               for (int j = 0; j < preforked_num_kids; ++j)
+                  {
+                  if (vchild_pid[j] == pid)
+                     {
+                     vchild_pid[j] = 0;
+
+                     break;
+                     }
+                  }
+               }
+            else
+               {
+               baffinity = false;
+               }
 
             U_INTERNAL_DUMP("down to %u children", i)
 
@@ -2408,6 +3716,9 @@ const char* UServer_Base::dump(bool reset) const
                   << "verify_mode               " << verify_mode                << '\n'
                   << "shared_data_add           " << shared_data_add            << '\n'
                   << "ptr_shared_data           " << (void*)ptr_shared_data     << '\n'
+                  << "ptr_child_metrics         " << (void*)ptr_child_metrics   << '\n'
+                  << "child_index               " << child_index                << '\n'
+                  << "enable_reuseport          " << enable_reuseport           << '\n'
                   << "preforked_num_kids        " << preforked_num_kids         << '\n'
                   << "flag_use_tcp_optimization " << flag_use_tcp_optimization  << '\n'
                   << "log           (ULog       " << (void*)log                 << ")\n"
@@ -25,6 +25,9 @@ STARTUPINFO          UProcess::aStartupInfo;
 PROCESS_INFORMATION  UProcess::aProcessInformation;
 #else
 #  include <sys/wait.h>
+#  ifdef HAVE_SPAWN_H
+#     include <spawn.h>
+#  endif
 #endif
 
 #include <errno.h>
@@ -454,10 +457,107 @@ pid_t UProcess::execute(const char* pathname, char* argv[], char* envp[], bool f
    U_DUMP_EXEC(argv, envp)
    U_INTERNAL_ASSERT_EQUALS(strcmp(u_basename(pathname), argv[0]),0)
 
+#ifdef HAVE_SPAWN_H
+   /* NB: with posix_spawn() (glibc use clone(CLONE_VM|CLONE_VFORK) on a separate stack) we don't copy the page tables of the
+    *     parent and, unlike vfork(), the child don't execute our code before the exec: the redirection of stdin/stdout/stderr
+    *     are spawn file actions (the same of setStdInOutErr()) and the failure of the exec is the return value...
+    */
+
+   pid_t pid;
+   int i, result;
+   sigset_t mask;
+   posix_spawnattr_t attr;
+   posix_spawn_file_actions_t actions;
+
+   (void) U_SYSCALL(posix_spawnattr_init,          "%p", &attr);
+   (void) U_SYSCALL(posix_spawn_file_actions_init, "%p", &actions);
+
+   if (UInterrupt::fd_signal)
+      {
+      // NB: the signal managed with signalfd are blocked, and the signal mask is inherited across execve()...
+
+      (void) U_SYSCALL(sigprocmask, "%d,%p,%p", SIG_BLOCK, 0, &mask);
+
+      for (i = 1; i < NSIG; ++i)
+         {
+         if (sigismember(&UInterrupt::mask_signalfd, i) == 1) (void) sigdelset(&mask, i);
+         }
+
+      (void) U_SYSCALL(posix_spawnattr_setsigmask, "%p,%p", &attr, &mask);
+      (void) U_SYSCALL(posix_spawnattr_setflags,   "%p,%d", &attr, POSIX_SPAWN_SETSIGMASK);
+      }
+
+   if (fd_stdin)
+      {
+      U_INTERNAL_ASSERT_MAJOR(filedes[0],STDERR_FILENO)
+
+      (void) U_SYSCALL(posix_spawn_file_actions_adddup2, "%p,%d,%d", &actions, filedes[0], STDIN_FILENO);
+      }
+
+   if (fd_stdout)
+      {
+      U_INTERNAL_ASSERT_MAJOR(filedes[3],STDOUT_FILENO)
+
+      (void) U_SYSCALL(posix_spawn_file_actions_adddup2, "%p,%d,%d", &actions, filedes[3], STDOUT_FILENO);
+      }
+
+   if (fd_stderr)
+      {
+      U_INTERNAL_ASSERT(filedes[5] >= STDOUT_FILENO)
+
+      (void) U_SYSCALL(posix_spawn_file_actions_adddup2, "%p,%d,%d", &actions, filedes[5], STDERR_FILENO);
+      }
+
+   if (fd_stdin)
+      {
+      U_INTERNAL_DUMP("filedes[0,1] = { %d, %d }", filedes[0], filedes[1])
+
+                                      (void) U_SYSCALL(posix_spawn_file_actions_addclose, "%p,%d", &actions, filedes[0]);
+      if (filedes[1] > STDERR_FILENO) (void) U_SYSCALL(posix_spawn_file_actions_addclose, "%p,%d", &actions, filedes[1]);
+      }
+
+   if (fd_stdout)
+      {
+      U_INTERNAL_DUMP("filedes[2,3] = { %d, %d }", filedes[2], filedes[3])
+
+                                      (void) U_SYSCALL(posix_spawn_file_actions_addclose, "%p,%d", &actions, filedes[3]);
+      if (filedes[2] > STDERR_FILENO) (void) U_SYSCALL(posix_spawn_file_actions_addclose, "%p,%d", &actions, filedes[2]);
+      }
+
+   if (fd_stderr)
+      {
+      U_INTERNAL_DUMP("filedes[4,5] = { %d, %d }", filedes[4], filedes[5])
+
+      if (filedes[5] > STDERR_FILENO) (void) U_SYSCALL(posix_spawn_file_actions_addclose, "%p,%d", &actions, filedes[5]);
+      if (filedes[4] > STDERR_FILENO) (void) U_SYSCALL(posix_spawn_file_actions_addclose, "%p,%d", &actions, filedes[4]);
+      }
+
+   result = U_SYSCALL(posix_spawn, "%p,%S,%p,%p,%p,%p", &pid, pathname, &actions, &attr, argv, envp);
+
+   (void) U_SYSCALL(posix_spawn_file_actions_destroy, "%p", &actions);
+   (void) U_SYSCALL(posix_spawnattr_destroy,          "%p", &attr);
+
+   u_exec_failed = (result != 0);
+
+   if (u_exec_failed)
+      {
+      errno = result;
+
+      U_WARNING("posix_spawn(%S,%p,%p) = %d%R", pathname, argv, envp, result, NULL);
+
+      U_RETURN(-1);
+      }
+
+   U_RETURN(pid);
+#else
    pid_t pid = U_VFORK();
 
    if (pid == 0) // child
       {
+      // NB: the signal managed with signalfd are blocked, and the signal mask is inherited across execve()...
+
+      if (UInterrupt::fd_signal) (void) U_SYSCALL(sigprocmask, "%d,%p,%p", SIG_UNBLOCK, &UInterrupt::mask_signalfd, 0);
+
       setStdInOutErr(fd_stdin, fd_stdout, fd_stderr);
 
       U_EXEC(pathname, argv, envp);
@@ -468,6 +568,7 @@ pid_t UProcess::execute(const char* pathname, char* argv[], char* envp[], bool f
    if (u_exec_failed) U_RETURN(-1);
 
    U_RETURN(pid);
+#endif
 }
 
 #endif
@@ -97,6 +97,19 @@ UStringRep* UStringRep::create(uint32_t length, uint32_t capacity, const char* p
 
    // NB: we don't use new (ctor) because we want an allocation with more space for string data...
 
+   if (UMemoryArena::active &&
+       capacity <= U_CAPACITY)
+      {
+      r = (UStringRep*) UMemoryArena::allocate(capacity + (1 + sizeof(UStringRep)));
+
+      if (r)
+         {
+         _ptr = (char*)(r + 1);
+
+         goto next; // NB: request-scoped allocation, see UMemoryArena...
+         }
+      }
+
 #if !defined(ENABLE_MEMPOOL) || !defined(__linux__)
       r = (UStringRep*) U_SYSCALL(malloc, "%u", capacity + (1 + sizeof(UStringRep)));
    _ptr = (char*)(r + 1);
@@ -171,6 +184,7 @@ UStringRep* UStringRep::create(uint32_t length, uint32_t capacity, const char* p
       }
 #endif
 
+next:
 #ifdef DEBUG
    U_SET_LOCATION_INFO;
    U_REGISTER_OBJECT_PTR(0,UStringRep,r)
@@ -260,6 +274,13 @@ void UStringRep::release()
 #  endif
 #endif
 
+   if (UMemoryArena::isArena(this))
+      {
+      UMemoryArena::release(this); // NB: the memory come back to the arena with the death of the last string of the chunk...
+
+      return;
+      }
+
 #if !defined(ENABLE_MEMPOOL) || !defined(__linux__)
    U_SYSCALL_VOID(free, "%p", (void*)this);
 #else
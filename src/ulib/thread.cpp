@@ -183,6 +183,8 @@ void UThread::threadCleanup(UThread* th)
    U_TRACE(0, "UThread::threadCleanup(%p)", th)
 
    th->close();
+
+   UMemoryPool::flushThreadCache(); // NB: we give back the blocks of the magazines of the thread...
 }
 
 void UThread::yield()
@@ -412,6 +414,8 @@ void UThread::execHandler(UThread* th)
    pthread_cleanup_pop(0);
 
    th->close();
+
+   UMemoryPool::flushThreadCache(); // NB: we give back the blocks of the magazines of the thread...
 }
 
 bool UThread::start(uint32_t timeoutMS)
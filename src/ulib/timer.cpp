@@ -12,13 +12,78 @@
 // ============================================================================
 
 #include <ulib/timer.h>
+#include <ulib/notifier.h>
 #include <ulib/utility/interrupt.h>
 
+#ifdef HAVE_TIMERFD_CREATE
+#  include <sys/timerfd.h>
+
+class U_NO_EXPORT UTimerFd : public UEventFd {
+public:
+
+   // Allocator e Deallocator
+   U_MEMORY_ALLOCATOR
+   U_MEMORY_DEALLOCATOR
+
+   // COSTRUTTORI
+
+   UTimerFd()
+      {
+      U_TRACE_REGISTER_OBJECT(0, UTimerFd, "")
+      }
+
+   virtual ~UTimerFd()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, UTimerFd)
+      }
+
+   // define method VIRTUAL of class UEventFd
+
+   virtual int handlerRead()
+      {
+      U_TRACE(0, "UTimerFd::handlerRead()")
+
+      uint64_t expirations;
+
+      // NB: all the alarm expired since the last read are managed in one pass...
+
+      if (U_SYSCALL(read, "%d,%p,%u", UEventFd::fd, &expirations, sizeof(uint64_t)) == (ssize_t)sizeof(uint64_t)) UTimer::setTimer(true);
+
+      U_RETURN(U_NOTIFIER_OK);
+      }
+
+   virtual void handlerDelete()
+      {
+      U_TRACE(0, "UTimerFd::handlerDelete()")
+
+      UEventFd::fd = 0; // NB: the object is owned by UTimer...
+      }
+
+private:
+   UTimerFd(const UTimerFd&) : UEventFd() {}
+   UTimerFd& operator=(const UTimerFd&)   { return *this; }
+};
+#endif
+
 bool             UTimer::async;
+bool             UTimer::brun;
 UTimer*          UTimer::pool;
-UTimer*          UTimer::first;
+UTimer*          UTimer::pending;
+UTimer*          UTimer::wheel[U_TIMER_WHEEL_SIZE];
+UTimer*          UTimer::wheel2[U_TIMER_WHEEL_SIZE];
+time_t           UTimer::start;
+UEventFd*        UTimer::handler_timerfd;
+uint32_t         UTimer::num;
+uint32_t         UTimer::num2;
+uint32_t         UTimer::tick = U_TIMER_TICK;
+uint32_t         UTimer::armed;
+uint32_t         UTimer::current;
 struct itimerval UTimer::timerval;
 
+// NB: the tick counter can wrap, so the comparison must be done on the difference...
+
+#define U_TICK_BEFORE_OR_EQUAL(a,b) ((int32_t)((a) - (b)) <= 0)
+
 UTimer::~UTimer()
 {
    U_TRACE_UNREGISTER_OBJECT(0, UTimer)
@@ -27,7 +92,6 @@ UTimer::~UTimer()
 
    U_INTERNAL_DUMP("next = %p, alarm = %p", next, alarm)
 
-   if (next)  delete next;
    if (alarm) delete alarm;
 }
 
@@ -41,8 +105,11 @@ void UTimer::init(bool _async)
       U_ERROR("UTimer::init: system date not updated. Going down...");
       }
 
-   if ((async = _async)) UInterrupt::insert(             SIGALRM, (sighandler_t)UTimer::handlerAlarm); // async signal
-   else                  UInterrupt::setHandlerForSignal(SIGALRM, (sighandler_t)UTimer::handlerAlarm);
+   // NB: with timerfd the expire are delivered by the event loop, the handler are never called from the signal...
+
+   if (handler_timerfd) async = false;
+   else if ((async = _async)) UInterrupt::insert(             SIGALRM, (sighandler_t)UTimer::handlerAlarm); // async signal
+   else                       UInterrupt::setHandlerForSignal(SIGALRM, (sighandler_t)UTimer::handlerAlarm);
 
 #ifdef USE_LIBEVENT
    if (u_ev_base == 0) u_ev_base = (struct event_base*) U_SYSCALL_NO_PARAM(event_init);
@@ -51,14 +118,147 @@ void UTimer::init(bool _async)
 #endif
 }
 
+/* With timerfd the expire of the alarm is a readable event for UNotifier: the handler are called from the event loop (so
+ * they can use new/delete) and the loop is never interrupted by SIGALRM. NB: it make sense only if the process wait for
+ * event with UNotifier::waitForEvent()...
+ */
+
+bool UTimer::initTimerFd()
+{
+   U_TRACE(1, "UTimer::initTimerFd()")
+
+#ifdef HAVE_TIMERFD_CREATE
+   if (handler_timerfd) U_RETURN(true);
+
+   int fd = U_SYSCALL(timerfd_create, "%d,%d", CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+   if (fd != -1)
+      {
+      async = false;
+
+      // NB: the alarm already armed with setitimer() (es: inserted by a plugin in handlerFork()) pass to the timerfd...
+
+      struct itimerval it = { { 0L, 0L }, { 0L, 0L } };
+
+      (void) U_SYSCALL(setitimer, "%d,%p,%p", ITIMER_REAL, &it, &timerval); // NB: we get the remaining time...
+
+      handler_timerfd = U_NEW(UTimerFd);
+
+      handler_timerfd->fd = fd;
+
+      UNotifier::insert(handler_timerfd);
+
+      if (isRunning()) setTimerVal();
+
+      U_RETURN(true);
+      }
+#endif
+
+   U_RETURN(false);
+}
+
+U_NO_EXPORT void UTimer::setTimerVal()
+{
+   U_TRACE(1, "UTimer::setTimerVal()")
+
+   U_INTERNAL_DUMP("timerval.it_value = { %ld %6ld }", timerval.it_value.tv_sec, timerval.it_value.tv_usec)
+
+#ifdef HAVE_TIMERFD_CREATE
+   if (handler_timerfd)
+      {
+      struct itimerspec its = { { 0L, 0L }, { timerval.it_value.tv_sec, timerval.it_value.tv_usec * 1000L } };
+
+      (void) U_SYSCALL(timerfd_settime, "%d,%d,%p,%p", handler_timerfd->fd, 0, &its, 0);
+
+      return;
+      }
+#endif
+
+   (void) U_SYSCALL(setitimer, "%d,%p,%p", ITIMER_REAL, &timerval, 0);
+}
+
+void UTimer::setTick(long ms)
+{
+   U_TRACE(0, "UTimer::setTick(%ld)", ms)
+
+   U_INTERNAL_ASSERT_MAJOR(ms, 0)
+   U_INTERNAL_ASSERT_EQUALS(num, 0)
+
+   if (num == 0) tick = ms; // NB: the expire in the wheel are in tick...
+}
+
 void UTimer::stop()
 {
-   U_TRACE(1, "UTimer::stop()")
+   U_TRACE(0, "UTimer::stop()")
+
+   armed = 0;
 
    timerval.it_value.tv_sec  = 0;
    timerval.it_value.tv_usec = 0;
 
-   (void) U_SYSCALL(setitimer, "%d,%p,%p", ITIMER_REAL, &timerval, 0);
+   setTimerVal();
+}
+
+U_NO_EXPORT void UTimer::linkEntry()
+{
+   U_TRACE(0, "UTimer::linkEntry()")
+
+   // NB: in the first level there are only the expire of the next turn of the wheel, so a slot has only the expire of its tick...
+
+   if ((expire - current) < U_TIMER_WHEEL_SIZE)
+      {
+      level2 = false;
+
+      link(wheel + (expire & U_TIMER_WHEEL_MASK));
+      }
+   else
+      {
+      level2 = true;
+
+      link(wheel2 + ((expire >> U_TIMER_WHEEL_BITS) & U_TIMER_WHEEL_MASK));
+
+      ++num2;
+      }
+
+   U_INTERNAL_DUMP("expire = %u current = %u level2 = %b", expire, current, level2)
+}
+
+U_NO_EXPORT void UTimer::unlinkEntry()
+{
+   U_TRACE(0, "UTimer::unlinkEntry()")
+
+   if (level2)
+      {
+      level2 = false;
+
+      --num2;
+      }
+
+   unlink();
+}
+
+U_NO_EXPORT void UTimer::cascade(uint32_t _tick)
+{
+   U_TRACE(0, "UTimer::cascade(%u)", _tick)
+
+   U_INTERNAL_ASSERT_EQUALS(_tick & U_TIMER_WHEEL_MASK, 0)
+
+   // si spostano nel primo livello le scadenze del blocco in cui entra il tick corrente (quelle dei giri successivi del secondo livello restano nello slot)...
+
+   UTimer* item;
+   UTimer* _next;
+   uint32_t block = (_tick >> U_TIMER_WHEEL_BITS);
+
+   for (item = wheel2[block & U_TIMER_WHEEL_MASK]; item; item = _next)
+      {
+      _next = item->next;
+
+      if ((item->expire >> U_TIMER_WHEEL_BITS) == block)
+         {
+         item->unlinkEntry();
+         item->linkEntry();
+         }
+      }
 }
 
 U_NO_EXPORT void UTimer::insertEntry()
@@ -69,19 +269,32 @@ U_NO_EXPORT void UTimer::insertEntry()
 
    alarm->setCurrentTime();
 
-   UTimer** ptr = &first;
+   if (start == 0) start = u_now->tv_sec; // origine del conteggio dei tick
 
-   while (*ptr)
-      {
-      if (*this < **ptr) break;
+   // NB: con la ruota vuota si riallinea il tick corrente (durante l'elaborazione delle scadenze e' gia' allineato)...
 
-      ptr = &(*ptr)->next;
+   if (num  == 0 &&
+       brun == false)
+      {
+      current = getTick();
       }
 
-   next = *ptr;
-   *ptr = this;
+   // ------------------------------------------------------------------------------------------------------------
+   // si converte la scadenza assoluta in tick arrotondando al tick piu' vicino: come per UEventTime::isExpired() si
+   // accetta di scadere in anticipo (al massimo mezzo tick) per non accumulare ritardo sugli allarmi di monitoraggio...
+   // ------------------------------------------------------------------------------------------------------------
+
+   uint64_t usec = (uint64_t)(alarm->ctime.tv_sec  + alarm->tv_sec - start) * 1000000ULL +
+                             (alarm->ctime.tv_usec + alarm->tv_usec),
+            utick = (uint64_t)tick * 1000ULL;
+
+   expire = (uint32_t)((usec + utick / 2) / utick);
+
+   if (U_TICK_BEFORE_OR_EQUAL(expire, current)) expire = current + 1;
 
-   U_INTERNAL_DUMP("timer = %O", U_OBJECT_TO_TRACE(*first))
+   linkEntry();
+
+   ++num;
 
    U_ASSERT(invariant())
 }
@@ -90,7 +303,7 @@ inline void UTimer::callHandlerTime()
 {
    U_TRACE(0, "UTimer::callHandlerTime()")
 
-   U_INTERNAL_DUMP("u_now = %#9D (next alarm expire) = %#9D", u_now->tv_sec, (next ? next->alarm->expire() : u_now->tv_sec))
+   U_INTERNAL_DUMP("u_now = %#9D (alarm expire) = %#9D", u_now->tv_sec, alarm->expire())
 
    int result = alarm->handlerTime(); // chiama il gestore dell'evento scadenza temporale
 
@@ -102,9 +315,11 @@ inline void UTimer::callHandlerTime()
    //  0 - monitoring
    // ---------------
 
-   if (result == 0) insertEntry(); // monitoraggio: si aggiunge il nodo alla lista con la scadenza aggiornata al nuovo tempo assoluto...
+   if (result == 0) insertEntry(); // monitoraggio: si aggiunge il nodo alla ruota con la scadenza aggiornata al nuovo tempo assoluto...
    else
       {
+      alarm->ptimer = 0;
+
       // per rientranza gestione memoria si evita new e/o delete nella gestione del segnale SIGALRM
 
       if (async)
@@ -131,46 +346,174 @@ RETSIGTYPE UTimer::handlerAlarm(int signo)
    setTimer(true);
 }
 
+U_NO_EXPORT void UTimer::setNextTick()
+{
+   U_TRACE(0, "UTimer::setNextTick()")
+
+   U_INTERNAL_DUMP("num = %u current = %u", num, current)
+
+   if (num == 0)
+      {
+      armed = 0;
+
+      timerval.it_value.tv_sec = timerval.it_value.tv_usec = 0L;
+
+      return;
+      }
+
+   UTimer* item;
+   uint32_t k, block;
+
+   armed = 0;
+
+   // primo livello: le scadenze sono tutte nel giro corrente della ruota, il primo slot non vuoto e' la prossima scadenza...
+
+   if (num > num2)
+      {
+      for (k = 1; k <= U_TIMER_WHEEL_SIZE; ++k)
+         {
+         if (wheel[(current + k) & U_TIMER_WHEEL_MASK])
+            {
+            armed = current + k;
+
+            break;
+            }
+         }
+
+      U_INTERNAL_ASSERT_MAJOR(armed, 0)
+      }
+
+   if (num2 == 0) goto next;
+
+   // secondo livello: si cerca il minimo nel primo blocco con una scadenza (se precede quella del primo livello)...
+
+   for (k = 1; k <= U_TIMER_WHEEL_SIZE; ++k)
+      {
+      block = (current >> U_TIMER_WHEEL_BITS) + k;
+
+      if (armed &&
+          U_TICK_BEFORE_OR_EQUAL(armed, block << U_TIMER_WHEEL_BITS))
+         {
+         goto next;
+         }
+
+      bool bfound = false;
+
+      for (item = wheel2[block & U_TIMER_WHEEL_MASK]; item; item = item->next)
+         {
+         if ((item->expire >> U_TIMER_WHEEL_BITS) == block &&
+             (armed == 0 || U_TICK_BEFORE_OR_EQUAL(armed, item->expire) == false))
+            {
+            armed  = item->expire;
+            bfound = true;
+            }
+         }
+
+      if (bfound) goto next;
+      }
+
+   // tutte le scadenze del secondo livello sono oltre un giro della ruota (raro): si cerca il minimo...
+
+   for (k = 0; k < U_TIMER_WHEEL_SIZE; ++k)
+      {
+      for (item = wheel2[k]; item; item = item->next)
+         {
+         if (armed == 0 || U_TICK_BEFORE_OR_EQUAL(armed, item->expire) == false) armed = item->expire;
+         }
+      }
+
+next:
+   int64_t utick = (int64_t)tick * 1000LL,
+           usec  = (int32_t)(armed - getTick()) * utick - ((int64_t)(u_now->tv_sec - start) * 1000000LL + u_now->tv_usec) % utick;
+
+   if (usec <= 0) usec = 1; // NB: un valore nullo disarma il timer...
+
+   timerval.it_value.tv_sec  = (long)(usec / 1000000LL);
+   timerval.it_value.tv_usec = (long)(usec % 1000000LL);
+
+   U_INTERNAL_DUMP("armed = %u", armed)
+}
+
 void UTimer::setTimer(bool bsignal)
 {
    U_TRACE(1, "UTimer::setTimer(%b)", bsignal)
 
-   bool expired;
-   UTimer* item;
-   UTimer** ptr = &first;
+   // NB: chiamata rientrante da un gestore di scadenza, sara' la chiamata piu' esterna a riprogrammare il timer...
+
+   if (brun) return;
+
+   brun = true;
 
    (void) U_SYSCALL(gettimeofday, "%p,%p", u_now, 0);
 
    U_INTERNAL_DUMP("u_now = { %ld %6ld }", u_now->tv_sec, u_now->tv_usec)
 
-   while ((item = *ptr))
+   // NB: from the signal (or the timerfd) we accept the alarm that expire in less than one millisecond (as UEventTime::isExpired()),
+   //     otherwise (es: from insert()) only the alarm of the tick completely elapsed (as UEventTime::isOld())...
+
+   uint32_t now = (bsignal ? getTick(1) : getTick() - 1);
+
+   U_INTERNAL_DUMP("now = %u current = %u num = %u", now, current, num)
+
+   if (num &&
+       U_TICK_BEFORE_OR_EQUAL(now, current) == false)
       {
-      expired = (bsignal ? item->alarm->isExpired()
-                         : item->alarm->isOld());
+      UTimer* item;
+      uint32_t slot;
 
-      if (expired)
+      while (current != now)
          {
-         *ptr = item->next; // toglie il nodo scaduto dalla lista...
+         // NB: con il primo livello vuoto si salta alla fine del blocco, la prossima scadenza e' almeno nel blocco successivo...
 
-         item->callHandlerTime();
+         if (num == num2)
+            {
+            if (num2 == 0 ||
+                U_TICK_BEFORE_OR_EQUAL(now, current | U_TIMER_WHEEL_MASK))
+               {
+               current = now;
 
-         ptr = &first;
+               break;
+               }
 
-         continue;
-         }
+            current |= U_TIMER_WHEEL_MASK;
+            }
+
+         slot = (++current & U_TIMER_WHEEL_MASK);
+
+         if (slot == 0 &&
+             num2)
+            {
+            cascade(current);
+            }
+
+         if (wheel[slot] == 0) continue;
+
+         // si sposta lo slot nella lista pending: i gestori possono inserire o cancellare (anche nello stesso slot)...
+
+         pending        = wheel[slot];
+         pending->prev  = &pending;
+         wheel[slot]    = 0;
+
+         while ((item = pending))
+            {
+            U_INTERNAL_ASSERT_EQUALS(item->expire, current)
 
-      item->alarm->setTimerVal(&timerval.it_value);
+            item->unlink();
 
-      goto set_itimer;
+            --num;
+
+            item->callHandlerTime();
+            }
+         }
       }
 
-   timerval.it_value.tv_sec = timerval.it_value.tv_usec = 0L;
+   brun = false;
 
-set_itimer: // NB: can happen that setitimer() produce immediatly a signal because the interval is too short (< 10ms)... 
+   setNextTick();
 
-   U_INTERNAL_DUMP("timerval.it_value = { %ld %6ld }", timerval.it_value.tv_sec, timerval.it_value.tv_usec)
+   // NB: can happen that setitimer() produce immediatly a signal because the interval is too short (< 10ms)... 
 
-   (void) U_SYSCALL(setitimer, "%d,%p,%p", ITIMER_REAL, &timerval, 0);
+   setTimerVal();
 }
 
 void UTimer::insert(UEventTime* a, bool set_timer)
@@ -179,6 +522,7 @@ void UTimer::insert(UEventTime* a, bool set_timer)
 
    // NB: non si puo' riutilizzare uno stesso oggetto gia' inserito nel timer...
 
+   U_INTERNAL_ASSERT_EQUALS(a->ptimer,0)
    U_INTERNAL_ASSERT_EQUALS(a->ctime.tv_sec,0)
    U_INTERNAL_ASSERT_EQUALS(a->ctime.tv_usec,0)
 
@@ -203,84 +547,159 @@ void UTimer::insert(UEventTime* a, bool set_timer)
       }
 
    item->alarm = a;
+      a->ptimer = item;
 
-   // NB: si mette il nodo in ordine nella lista con la scadenza settata al tempo assoluto...
+   // NB: si mette il nodo nello slot della ruota con la scadenza settata al tempo assoluto...
 
    item->insertEntry();
 
-   if (set_timer) setTimer(false);
+   // NB: si riprogramma il timer solo se la nuova scadenza precede quella armata...
+
+   if (set_timer &&
+       (armed == 0 || U_TICK_BEFORE_OR_EQUAL(armed, item->expire) == false))
+      {
+      setTimer(false);
+      }
 }
 
 void UTimer::erase(UEventTime* a, bool flag_reuse, bool set_timer)
 {
    U_TRACE(0, "UTimer::erase(%O,%b,%b)", U_OBJECT_TO_TRACE(*a), flag_reuse, set_timer)
 
-   U_INTERNAL_ASSERT_POINTER(first)
+   bool barmed = false;
+   UTimer* item = a->ptimer;
 
-   UTimer* item;
+   // NB: il nodo puo' essere fuori dalla ruota se la cancellazione avviene dal gestore della scadenza stessa...
 
-   for (UTimer** ptr = &first; (item = *ptr); ptr = &(*ptr)->next)
+   if (item &&
+       item->prev)
       {
-      if (item->alarm == a)
-         {
-         U_INTERNAL_DUMP("alarm = %O", U_OBJECT_TO_TRACE(*item->alarm))
+      U_INTERNAL_ASSERT_EQUALS(item->alarm, a)
 
-         *ptr = item->next; // lo si toglie dalla lista scadenze...
+      U_INTERNAL_DUMP("alarm = %O", U_OBJECT_TO_TRACE(*item->alarm))
 
-         U_ASSERT(invariant())
+      if (item->expire == armed) barmed = true;
 
-         // e lo si mette nella lista degli item da riutilizzare...
+      item->unlinkEntry(); // lo si toglie dalla ruota delle scadenze...
 
-         if (flag_reuse)
-            {
-            item->next = pool;
-            pool       = item;
+      --num;
 
-            delete item->alarm;
-                   item->alarm = 0;
+      a->ptimer = 0;
 
-            U_INTERNAL_DUMP("pool = %O", U_OBJECT_TO_TRACE(*pool))
-            }
-         else
+      U_ASSERT(invariant())
+
+      // e lo si mette nella lista degli item da riutilizzare...
+
+      if (flag_reuse)
+         {
+         item->next = pool;
+         pool       = item;
+
+         delete item->alarm;
+                item->alarm = 0;
+
+         U_INTERNAL_DUMP("pool = %O", U_OBJECT_TO_TRACE(*pool))
+         }
+      else
+         {
+         item->alarm = 0;
+
+         delete item;
+         }
+      }
+
+   // NB: se la scadenza cancellata era quella armata (e non ce ne sono altre nello stesso tick) si riprogramma il timer,
+   //     altrimenti arriverebbe un segnale senza niente da fare...
+
+   if (set_timer &&
+       brun == false)
+      {
+      if (num == 0) stop();
+      else if (barmed)
+         {
+         for (item = wheel[armed & U_TIMER_WHEEL_MASK]; item; item = item->next)
             {
-            item->next  = 0;
-            item->alarm = 0;
+            if (item->expire == armed) return;
+            }
 
-            delete item;
+         for (item = wheel2[(armed >> U_TIMER_WHEEL_BITS) & U_TIMER_WHEEL_MASK]; item; item = item->next)
+            {
+            if (item->expire == armed) return;
             }
 
-         break;
+         setTimer(false);
          }
       }
+}
+
+U_NO_EXPORT void UTimer::deleteList(UTimer* item, bool clean_alarm)
+{
+   U_TRACE(0, "UTimer::deleteList(%p,%b)", item, clean_alarm)
 
-   if (set_timer) setTimer(false);
+   UTimer* _next;
+
+   for (; item; item = _next)
+      {
+      _next = item->next;
+
+      if (item->alarm)
+         {
+         item->alarm->ptimer = 0;
+
+         if (clean_alarm) item->alarm = 0;
+         }
+
+      delete item;
+      }
 }
 
 void UTimer::clear(bool clean_alarm)
 {
    U_TRACE(0, "UTimer::clear(%b)", clean_alarm)
 
-   U_INTERNAL_DUMP("first = %p pool = %p", first, pool)
+   U_INTERNAL_DUMP("num = %u pool = %p", num, pool)
 
-   UTimer* item = first;
-
-   if (first)
+   if (num)
       {
-      if (clean_alarm) do { item->alarm = 0; } while ((item = item->next));
+      for (uint32_t k = 0; k < U_TIMER_WHEEL_SIZE; ++k)
+         {
+         if (wheel[k])
+            {
+            deleteList(wheel[k], clean_alarm);
+                       wheel[k] = 0;
+            }
+
+         if (wheel2[k])
+            {
+            deleteList(wheel2[k], clean_alarm);
+                       wheel2[k] = 0;
+            }
+         }
 
-      delete first;
-             first = 0;
+      num = num2 = 0;
       }
 
    if (pool)
       {
-      item = pool;
+      deleteList(pool, clean_alarm);
+                 pool = 0;
+      }
+}
 
-      if (clean_alarm) do { item->alarm = 0; } while ((item = item->next));
+bool UTimer::isHandler(UEventTime* _alarm)
+{
+   U_TRACE(0, "UTimer::isHandler(%p)", _alarm)
+
+   UTimer* item = _alarm->ptimer;
 
-      delete pool;
-             pool = 0;
+   if (item        &&
+       item->prev  &&
+       item->alarm == _alarm)
+      {
+      U_RETURN(true);
       }
+
+   U_RETURN(false);
 }
 
 // STREAM
@@ -314,14 +733,39 @@ bool UTimer::invariant()
 {
    U_TRACE(0, "UTimer::invariant()")
 
-   if (first)
+   // NB: with many thousands of timer a complete check at every insert is too expensive...
+
+   if (num > U_TIMER_WHEEL_SIZE) U_RETURN(true);
+
+   uint32_t n = 0, n2 = 0;
+
+   for (uint32_t k = 0; k < U_TIMER_WHEEL_SIZE; ++k)
       {
-      for (UTimer* item = first; item->next; item = item->next)
+      for (UTimer** ptr = wheel + k; *ptr; ptr = &(*ptr)->next)
+         {
+         ++n;
+
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->prev, ptr)
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->level2, false)
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->expire & U_TIMER_WHEEL_MASK, k)
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->alarm->ptimer, *ptr)
+         }
+
+      for (UTimer** ptr = wheel2 + k; *ptr; ptr = &(*ptr)->next)
          {
-         U_INTERNAL_ASSERT(*item <= *(item->next))
+         ++n2;
+
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->prev, ptr)
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->level2, true)
+         U_INTERNAL_ASSERT_EQUALS(((*ptr)->expire >> U_TIMER_WHEEL_BITS) & U_TIMER_WHEEL_MASK, k)
+         U_INTERNAL_ASSERT_EQUALS((*ptr)->alarm->ptimer, *ptr)
          }
       }
 
+   U_INTERNAL_ASSERT_EQUALS(n2, num2)
+
+   if (brun == false) U_INTERNAL_ASSERT_EQUALS(n + n2, num)
+
    U_RETURN(true);
 }
 #endif
@@ -333,12 +777,33 @@ void UTimer::printInfo(ostream& os)
 {
    U_TRACE(0+256, "UTimer::printInfo(%p)", &os)
 
-   os << "first = ";
+   os << "num   = " << num << '\n';
+
+   for (uint32_t k = 0; k < U_TIMER_WHEEL_SIZE; ++k)
+      {
+      if (wheel[k])
+         {
+         os << "wheel[" << k << "] = ";
+
+         os << *wheel[k];
 
-   if (first) os << *first;
-   else       os << (void*)first;
+         os.put('\n');
+         }
+      }
+
+   for (uint32_t k = 0; k < U_TIMER_WHEEL_SIZE; ++k)
+      {
+      if (wheel2[k])
+         {
+         os << "wheel2[" << k << "] = ";
+
+         os << *wheel2[k];
+
+         os.put('\n');
+         }
+      }
 
-   os << "\npool  = ";
+   os << "pool  = ";
 
    if (pool) os << *pool;
    else      os << (void*)pool;
@@ -353,10 +818,17 @@ const char* UTimer::dump(bool reset) const
                                                  << " } { " << timerval.it_value.tv_sec
                                                  << " "     << timerval.it_value.tv_usec
                                                                  << " } }\n"
-                  << "pool         (UTimer     " << (void*)pool  << ")\n"
-                  << "first        (UTimer     " << (void*)first << ")\n"
-                  << "next         (UTimer     " << (void*)next  << ")\n"
-                  << "alarm        (UEventTime " << (void*)alarm << ")";
+                  << "num                      " << num                        << '\n'
+                  << "num2                     " << num2                       << '\n'
+                  << "level2                   " << level2                     << '\n'
+                  << "tick                     " << tick                       << '\n'
+                  << "armed                    " << armed                      << '\n'
+                  << "expire                   " << expire                     << '\n'
+                  << "current                  " << current                    << '\n'
+                  << "pool         (UTimer     " << (void*)pool                << ")\n"
+                  << "next         (UTimer     " << (void*)next                << ")\n"
+                  << "prev         (UTimer     " << (void*)prev                << ")\n"
+                  << "alarm        (UEventTime " << (void*)alarm               << ")";
 
    if (reset)
       {
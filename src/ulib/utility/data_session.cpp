@@ -13,7 +13,9 @@
 
 #include <ulib/utility/data_session.h>
 
-void UDataSession::fromString(const UString& _data)
+bool UDataSession::bbinary;
+
+bool UDataSession::fromString(const UString& _data)
 {
    U_TRACE(0, "UDataSession::fromString(%.*S)", U_STRING_TO_TRACE(_data))
 
@@ -21,22 +23,131 @@ void UDataSession::fromString(const UString& _data)
 
    data = _data;
 
-   istrstream is(_data.data(), _data.size());
+   if (_data.first_char() != U_DATA_SESSION_VERSION) // NB: old text format...
+      {
+      istrstream is(_data.data(), _data.size());
+
+      fromStream(is);
+
+      U_RETURN(true);
+      }
+
+   uint32_t i, n, len;
+   const char* ptr  = _data.data();
+   const char* _end = ptr + _data.size();
+
+   // NB: the stored string is not trusted, every length must be inside the string...
+
+   if (_data.size() < U_DATA_SESSION_HEADER) goto error;
+
+   n = u_get_unalignedp(ptr+1+sizeof(uint32_t));
+
+   creation    = (time_t)u_get_unalignedp(ptr+1);
+   last_access = u_now->tv_sec;
+
+   U_INTERNAL_DUMP("creation = %ld n = %u", creation, n)
+
+   ptr += U_DATA_SESSION_HEADER;
+
+   if (n > (uint32_t)(_end - ptr) / sizeof(uint32_t)) goto error;
+
+   if (n)
+      {
+      U_INTERNAL_ASSERT_EQUALS(vec,0)
+
+      vec = U_NEW(UVector<UString>(n));
+
+      for (i = 0; i < n; ++i)
+         {
+         if ((uint32_t)(_end - ptr) < sizeof(uint32_t)) goto error;
+
+         len = u_get_unalignedp(ptr);
+
+         ptr += sizeof(uint32_t);
+
+         if (len > (uint32_t)(_end - ptr)) goto error;
+
+         vec->push_back(_data.substr(ptr, len)); // NB: without copy...
+
+         ptr += len;
+         }
+      }
+
+   if (ptr < _end) // NB: data of the subclass...
+      {
+      istrstream is(ptr, _end - ptr);
+
+      bbinary = true;
 
-   fromStream(is);
+      fromStream(is);
+
+      bbinary = false;
+      }
+
+   U_RETURN(true);
+
+error:
+   clear();
+
+   data.clear();
+
+   creation = last_access = u_now->tv_sec;
+
+   U_RETURN(false);
 }
 
 UString UDataSession::toString()
 {
    U_TRACE(0, "UDataSession::toString()")
 
+   UStringRep* r;
+   uint32_t i, len, n = (vec ? vec->size() : 0), sz = U_DATA_SESSION_HEADER;
+
+   for (i = 0; i < n; ++i) sz += sizeof(uint32_t) + vec->UVector<UStringRep*>::at(i)->size();
+
+   UString x(sz);
+
+   char* ptr = x.data();
+
+   ptr[0] = U_DATA_SESSION_VERSION;
+
+   u_put_unalignedp((uint32_t)creation, ptr+1);
+   u_put_unalignedp(n,                  ptr+1+sizeof(uint32_t));
+
+   ptr += U_DATA_SESSION_HEADER;
+
+   for (i = 0; i < n; ++i)
+      {
+      r   = vec->UVector<UStringRep*>::at(i);
+      len = r->size();
+
+      u_put_unalignedp(len, ptr);
+
+      ptr += sizeof(uint32_t);
+
+      if (len)
+         {
+         u__memcpy(ptr, r->data(), len, __PRETTY_FUNCTION__);
+
+         ptr += len;
+         }
+      }
+
+   x.size_adjust(sz);
+
+   // NB: the subclass can add its data with toStream()...
+
    char buffer[64 * 1024];
 
    ostrstream os(buffer, sizeof(buffer));
 
+   bbinary = true;
+
    toStream(os);
 
-   UString x((void*)buffer, os.pcount());
+   bbinary = false;
+
+   if (os.pcount()) (void) x.append(buffer, os.pcount());
 
    U_RETURN_STRING(x);
 }
@@ -96,6 +207,8 @@ void UDataSession::fromStream(istream& is)
 {
    U_TRACE(0, "UDataSession::fromStream(%p)", &is)
 
+   if (bbinary) return;
+
    is >> creation;
 
    is.get(); // skip ' '
@@ -116,6 +229,8 @@ void UDataSession::toStream(ostream& os)
 {
    U_TRACE(0, "UDataSession::toStream(%p)", &os)
 
+   if (bbinary) return;
+
    os.put(' ');
    os << creation;
    os.put(' ');
@@ -11,11 +11,58 @@
 //
 // ============================================================================
 
+#include <ulib/notifier.h>
 #include <ulib/utility/interrupt.h>
 
 #include <errno.h>
 #include <stdlib.h>
 
+#ifdef HAVE_SIGNALFD
+#  include <sys/signalfd.h>
+
+class U_NO_EXPORT USignalFd : public UEventFd {
+public:
+
+   // Allocator e Deallocator
+   U_MEMORY_ALLOCATOR
+   U_MEMORY_DEALLOCATOR
+
+   // COSTRUTTORI
+
+   USignalFd()
+      {
+      U_TRACE_REGISTER_OBJECT(0, USignalFd, "")
+      }
+
+   virtual ~USignalFd()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, USignalFd)
+      }
+
+   // define method VIRTUAL of class UEventFd
+
+   virtual int handlerRead()
+      {
+      U_TRACE(0, "USignalFd::handlerRead()")
+
+      (void) UInterrupt::callHandlerSignalFd();
+
+      U_RETURN(U_NOTIFIER_OK);
+      }
+
+   virtual void handlerDelete()
+      {
+      U_TRACE(0, "USignalFd::handlerDelete()")
+
+      UEventFd::fd = 0; // NB: the object is owned by UInterrupt...
+      }
+
+private:
+   USignalFd(const USignalFd&) : UEventFd() {}
+   USignalFd& operator=(const USignalFd&)   { return *this; }
+};
+#endif
+
 /*
 const char* UInterrupt::ILL_errlist[] = {
    "ILL_ILLOPC",  "illegal opcode",          // ILL_ILLOPC 1
@@ -87,6 +134,11 @@ sig_atomic_t      UInterrupt::flag_wait_for_signal;
 struct sigaction  UInterrupt::act;
 struct sigaction  UInterrupt::old[NSIG];
 
+int               UInterrupt::fd_signal;
+pid_t             UInterrupt::pid_signalfd;
+sigset_t          UInterrupt::mask_signalfd;
+UEventFd*         UInterrupt::handler_signalfd;
+
 int               UInterrupt::event_signal_pending;
 sig_atomic_t      UInterrupt::event_signal[NSIG];
 sighandler_t      UInterrupt::handler_signal[NSIG];
@@ -213,6 +265,180 @@ void UInterrupt::callHandlerSignal()
    if (event_signal_pending) goto loop;
 }
 
+/* With signalfd the signal managed by the event loop are blocked, and they are read as ordinary event from a file descriptor.
+ * NB: the registration on epoll is bound to the open file (not to the number of the descriptor), so the mask is changed in place
+ * with signalfd() on the same descriptor. But the mask is a property of the open file that is shared with the parent after fork(),
+ * so the first change made by a child create its own signalfd on the same descriptor (dup2), and it must happen before the child
+ * register again all the event on a new epoll (UNotifier::init())...
+ */
+
+bool UInterrupt::initSignalFd()
+{
+   U_TRACE(1, "UInterrupt::initSignalFd()")
+
+#ifdef HAVE_SIGNALFD
+   if (handler_signalfd) U_RETURN(true);
+
+#  ifdef sigemptyset
+   sigemptyset(&mask_signalfd);
+#  else
+   (void) U_SYSCALL(sigemptyset, "%p", &mask_signalfd);
+#  endif
+
+   fd_signal = U_SYSCALL(signalfd, "%d,%p,%d", -1, &mask_signalfd, SFD_NONBLOCK | SFD_CLOEXEC);
+
+   if (fd_signal != -1)
+      {
+      pid_signalfd = u_pid;
+
+      handler_signalfd = U_NEW(USignalFd);
+
+      handler_signalfd->fd = fd_signal;
+
+      U_RETURN(true);
+      }
+
+   fd_signal = 0;
+#endif
+
+   U_RETURN(false);
+}
+
+U_NO_EXPORT void UInterrupt::setSignalFd()
+{
+   U_TRACE(1, "UInterrupt::setSignalFd()")
+
+   U_INTERNAL_ASSERT_MAJOR(fd_signal, 0)
+
+#ifdef HAVE_SIGNALFD
+   U_INTERNAL_DUMP("pid_signalfd = %d u_pid = %d", pid_signalfd, u_pid)
+
+   if (pid_signalfd == u_pid)
+      {
+      (void) U_SYSCALL(signalfd, "%d,%p,%d", fd_signal, &mask_signalfd, SFD_NONBLOCK | SFD_CLOEXEC);
+
+      return;
+      }
+
+   int fd = U_SYSCALL(signalfd, "%d,%p,%d", -1, &mask_signalfd, SFD_NONBLOCK | SFD_CLOEXEC);
+
+   if (fd != -1)
+      {
+      pid_signalfd = u_pid;
+
+      (void) U_SYSCALL(dup2,  "%d,%d", fd, fd_signal);
+      (void) U_SYSCALL(close, "%d",    fd);
+
+      // NB: dup2() clear the flag FD_CLOEXEC...
+
+      (void) U_SYSCALL(fcntl, "%d,%d,%d", fd_signal, F_SETFD, FD_CLOEXEC);
+      }
+#endif
+}
+
+void UInterrupt::insertSignalFd(int signo, sighandler_t handler)
+{
+   U_TRACE(1, "UInterrupt::insertSignalFd(%d,%p)", signo, handler)
+
+   U_INTERNAL_ASSERT_RANGE(1, signo, NSIG)
+   U_INTERNAL_ASSERT_POINTER(handler_signalfd)
+
+   handler_signal[signo] = handler;
+
+   sigset_t mask;
+
+   setMaskInterrupt(&mask, signo);
+
+#ifdef sigaddset
+   sigaddset(&mask_signalfd, signo);
+#else
+   (void) U_SYSCALL(sigaddset, "%p,%d", &mask_signalfd, signo);
+#endif
+
+   (void) U_SYSCALL(sigprocmask, "%d,%p,%p", SIG_BLOCK, &mask, 0);
+
+   setSignalFd();
+}
+
+void UInterrupt::eraseSignalFd(int signo)
+{
+   U_TRACE(1, "UInterrupt::eraseSignalFd(%d)", signo)
+
+   U_INTERNAL_ASSERT_RANGE(1, signo, NSIG)
+   U_INTERNAL_ASSERT_POINTER(handler_signalfd)
+
+   handler_signal[signo] = 0;
+
+   sigset_t mask;
+
+   setMaskInterrupt(&mask, signo);
+
+#ifdef sigdelset
+   sigdelset(&mask_signalfd, signo);
+#else
+   (void) U_SYSCALL(sigdelset, "%p,%d", &mask_signalfd, signo);
+#endif
+
+   setSignalFd();
+
+   // NB: a pending signal is delivered now with the current action...
+
+   (void) U_SYSCALL(sigprocmask, "%d,%p,%p", SIG_UNBLOCK, &mask, 0);
+}
+
+bool UInterrupt::callHandlerSignalFd()
+{
+   U_TRACE(1, "UInterrupt::callHandlerSignalFd()")
+
+   U_INTERNAL_ASSERT_MAJOR(fd_signal, 0)
+
+   bool result = false;
+
+#ifdef HAVE_SIGNALFD
+   int signo;
+   struct signalfd_siginfo info;
+
+   while (U_SYSCALL(read, "%d,%p,%u", fd_signal, &info, sizeof(info)) == (ssize_t)sizeof(info))
+      {
+      signo  = info.ssi_signo;
+      result = true;
+
+      U_INTERNAL_DUMP("signo = %d ssi_pid = %u", signo, info.ssi_pid)
+
+      if (handler_signal[signo]) handler_signal[signo](signo);
+      }
+#endif
+
+   U_RETURN(result);
+}
+
+void UInterrupt::waitForSignalFd()
+{
+   U_TRACE(0, "UInterrupt::waitForSignalFd()")
+
+   U_INTERNAL_ASSERT_MAJOR(fd_signal, 0)
+
+   // NB: the signal are blocked, so we can't be interrupted (EINTR) while we wait...
+
+   if (UNotifier::waitForRead(fd_signal) > 0) (void) callHandlerSignalFd();
+}
+
+void UInterrupt::discardSignal(int signo)
+{
+   U_TRACE(1, "UInterrupt::discardSignal(%d)", signo)
+
+   // NB: consume the pending instance of a blocked signal (ex: SIGTERM sent to our process group)...
+
+#ifdef HAVE_SIGNALFD
+   sigset_t mask;
+   struct timespec ts = { 0L, 0L };
+
+   setMaskInterrupt(&mask, signo);
+
+   while (U_SYSCALL(sigtimedwait, "%p,%p,%p", &mask, 0, &ts) == signo) {}
+#endif
+}
+
 void UInterrupt::setMaskInterrupt(sigset_t* mask, int signo)
 {
    U_TRACE(1, "UInterrupt::setMaskInterrupt(%p,%d)", mask, signo)
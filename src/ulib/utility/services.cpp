@@ -141,6 +141,38 @@ read:
    U_RETURN(true);
 }
 
+bool UServices::readEOF(int fd, UString& buffer, int timeoutMS)
+{
+   U_TRACE(1, "UServices::readEOF(%d,%.*S,%d)", fd, U_STRING_TO_TRACE(buffer), timeoutMS)
+
+   if (timeoutMS <= 0)
+      {
+      readEOF(fd, buffer);
+
+      U_RETURN(true);
+      }
+
+   long remaining = timeoutMS;
+   struct timespec start, now;
+
+   (void) U_SYSCALL(clock_gettime, "%d,%p", CLOCK_MONOTONIC, &start);
+
+   do {
+      // NB: UNotifier::waitForRead() want at least 500ms...
+
+      if (UNotifier::waitForRead(fd, U_max(remaining, 500L)) <= 0) U_RETURN(false);
+
+      if (UServices::read(fd, buffer, U_SINGLE_READ, -1) == false) U_RETURN(true); // eof
+
+      (void) U_SYSCALL(clock_gettime, "%d,%p", CLOCK_MONOTONIC, &now);
+
+      remaining = timeoutMS - ((now.tv_sec - start.tv_sec) * 1000L + (now.tv_nsec - start.tv_nsec) / 1000000L);
+      }
+   while (remaining > 0);
+
+   U_RETURN(false);
+}
+
 int UServices::askToLDAP(UString* pinput, UHashMap<UString>* ptable, const char* fmt, va_list argp)
 {
    U_TRACE(0, "UServices::::askToLDAP(%p,%p,%S)", pinput, ptable, fmt)
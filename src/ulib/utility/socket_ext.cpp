@@ -274,9 +274,7 @@ loop:
 
    if (ncount == 0) U_RETURN(iBytesWrite);
 
-   U_INTERNAL_ASSERT_MAJOR(_iov[idx].iov_len, 0)
-
-   if ((size_t)value >= _iov[idx].iov_len)
+   while ((size_t)value >= _iov[idx].iov_len) // NB: the bytes written can span more than one buffer...
       {
       value -= _iov[idx].iov_len;
                _iov[idx].iov_len = 0;
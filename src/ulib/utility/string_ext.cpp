@@ -1257,22 +1257,59 @@ UString UStringExt::deflate(const char* s, uint32_t len, bool bheader) // .gz co
 
    uint32_t sz = len + (len / 10) + 12U;
 
+#if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+   UMemoryPool::lock(); // NB: the area can be shared by more thread...
+#endif
+
    if (UFile::isAllocableFromPool(sz))
       {
-      len = u_gz_deflate(s, len, UFile::pfree, bheader);
-
-      U_INTERNAL_DUMP("u_gz_deflate() = %u", len)
+      // NB: we must reserve the area before to compress and to create the string, the allocation of the rep (or another thread)
+      //     can take memory from the same area...
 
-      sz = (len + U_PAGEMASK) & ~U_PAGEMASK;
+      char* ptr = UFile::pfree;
 
-      UString result(len, sz, UFile::pfree);
+      sz = (sz + U_PAGEMASK) & ~U_PAGEMASK;
 
       UFile::pfree += sz;
       UFile::nfree -= sz;
 
+#  if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+      UMemoryPool::unlock();
+#  endif
+
+      len = u_gz_deflate(s, len, ptr, bheader);
+
+      U_INTERNAL_DUMP("u_gz_deflate() = %u", len)
+
+      uint32_t used = (len + U_PAGEMASK) & ~U_PAGEMASK;
+
+      // NB: if nobody has taken memory from the area after us we give back the part not used...
+
+#  if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+      UMemoryPool::lock();
+#  endif
+
+      if (UFile::pfree == (ptr + sz))
+         {
+         UFile::pfree -= (sz - used);
+         UFile::nfree += (sz - used);
+
+         sz = used;
+         }
+
+#  if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+      UMemoryPool::unlock();
+#  endif
+
+      UString result(len, sz, ptr);
+
       U_RETURN_STRING(result);
       }
 
+#if defined(__linux__) && defined(ENABLE_THREAD) && defined(HAVE_PTHREAD_H)
+   UMemoryPool::unlock();
+#endif
+
    UString r(sz);
 
    r.rep->_length = u_gz_deflate(s, len, r.rep->data(), bheader);
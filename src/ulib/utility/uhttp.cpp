@@ -15,12 +15,14 @@
 
 #include <ulib/url.h>
 #include <ulib/date.h>
+#include <ulib/cache.h>
 #include <ulib/db/rdb.h>
 #include <ulib/command.h>
 #include <ulib/tokenizer.h>
 #include <ulib/mime/entity.h>
 #include <ulib/utility/uhttp.h>
 #include <ulib/mime/multipart.h>
+#include <ulib/utility/lock.h>
 #include <ulib/utility/escape.h>
 #include <ulib/utility/base64.h>
 #include <ulib/base/coder/url.h>
@@ -37,6 +39,7 @@
 #  include <libtcc.h>
 #endif
 #ifndef __MINGW32__
+#  include <sys/un.h>
 #  include <sys/resource.h>
 #endif
 
@@ -53,8 +56,10 @@
 
 #define U_FLV_HEAD             "FLV\x1\x1\0\0\0\x9\0\0\0\x9"
 #define U_STORAGE_KEYID        "STID"
+#define U_HTTP_SESSION_SWEEP   10 // NB: seconds between the sweep of two shard of the http session store...
 #define U_TIME_FOR_EXPIRE      (u_now->tv_sec + (365 * U_ONE_DAY_IN_SECOND))
 #define U_MIN_SIZE_FOR_DEFLATE 150
+#define U_CGI_POOL_BACKLOG     64 // NB: max number of connection waiting a runner of the pool of a CGI...
 
 int         UHTTP::inotify_wd;
 bool        UHTTP::nostat;
@@ -68,7 +73,6 @@ UFile*      UHTTP::file;
 UFile*      UHTTP::apache_like_log;
 UString*    UHTTP::uri;
 UString*    UHTTP::alias;
-UString*    UHTTP::cbuffer;
 UString*    UHTTP::geoip;
 UString*    UHTTP::tmpdir;
 UString*    UHTTP::keyID;
@@ -84,6 +88,9 @@ UString*    UHTTP::scgi_uri_mask;
 UString*    UHTTP::cookie_option;
 UString*    UHTTP::cache_file_mask;
 UString*    UHTTP::cache_file_store;
+char*       UHTTP::cache_file_shared;
+uint32_t    UHTTP::cache_file_shared_size;
+uint32_t    UHTTP::cache_file_shared_used;
 UString*    UHTTP::uri_protected_mask;
 UString*    UHTTP::uri_request_cert_mask;
 UString*    UHTTP::maintenance_mode_page;
@@ -109,18 +116,49 @@ const char* UHTTP::ptrU;
 const char* UHTTP::ptrP;
 const char* UHTTP::ptrX;
 const char* UHTTP::ptrS;
+const char* UHTTP::header_index_ptr;
+uint32_t    UHTTP::header_index_num;
+uint32_t    UHTTP::header_index_size;
+uint32_t    UHTTP::header_index_lookup;
+uint32_t    UHTTP::header_known_hash[HEADER_KNOWN_NUM];
+#ifdef U_HTTP_CACHE_REQUEST
+char        UHTTP::micro_cache_key[U_MICRO_CACHE_KEY_SIZE];
+ULock*      UHTTP::micro_cache_lock;
+UCache*     UHTTP::micro_cache_shared;
+uint32_t    UHTTP::micro_cache_ttl = 1;
+uint32_t    UHTTP::micro_cache_max_ttl = 5;
+uint32_t    UHTTP::micro_cache_hash;
+uint32_t    UHTTP::micro_cache_size;
+uint32_t    UHTTP::micro_cache_key_len;
+uint32_t    UHTTP::micro_cache_shared_size;
+
+UHTTP::micro_cache_entry*         UHTTP::micro_cache;
+#endif
+
+const UString*                    UHTTP::header_known_name[HEADER_KNOWN_NUM];
+UHTTP::header_index_entry         UHTTP::header_index[U_HTTP_HEADER_INDEX_SIZE];
 
 uint32_t                          UHTTP::upload_progress_index;
 UDataSession*                     UHTTP::data_session;
 UDataSession*                     UHTTP::data_storage;
 UMimeMultipart*                   UHTTP::formMulti;
 UVector<UString>*                 UHTTP::valias;
+UVector<UString>*                 UHTTP::vcgi_pool_mask;
 UVector<UString>*                 UHTTP::form_name_value;
 UVector<UIPAllow*>*               UHTTP::vallow_IP;
 UHTTP::upload_progress*           UHTTP::ptr_upload_progress;
+UHTTP::session_cache*             UHTTP::vsession_cache;
+uint32_t                          UHTTP::session_slot;
 
          UHTTP::UFileCacheData*   UHTTP::file_data;
 UHashMap<UHTTP::UFileCacheData*>* UHTTP::cache_file;
+time_t                            UHTTP::ready_response_time;
+uint32_t                          UHTTP::ready_response_prefix_len[3];
+char                              UHTTP::ready_response_prefix[3][U_READY_RESPONSE_PREFIX];
+#if defined(HAVE_SYS_INOTIFY_H) && defined(U_HTTP_INOTIFY_SUPPORT)
+uint32_t                          UHTTP::cache_file_generation;
+UHTTP::cache_file_log*            UHTTP::ptr_cache_file_log;
+#endif
 #ifdef USE_PAGE_SPEED
 UHTTP::UPageSpeed*                UHTTP::page_speed;
 #endif
@@ -309,6 +347,7 @@ UHTTP::UFileCacheData::UFileCacheData()
 
    ptr        = array = 0;
    size       = 0;
+   response[0] = response[1] = 0;
    mode       = 0;
    mtime      = 0;
    link       = false;
@@ -338,6 +377,9 @@ UHTTP::UFileCacheData::~UFileCacheData()
 
    if (array) delete array;
 
+   if (response[0]) delete response[0];
+   if (response[1]) delete response[1];
+
 #if defined(HAVE_SYS_INOTIFY_H) && defined(U_HTTP_INOTIFY_SUPPORT)
    if (UServer_Base::handler_inotify)
       {
@@ -374,7 +416,7 @@ U_NO_EXPORT void UHTTP::getInotifyPathDirectory(UStringRep* key, void* value)
       }
 }
 
-U_NO_EXPORT void UHTTP::checkInotifyForCache(int wd, char* name, uint32_t len)
+U_NO_EXPORT bool UHTTP::checkInotifyForCache(int wd, char* name, uint32_t len)
 {
    U_TRACE(0, "UHTTP::checkInotifyForCache(%d,%.*S,%u)", wd, len, name, len)
 
@@ -391,18 +433,114 @@ U_NO_EXPORT void UHTTP::checkInotifyForCache(int wd, char* name, uint32_t len)
 
    U_INTERNAL_ASSERT_POINTER(file_data)
 
-   if (file_data->wd != wd) file_data = 0;
+   if (file_data->wd != wd)
+      {
+      file_data = 0;
+
+      U_RETURN(false);
+      }
+
+   U_INTERNAL_ASSERT_POINTER(UHashMap<void*>::pkey)
+
+   static char buffer[U_PATH_MAX]; // NB: the key is used after return (in_CREATE(), log of the change)...
+
+   UHashMap<void*>::pkey->_length = u__snprintf(buffer, sizeof(buffer), "%.*s/%.*s", U_STRING_TO_TRACE(*UHashMap<void*>::pkey), len, name);
+   UHashMap<void*>::pkey->str     = buffer;
+
+   file_data = (*cache_file)[UHashMap<void*>::pkey];
+
+   U_RETURN(true);
+}
+
+U_NO_EXPORT void UHTTP::setExpireForAllEntry(UStringRep* key, void* value)
+{
+   U_TRACE(0, "UHTTP::setExpireForAllEntry(%.*S,%p)", U_STRING_TO_TRACE(*key), value)
+
+   if (((UFileCacheData*)value)->array) ((UFileCacheData*)value)->expire = 0; // NB: we delay the renew...
+}
+
+U_NO_EXPORT void UHTTP::manageInotifyEvent(uint32_t mask)
+{
+   U_TRACE(0, "UHTTP::manageInotifyEvent(%B)", mask)
+
+   if (mask & IN_CREATE) in_CREATE();
    else
       {
-      U_INTERNAL_ASSERT_POINTER(UHashMap<void*>::pkey)
+           if (mask & IN_DELETE) in_DELETE();
+      else if (mask & IN_MODIFY)
+         {
+         if (file_data)
+            {
+            // NB: check if we have the content of file in cache...
 
-      char buffer[U_PATH_MAX];
+            if (isDataFromCache()) file_data->expire = 0; // NB: we delay the renew...
+            else                   renewDataCache();
+            }
+         }
+      }
+}
+
+// NB: the children that are not the inotify owner apply on their index the change published by it (we are not in a request)...
+
+U_NO_EXPORT void UHTTP::checkCacheFileLog()
+{
+   U_TRACE(0, "UHTTP::checkCacheFileLog()")
+
+   U_INTERNAL_ASSERT_POINTER(cache_file)
+   U_INTERNAL_ASSERT_POINTER(ptr_cache_file_log)
+   U_INTERNAL_ASSERT_POINTER(UHashMap<void*>::pkey)
+
+   uint32_t generation = ptr_cache_file_log->generation;
+
+   U_INTERNAL_DUMP("generation = %u cache_file_generation = %u", generation, cache_file_generation)
+
+   if (generation == cache_file_generation) return;
+
+   cache_file_event event;
+
+   __sync_synchronize();
+
+   while (cache_file_generation != generation)
+      {
+      if ((generation - cache_file_generation) >= U_CACHE_FILE_EVENT_MAX) goto lost;
 
-      UHashMap<void*>::pkey->_length = u__snprintf(buffer, sizeof(buffer), "%.*s/%.*s", U_STRING_TO_TRACE(*UHashMap<void*>::pkey), len, name);
-      UHashMap<void*>::pkey->str     = buffer;
+      event = ptr_cache_file_log->event[cache_file_generation % U_CACHE_FILE_EVENT_MAX];
 
-      file_data = (*cache_file)[UHashMap<void*>::pkey];
+      __sync_synchronize();
+
+      // NB: the owner can have overwritten the slot while we copied it (it write the slot of the event N + U_CACHE_FILE_EVENT_MAX
+      //     when generation is already N + U_CACHE_FILE_EVENT_MAX, before to publish the event)...
+
+      if ((ptr_cache_file_log->generation - cache_file_generation) >= U_CACHE_FILE_EVENT_MAX) goto lost;
+
+      ++cache_file_generation;
+
+      U_INTERNAL_DUMP("event.mask = %B event.path = %.*S", event.mask, event.len, event.path)
+
+      if (event.len == 0) cache_file->callForAllEntry(setExpireForAllEntry); // NB: pathname too long for the log...
+      else
+         {
+         UHashMap<void*>::pkey->_length = event.len;
+         UHashMap<void*>::pkey->str     = event.path;
+
+         file_data = (*cache_file)[UHashMap<void*>::pkey];
+
+         manageInotifyEvent(event.mask);
+         }
       }
+
+   file_data = 0;
+
+   return;
+
+lost:
+   U_SRV_LOG("WARNING: lost %u change of the document root, the content of memory cache is renewed on demand", generation - cache_file_generation);
+
+   cache_file->callForAllEntry(setExpireForAllEntry);
+
+   cache_file_generation = generation;
+
+   file_data = 0;
 }
 #endif
 
@@ -464,6 +602,12 @@ void UHTTP::in_READ()
    uint32_t len;
    char buffer[IN_BUFLEN];
    union uuinotify_event event;
+   cache_file_event* pevent;
+
+   // NB: a respawned inotify owner must apply first the change published by its predecessor...
+
+   if (ptr_cache_file_log) checkCacheFileLog();
+
    int i = 0, length = U_SYSCALL(read, "%d,%p,%u", UServer_Base::handler_inotify->fd, buffer, IN_BUFLEN);  
 
    while (i < length)
@@ -483,22 +627,26 @@ void UHTTP::in_READ()
 
          U_INTERNAL_ASSERT_EQUALS(len, u__strlen(event.ip->name, __PRETTY_FUNCTION__))
 
-         checkInotifyForCache(event.ip->wd, event.ip->name, len);
-
-         if (event.ip->mask & IN_CREATE) in_CREATE();
-         else
+         if (checkInotifyForCache(event.ip->wd, event.ip->name, len))
             {
-                 if (event.ip->mask & IN_DELETE) in_DELETE();
-            else if (event.ip->mask & IN_MODIFY)
+            if (ptr_cache_file_log)
                {
-               if (file_data)
-                  {
-                  // NB: check if we have the content of file in cache...
+               // NB: we publish the change for the other children (before in_CREATE() that can change the key)...
 
-                  if (isDataFromCache()) file_data->expire = 0; // NB: we delay the renew...
-                  else                   renewDataCache();
-                  }
+               pevent = ptr_cache_file_log->event + (cache_file_generation % U_CACHE_FILE_EVENT_MAX);
+
+               pevent->mask = event.ip->mask;
+               pevent->len  = UHashMap<void*>::pkey->size();
+
+               if (pevent->len < U_CACHE_FILE_EVENT_PATH) u__memcpy(pevent->path, UHashMap<void*>::pkey->data(), pevent->len, __PRETTY_FUNCTION__);
+               else                                       pevent->len = 0;
+
+               __sync_synchronize();
+
+               ptr_cache_file_log->generation = ++cache_file_generation;
                }
+
+            manageInotifyEvent(event.ip->mask);
             }
          }
 
@@ -656,7 +804,6 @@ void UHTTP::ctor()
    U_INTERNAL_ASSERT_EQUALS(alias,0)
    U_INTERNAL_ASSERT_EQUALS(geoip,0)
    U_INTERNAL_ASSERT_EQUALS(tmpdir,0)
-   U_INTERNAL_ASSERT_EQUALS(cbuffer,0)
    U_INTERNAL_ASSERT_EQUALS(qcontent,0)
    U_INTERNAL_ASSERT_EQUALS(pathname,0)
    U_INTERNAL_ASSERT_EQUALS(formMulti,0)
@@ -670,7 +817,6 @@ void UHTTP::ctor()
    alias           = U_NEW(UString);
    geoip           = U_NEW(UString(U_CAPACITY));
    tmpdir          = U_NEW(UString(U_PATH_MAX));
-   cbuffer         = U_NEW(UString);
    qcontent        = U_NEW(UString);
    pathname        = U_NEW(UString);
    formMulti       = U_NEW(UMimeMultipart);
@@ -703,6 +849,8 @@ void UHTTP::ctor()
    ptrX =    USocket::str_X_Forwarded_For->c_pointer(1);   // "X-Forwarded-For"
    ptrI =    USocket::str_if_modified_since->c_pointer(1); // "If-Modified-Since"
 
+   setHeaderKnown();
+
 #ifdef USE_LIBMAGIC
    (void) UMagic::init();
 #endif
@@ -886,6 +1034,10 @@ next:
       if (UServer_Base::handler_inotify->fd != -1)
          {
          U_SRV_LOG("Inode based directory notification enabled");
+
+         // NB: with preforked children we need the log of the change in the shared data (see in_READ())...
+
+         if (UServer_Base::isPreForked()) ptr_cache_file_log = (cache_file_log*) UServer_Base::getOffsetToDataShare(sizeof(cache_file_log));
          }
       else
          {
@@ -1053,11 +1205,165 @@ load:
       }
 }
 
+// NB: the size in the area of a string of the cache: we keep the null terminator (so nobody need to write on it) and the alignment...
+
+#define U_CACHE_FILE_SHARED_SIZE(len) (((len) + 1 + 7) & ~7)
+
+U_NO_EXPORT void UHTTP::getSizeForCacheFileShared(UStringRep* key, void* value)
+{
+   U_TRACE(0, "UHTTP::getSizeForCacheFileShared(%.*S,%p)", U_STRING_TO_TRACE(*key), value)
+
+   UVector<UString>* array = ((UFileCacheData*)value)->array;
+
+   if (array)
+      {
+      UString* response;
+
+      for (int i = 0; i < 2; ++i)
+         {
+         if ((response = ((UFileCacheData*)value)->response[i])) cache_file_shared_used += U_CACHE_FILE_SHARED_SIZE(response->size());
+         }
+
+      UString item;
+
+      for (uint32_t i = 0, n = array->size(); i < n; ++i)
+         {
+         item = array->at(i);
+
+         // NB: the content memory mapped (partial write) is already shared by the page cache...
+
+         if (item.empty()  == false &&
+             item.isMmap() == false)
+            {
+            cache_file_shared_used += U_CACHE_FILE_SHARED_SIZE(item.size());
+            }
+         }
+      }
+}
+
+U_NO_EXPORT void UHTTP::moveDataInCacheFileShared(UStringRep* key, void* value)
+{
+   U_TRACE(0, "UHTTP::moveDataInCacheFileShared(%.*S,%p)", U_STRING_TO_TRACE(*key), value)
+
+   UVector<UString>* array = ((UFileCacheData*)value)->array;
+
+   if (array)
+      {
+      char* ptr;
+      UString item;
+      UString* response;
+      uint32_t sz, len;
+
+      // NB: the ready responses first, they are what we send for the small files (the pieces are used only for HTTP/1.0, range, ...)
+
+      for (int i = 0; i < 2; ++i)
+         {
+         if ((response = ((UFileCacheData*)value)->response[i]))
+            {
+            len = response->size();
+            sz  = U_CACHE_FILE_SHARED_SIZE(len);
+
+            if ((cache_file_shared_used + sz) > cache_file_shared_size) continue;
+
+            ptr = cache_file_shared + cache_file_shared_used;
+                                      cache_file_shared_used += sz;
+
+            u__memcpy(ptr, response->data(), len, __PRETTY_FUNCTION__);
+
+            ptr[len] = '\0';
+
+            *response = UString(ptr, len);
+            }
+         }
+
+      for (uint32_t i = 0, n = array->size(); i < n; ++i)
+         {
+         item = array->at(i);
+
+         if (item.empty()  == false &&
+             item.isMmap() == false)
+            {
+            len = item.size();
+            sz  = U_CACHE_FILE_SHARED_SIZE(len);
+
+            if ((cache_file_shared_used + sz) > cache_file_shared_size) continue; // NB: over the limit the content remain private...
+
+            ptr = cache_file_shared + cache_file_shared_used;
+                                      cache_file_shared_used += sz;
+
+            u__memcpy(ptr, item.data(), len, __PRETTY_FUNCTION__);
+
+            ptr[len] = '\0';
+
+            // NB: the string is now a constant that reference the area, the copy in the heap of the parent is released...
+
+            array->replace(i, UString(ptr, len));
+            }
+         }
+      }
+}
+
+void UHTTP::initCacheFileShared()
+{
+   U_TRACE(1, "UHTTP::initCacheFileShared()")
+
+   U_INTERNAL_ASSERT_POINTER(cache_file)
+   U_INTERNAL_ASSERT_EQUALS(cache_file_shared, 0)
+
+   // NB: we are in the parent before the fork of the children, now we have the shared data allocated by UServer...
+
+#if defined(HAVE_SYS_INOTIFY_H) && defined(U_HTTP_INOTIFY_SUPPORT)
+   if (ptr_cache_file_log) ptr_cache_file_log = (cache_file_log*) UServer_Base::getPointerToDataShare(ptr_cache_file_log);
+#endif
+
+   U_INTERNAL_DUMP("cache_file_shared_size = %u", cache_file_shared_size)
+
+   if (cache_file_shared_size == 0 ||
+       UServer_Base::isPreForked() == false)
+      {
+      return;
+      }
+
+   cache_file_shared_used = 0;
+
+   cache_file->callForAllEntry(getSizeForCacheFileShared);
+
+   uint32_t total = cache_file_shared_used;
+
+   U_INTERNAL_DUMP("total = %u", total)
+
+   if (total == 0) return;
+
+   if (cache_file_shared_size > total) cache_file_shared_size = total;
+
+   cache_file_shared = UFile::mmap(&cache_file_shared_size);
+
+   if (cache_file_shared == MAP_FAILED)
+      {
+      cache_file_shared = 0;
+
+      U_SRV_LOG("WARNING: mmap of the area shared between the children for the content of memory cache failed");
+
+      return;
+      }
+
+   cache_file_shared_used = 0;
+
+   cache_file->callForAllEntry(moveDataInCacheFileShared);
+
+   // NB: the children map the area read-only, a write on the content of the cache is a bug...
+
+   (void) U_SYSCALL(mprotect, "%p,%u,%d", cache_file_shared, cache_file_shared_size, PROT_READ);
+
+   U_SRV_LOG("Memory cache: %u KB of content shared (read-only) between the children, %u KB private", cache_file_shared_used / 1024, (total - cache_file_shared_used) / 1024);
+}
+
 void UHTTP::dtor()
 {
    U_TRACE(0, "UHTTP::dtor()")
 
    if (valias)                             delete valias;
+   if (vcgi_pool_mask)                     delete vcgi_pool_mask;
    if (global_alias)                       delete global_alias;
    if (cookie_option)                      delete cookie_option;
    if (cache_file_mask)                    delete cache_file_mask;
@@ -1089,13 +1395,21 @@ void UHTTP::dtor()
              cache_file->deallocate();
       delete cache_file;
 
+      // NB: the strings of the cache are gone, we can release the area with their content...
+
+      if (cache_file_shared)
+         {
+         UFile::munmap(cache_file_shared, cache_file_shared_size);
+
+         cache_file_shared = 0;
+         }
+
       delete uri;
       delete file;
       delete keyID;
       delete alias;
       delete geoip;
       delete tmpdir;
-      delete cbuffer;
       delete qcontent;
       delete pathname;
       delete formMulti;
@@ -1110,6 +1424,10 @@ void UHTTP::dtor()
 
       if (db_session) deleteSession();
 
+#  ifdef U_HTTP_CACHE_REQUEST
+      clearRequestCache();
+#  endif
+
 #  ifdef USE_PAGE_SPEED
       if (page_speed) delete page_speed;
 #  endif
@@ -1470,6 +1788,8 @@ bool UHTTP::scanfHeader(const char* ptr, uint32_t size)
    unsigned char c   = *ptr;
    const char* start =  ptr;
 
+   header_index_ptr = 0; // NB: new request, the index of the header lines must be rebuilt...
+
    if (c != 'G')
       {
       // RFC 2616 4.1 "servers SHOULD ignore any empty line(s) received where a Request-Line is expected"
@@ -1618,6 +1938,8 @@ bool UHTTP::scanfHeader(const char* ptr, uint32_t size)
 
    while (true)
       {
+      ptr = u_skipUriChar(ptr, endptr); // NB: SSE2/AVX2 if available, we stop only on ' ', '?' and control char...
+
       c = (*(unsigned char*)ptr);
 
       if (c == ' ') break;
@@ -1966,113 +2288,288 @@ U_NO_EXPORT bool UHTTP::isRequestTooLarge(UString& buffer)
    U_RETURN(false);
 }
 
-__pure const char* UHTTP::getHeaderValuePtr(const UString& request, const UString& name, bool nocase)
+U_NO_EXPORT void UHTTP::setHeaderKnown()
 {
-   U_TRACE(0, "UHTTP::getHeaderValuePtr(%.*S,%.*S,%b)", U_STRING_TO_TRACE(request), U_STRING_TO_TRACE(name), nocase)
+   U_TRACE(0, "UHTTP::setHeaderKnown()")
 
-   if (u_http_info.szHeader) return UStringExt::getValueFromName(request, u_http_info.startHeader, u_http_info.szHeader, name, nocase);
+   U_INTERNAL_ASSERT_POINTER(USocket::str_authorization)
 
-   U_RETURN((const char*)0);
-}
+   header_known_name[HEADER_AUTHORIZATION]       = USocket::str_authorization;
+   header_known_name[HEADER_IF_RANGE]            = USocket::str_if_range;
+   header_known_name[HEADER_IF_NONE_MATCH]       = USocket::str_if_none_match;
+   header_known_name[HEADER_IF_UNMODIFIED_SINCE] = USocket::str_if_unmodified_since;
+   header_known_name[HEADER_TRANSFER_ENCODING]   = USocket::str_Transfer_Encoding;
+   header_known_name[HEADER_X_PROGRESS_ID]       = USocket::str_X_Progress_ID;
 
-__pure const char* UHTTP::getHeaderValuePtr(const UString& name, bool nocase) { return getHeaderValuePtr(*UClientImage_Base::request, name, nocase); }
+   for (uint32_t i = 0; i < HEADER_KNOWN_NUM; ++i) header_known_hash[i] = header_known_name[i]->hash(true);
+}
 
-bool UHTTP::readBody(USocket* s, UString* pbuffer, UString& body)
+U_NO_EXPORT void UHTTP::setHeaderIndex(const UString& request)
 {
-   U_TRACE(0, "UHTTP::readBody(%p,%.*S,%.*S)", s, U_STRING_TO_TRACE(*pbuffer), U_STRING_TO_TRACE(body))
+   U_TRACE(0, "UHTTP::setHeaderIndex(%.*S)", U_STRING_TO_TRACE(request))
 
-   U_INTERNAL_ASSERT(s->isConnected())
-   U_INTERNAL_ASSERT_EQUALS((bool)body, false)
+   U_INTERNAL_ASSERT_MAJOR(u_http_info.szHeader, 0)
 
-   // NB: check if request includes an entity-body (as indicated by the presence of Content-Length or Transfer-Encoding)
+   uint32_t hash, slot, name_len;
+   const char* name;
+   const char* ptr   = request.data();
+   const char* p     = ptr + u_http_info.startHeader;
+   const char* end   = p   + u_http_info.szHeader;
 
-   if (u_http_info.clength)
-      {
-      uint32_t body_byte_read = (pbuffer->size() - u_http_info.endHeader);
+   (void) U_SYSCALL(memset, "%p,%d,%u", header_index, 0, sizeof(header_index));
 
-      U_INTERNAL_DUMP("pbuffer->size() = %u body_byte_read = %u Content-Length = %u", pbuffer->size(), body_byte_read, u_http_info.clength)
+   while (p < end)
+      {
+      // NB: we skip the continuation of the previous header line (it start with space)...
 
-      if (u_http_info.clength > body_byte_read)
+      if (u__isspace(*(name = p)) == false)
          {
-         if (isRequestTooLarge(*pbuffer))
+         while (p < end && *p != ':' && *p != '\n') ++p;
+
+         if (p < end && *p == ':')
             {
-            u_http_info.nResponseCode  = HTTP_ENTITY_TOO_LARGE;
-            U_http_is_connection_close = U_YES;
+            for (name_len = p - name; name_len && u__isspace(name[name_len-1]); --name_len) {}
 
-            setResponse(0, 0);
+            if (name_len)
+               {
+               if (header_index_num == (U_HTTP_HEADER_INDEX_SIZE / 4 * 3))
+                  {
+                  header_index_num = U_NOT_FOUND; // NB: too many header lines, we scan the request...
 
-            U_RETURN(false);
-            }
+                  return;
+                  }
 
-         // NB: check for 'Expect: 100-continue' (as curl does)...
+               do { ++p; } while (*p == ' ' || *p == '\t');
 
-         if (body_byte_read == 0                                                                                            &&
-             pbuffer->find(*USocket::str_expect_100_continue, u_http_info.startHeader, u_http_info.szHeader) != U_NOT_FOUND &&
-             USocketExt::write(s, U_CONSTANT_TO_PARAM("HTTP/1.1 100 Continue\r\n\r\n"), UServer_Base::timeoutMS) == false)
-            {
-            U_INTERNAL_ASSERT_EQUALS(U_http_version, '1')
+               hash = u_hash((unsigned char*)name, name_len, true);
 
-            U_RETURN(false);
-            }
+               for (slot = hash & (U_HTTP_HEADER_INDEX_SIZE-1); header_index[slot].name_len; slot = (slot+1) & (U_HTTP_HEADER_INDEX_SIZE-1)) {}
 
-#     ifdef U_HTTP_UPLOAD_PROGRESS_SUPPORT
-         if (USocketExt::byte_read_hook)
-            {
-            (void) initUploadProgress(u_http_info.clength);
+               header_index[slot].hash     = hash;
+               header_index[slot].name     = name - ptr;
+               header_index[slot].name_len = name_len;
+               header_index[slot].value    = p    - ptr;
 
-            if (body_byte_read) updateUploadProgress(body_byte_read);
+               ++header_index_num;
+               }
             }
-#     endif
+         }
 
-         // NB: wait for other data...
+      if ((p = (const char*) memchr(p, '\n', end - p)) == 0) break;
 
-         if (USocketExt::read(s, *pbuffer, u_http_info.clength - body_byte_read, UServer_Base::timeoutMS, request_read_timeout) == false)
-            {
-            u_http_info.nResponseCode  = HTTP_CLIENT_TIMEOUT;
-            U_http_is_connection_close = U_YES;
+      ++p;
+      }
 
-            setResponse(0, 0);
+   U_INTERNAL_DUMP("header_index_num = %u", header_index_num)
+}
 
-            U_RETURN(false);
-            }
+U_NO_EXPORT const char* UHTTP::findHeaderValue(const UString& request, const UString& name, bool nocase)
+{
+   U_TRACE(0, "UHTTP::findHeaderValue(%.*S,%.*S,%b)", U_STRING_TO_TRACE(request), U_STRING_TO_TRACE(name), nocase)
 
-#     ifdef U_HTTP_UPLOAD_PROGRESS_SUPPORT
-         if (USocketExt::byte_read_hook) updateUploadProgress(u_http_info.clength); // done...
-#     endif
-         }
-      }
-   else
-      {
-      U_INTERNAL_DUMP("U_http_chunked = %b", U_http_chunked)
+   U_INTERNAL_ASSERT_MAJOR(u_http_info.szHeader, 0)
 
-      if (U_http_chunked == false)
+   const char* q;
+   uint32_t len    = name.size();
+   const char* p   = request.data() + u_http_info.startHeader;
+   const char* end = p + u_http_info.szHeader;
+
+   // NB: as with the index we match only the whole name at the start of a header line (a continuation start with space)...
+
+   while (p < end)
+      {
+      if ((uint32_t)(end - p) > len &&
+          (memcmp(p, name.data(), len) == 0 ||
+           (nocase && strncasecmp(p, name.data(), len) == 0)))
          {
-         const char* chunk_ptr = getHeaderValuePtr(*pbuffer, *USocket::str_Transfer_Encoding, true);
+         for (q = p + len; q < end && (*q == ' ' || *q == '\t'); ++q) {}
 
-         if (chunk_ptr)
+         if (q < end && *q == ':')
             {
-            if (USocket::str_chunked->equal(chunk_ptr, U_CONSTANT_SIZE("chunked")) == false)
-               {
-               setBadRequest();
-
-               U_RETURN(false);
-               }
+            do { ++q; } while (*q == ' ' || *q == '\t');
 
-            U_http_chunked = true;
+            U_RETURN(q);
             }
          }
 
-      if (U_http_chunked)
-         {
-               char* out;
-         const char* inp;
-         const char* chunk_terminator;
-         uint32_t count, chunkSize, chunk_terminator_len;
-         /* ----------------------------------------------------------------------------------------------------------
-         If a server wants to start sending a response before knowing its total length (like with long script output),
-         it might use the simple chunked transfer-encoding, which breaks the complete response into smaller chunks and
-         sends them in series. You can identify such a response because it contains the "Transfer-Encoding: chunked"
-         header. All HTTP 1.1 clients must be able to receive chunked messages. A chunked message body contains a
+      if ((p = (const char*) memchr(p, '\n', end - p)) == 0) break;
+
+      ++p;
+      }
+
+   U_RETURN((const char*)0);
+}
+
+U_NO_EXPORT const char* UHTTP::getHeaderValuePtr(const UString& request, const UString& name, uint32_t hash, bool nocase)
+{
+   U_TRACE(0, "UHTTP::getHeaderValuePtr(%.*S,%.*S,%u,%b)", U_STRING_TO_TRACE(request), U_STRING_TO_TRACE(name), hash, nocase)
+
+   if (u_http_info.szHeader == 0) U_RETURN((const char*)0);
+
+   const char* ptr = request.data();
+
+   if (header_index_ptr  != (ptr + u_http_info.startHeader) ||
+       header_index_size != u_http_info.szHeader)
+      {
+      header_index_ptr    = ptr + u_http_info.startHeader;
+      header_index_num    = 0;
+      header_index_size   = u_http_info.szHeader;
+      header_index_lookup = 0;
+      }
+
+   if (header_index_num == 0)
+      {
+      if (header_index_lookup++ == 0) return findHeaderValue(request, name, nocase);
+
+      setHeaderIndex(request);
+      }
+
+   if (header_index_num == U_NOT_FOUND) return findHeaderValue(request, name, nocase);
+
+   header_index_entry* entry;
+   uint32_t len = name.size();
+
+   for (uint32_t slot = hash & (U_HTTP_HEADER_INDEX_SIZE-1); header_index[slot].name_len; slot = (slot+1) & (U_HTTP_HEADER_INDEX_SIZE-1))
+      {
+      entry = header_index + slot;
+
+      if (entry->hash     == hash &&
+          entry->name_len == len  &&
+          (memcmp(ptr + entry->name, name.data(), len) == 0 ||
+           (nocase && strncasecmp(ptr + entry->name, name.data(), len) == 0)))
+         {
+         U_RETURN(ptr + entry->value);
+         }
+      }
+
+   U_RETURN((const char*)0);
+}
+
+const char* UHTTP::getHeaderValuePtr(const UString& request, const UString& name, bool nocase)
+{
+   U_TRACE(0, "UHTTP::getHeaderValuePtr(%.*S,%.*S,%b)", U_STRING_TO_TRACE(request), U_STRING_TO_TRACE(name), nocase)
+
+   U_ASSERT_EQUALS(name.find(':'), U_NOT_FOUND)
+
+   if (u_http_info.szHeader) return getHeaderValuePtr(request, name, name.hash(true), nocase);
+
+   U_RETURN((const char*)0);
+}
+
+const char* UHTTP::getHeaderValuePtr(const UString& request, HeaderKnownId id, bool nocase)
+{
+   U_TRACE(0, "UHTTP::getHeaderValuePtr(%.*S,%d,%b)", U_STRING_TO_TRACE(request), id, nocase)
+
+   U_INTERNAL_ASSERT_MINOR(id, HEADER_KNOWN_NUM)
+
+   if (header_known_name[id] == 0) setHeaderKnown(); // NB: UHTTP::ctor() is not called by the client...
+
+   if (u_http_info.szHeader) return getHeaderValuePtr(request, *header_known_name[id], header_known_hash[id], nocase);
+
+   U_RETURN((const char*)0);
+}
+
+const char* UHTTP::getHeaderValuePtr(const UString& name, bool nocase) { return getHeaderValuePtr(*UClientImage_Base::request, name, nocase); }
+const char* UHTTP::getHeaderValuePtr(HeaderKnownId id,    bool nocase) { return getHeaderValuePtr(*UClientImage_Base::request, id,   nocase); }
+
+bool UHTTP::readBody(USocket* s, UString* pbuffer, UString& body)
+{
+   U_TRACE(0, "UHTTP::readBody(%p,%.*S,%.*S)", s, U_STRING_TO_TRACE(*pbuffer), U_STRING_TO_TRACE(body))
+
+   U_INTERNAL_ASSERT(s->isConnected())
+   U_INTERNAL_ASSERT_EQUALS((bool)body, false)
+
+   // NB: check if request includes an entity-body (as indicated by the presence of Content-Length or Transfer-Encoding)
+
+   if (u_http_info.clength)
+      {
+      uint32_t body_byte_read = (pbuffer->size() - u_http_info.endHeader);
+
+      U_INTERNAL_DUMP("pbuffer->size() = %u body_byte_read = %u Content-Length = %u", pbuffer->size(), body_byte_read, u_http_info.clength)
+
+      if (u_http_info.clength > body_byte_read)
+         {
+         if (isRequestTooLarge(*pbuffer))
+            {
+            u_http_info.nResponseCode  = HTTP_ENTITY_TOO_LARGE;
+            U_http_is_connection_close = U_YES;
+
+            setResponse(0, 0);
+
+            U_RETURN(false);
+            }
+
+         // NB: check for 'Expect: 100-continue' (as curl does)...
+
+         if (body_byte_read == 0                                                                                            &&
+             pbuffer->find(*USocket::str_expect_100_continue, u_http_info.startHeader, u_http_info.szHeader) != U_NOT_FOUND &&
+             ((UClientImage_Base::isResponseQueued() &&
+               UServer_Base::pClientImage->flushResponseQueue() == false) ||
+              USocketExt::write(s, U_CONSTANT_TO_PARAM("HTTP/1.1 100 Continue\r\n\r\n"), UServer_Base::timeoutMS) == false))
+            {
+            U_INTERNAL_ASSERT_EQUALS(U_http_version, '1')
+
+            U_RETURN(false);
+            }
+
+#     ifdef U_HTTP_UPLOAD_PROGRESS_SUPPORT
+         if (USocketExt::byte_read_hook)
+            {
+            (void) initUploadProgress(u_http_info.clength);
+
+            if (body_byte_read) updateUploadProgress(body_byte_read);
+            }
+#     endif
+
+         // NB: wait for other data...
+
+         if (USocketExt::read(s, *pbuffer, u_http_info.clength - body_byte_read, UServer_Base::timeoutMS, request_read_timeout) == false)
+            {
+            u_http_info.nResponseCode  = HTTP_CLIENT_TIMEOUT;
+            U_http_is_connection_close = U_YES;
+
+            setResponse(0, 0);
+
+            U_RETURN(false);
+            }
+
+#     ifdef U_HTTP_UPLOAD_PROGRESS_SUPPORT
+         if (USocketExt::byte_read_hook) updateUploadProgress(u_http_info.clength); // done...
+#     endif
+         }
+      }
+   else
+      {
+      U_INTERNAL_DUMP("U_http_chunked = %b", U_http_chunked)
+
+      if (U_http_chunked == false)
+         {
+         const char* chunk_ptr = getHeaderValuePtr(*pbuffer, HEADER_TRANSFER_ENCODING, true);
+
+         if (chunk_ptr)
+            {
+            if (USocket::str_chunked->equal(chunk_ptr, U_CONSTANT_SIZE("chunked")) == false)
+               {
+               setBadRequest();
+
+               U_RETURN(false);
+               }
+
+            U_http_chunked = true;
+            }
+         }
+
+      if (U_http_chunked)
+         {
+               char* out;
+         const char* inp;
+         const char* chunk_terminator;
+         uint32_t count, chunkSize, chunk_terminator_len;
+         /* ----------------------------------------------------------------------------------------------------------
+         If a server wants to start sending a response before knowing its total length (like with long script output),
+         it might use the simple chunked transfer-encoding, which breaks the complete response into smaller chunks and
+         sends them in series. You can identify such a response because it contains the "Transfer-Encoding: chunked"
+         header. All HTTP 1.1 clients must be able to receive chunked messages. A chunked message body contains a
          series of chunks, followed by a line with a single "0" (zero), followed by optional footers (just like headers),
          and a blank line. Each chunk consists of two parts: a line with the size of the chunk data, in hex, possibly
          followed by a semicolon and extra parameters you can ignore (none are currently standard), and ending with
@@ -2346,9 +2843,8 @@ bool UHTTP::checkRequestForHeader(const UString& request)
 
          if (pos1 >= end) U_RETURN(false); // NB: we can have too much advanced...
 
-         pos2 = pos1;
-
-         while (pos2 < end && ptr[pos2] != '\n') ++pos2;
+         p1   = (const char*) memchr(ptr + pos1, '\n', end - pos1); // NB: memchr() of libc is already vectorized...
+         pos2 = (p1 ? p1 - ptr : end);
 
       // U_INTERNAL_DUMP("pos2 = %.*S", 20, request.c_pointer(pos2))
 
@@ -2667,12 +3163,11 @@ bool UHTTP::checkRequestForHeader(const UString& request)
             }
          }
 next:
-      pos2 = pos1;
+      p1 = (const char*) memchr(ptr + pos1, '\n', end - pos1);
 
-      while (ptr[pos2] != '\n')
-         {
-         if (++pos2 >= end) U_RETURN(false); // NB: we can have too much advanced...
-         }
+      if (p1 == 0) U_RETURN(false); // NB: we can have too much advanced...
+
+      pos2 = p1 - ptr;
 
       U_INTERNAL_DUMP("pos2 = %.*S", 10, request.c_pointer(pos2))
 
@@ -2721,178 +3216,360 @@ next:
 // inlining failed in call to ...: call is unlikely and code size would grow
 
 #ifdef U_HTTP_CACHE_REQUEST
+void UHTTP::initRequestCache()
+{
+   U_TRACE(0, "UHTTP::initRequestCache()")
+
+   U_INTERNAL_DUMP("micro_cache_size = %u micro_cache_ttl = %u micro_cache_max_ttl = %u micro_cache_shared_size = %u",
+                    micro_cache_size,     micro_cache_ttl,     micro_cache_max_ttl,     micro_cache_shared_size)
+
+   U_INTERNAL_ASSERT_EQUALS(micro_cache, 0)
+   U_INTERNAL_ASSERT_EQUALS(micro_cache_shared, 0)
+
+   if (micro_cache_size == 0) return;
+
+   if (micro_cache_max_ttl == 0)               micro_cache_max_ttl = 1;
+   if (micro_cache_ttl > micro_cache_max_ttl)  micro_cache_ttl     = micro_cache_max_ttl;
+
+   // NB: the table is direct-mapped on the hash of the key, so we need a power of 2...
+
+   uint32_t n = 1;
+
+   while (n < micro_cache_size) n <<= 1;
+
+   micro_cache_size = n;
+   micro_cache      = (micro_cache_entry*) UMemoryPool::_malloc(micro_cache_size, sizeof(micro_cache_entry), true);
+
+   // NB: we are in the parent before the fork of the children, the area mmap-ed is inherited by all of them...
+
+   if (micro_cache_shared_size &&
+       UServer_Base::preforked_num_kids > 1)
+      {
+      UString path(U_CAPACITY);
+
+      path.snprintf("%s/micro_cache.%P", u_tmpdir);
+
+      micro_cache_shared = U_NEW(UCache);
+
+      if (micro_cache_shared->open(path, micro_cache_shared_size) == false)
+         {
+         U_SRV_LOG("Initialization of micro cache shared between the children failed...");
+
+         delete micro_cache_shared;
+                micro_cache_shared = 0;
+         }
+      else
+         {
+         (void) UFile::_unlink(path.data()); // NB: the mapping remain valid...
+
+         U_INTERNAL_ASSERT_POINTER(U_LOCK_MICRO_CACHE)
+
+         micro_cache_lock = U_NEW(ULock);
+
+         micro_cache_lock->init(U_LOCK_MICRO_CACHE);
+         }
+      }
+
+   U_SRV_LOG("Micro cache of the responses: %u entries, default ttl %u sec (max %u), shared area %u bytes",
+               micro_cache_size, micro_cache_ttl, micro_cache_max_ttl, (micro_cache_shared ? micro_cache_shared_size : 0));
+}
+
 void UHTTP::clearRequestCache()
 {
    U_TRACE(0, "UHTTP::clearRequestCache()")
 
-   U_INTERNAL_DUMP("cbuffer(%u) = %.*S", cbuffer->size(), U_STRING_TO_TRACE(*cbuffer))
+   if (micro_cache)
+      {
+      for (micro_cache_entry* e = micro_cache, *end = micro_cache + micro_cache_size; e < end; ++e)
+         {
+         if (e->key)
+            {
+            e->key->release();
+            e->response->release();
+            }
+         }
+
+      UMemoryPool::_free(micro_cache, micro_cache_size, sizeof(micro_cache_entry));
 
-   cbuffer->clear();
+      micro_cache = 0;
+      }
 
-   U_INTERNAL_DUMP("UServer_Base::sfd = %d", UServer_Base::sfd)
+   if (micro_cache_shared)
+      {
+      delete micro_cache_lock;
+      delete micro_cache_shared;
 
-   if (UServer_Base::sfd) UServer_Base::sfd = 0;
+      micro_cache_lock   = 0;
+      micro_cache_shared = 0;
+      }
 }
 
-int UHTTP::checkRequestCache()
+U_NO_EXPORT bool UHTTP::isMicroCacheMaskMatch(UString* mask)
 {
-   U_TRACE(0, "UHTTP::checkRequestCache()")
+   U_TRACE(0, "UHTTP::isMicroCacheMaskMatch(%p)", mask)
+
+   if (mask &&
+       (u_dosmatch_with_OR(U_HTTP_URI_TO_PARAM,              U_STRING_TO_PARAM(*mask), 0) ||
+        (request_uri->empty() == false                                                    &&
+         u_dosmatch_with_OR(U_STRING_TO_PARAM(*request_uri), U_STRING_TO_PARAM(*mask), 0))))
+      {
+      U_RETURN(true);
+      }
 
-   U_INTERNAL_ASSERT_EQUALS(cbuffer->isNull(), false)
+   U_RETURN(false);
+}
 
-   uint32_t end    = u_http_info.startHeader - 2;
-   const char* ptr = UClientImage_Base::rbuffer->data();
+U_NO_EXPORT void UHTTP::setMicroCacheEntry(micro_cache_entry* e, const UString& key, const UString& response, uint32_t ttl)
+{
+   U_TRACE(0, "UHTTP::setMicroCacheEntry(%p,%.*S,%u,%u)", e, U_STRING_TO_TRACE(key), response.size(), ttl)
 
-   if (cbuffer->compare(0U, end, ptr, end) == 0)
+   if (e->key)
       {
-      int result;
+      e->key->release();
+      e->response->release();
+      }
 
-      if ((end = UClientImage_Base::rbuffer->size()) != cbuffer->size())
-         {
-         const char* p;
-         unsigned char c;
-         bool http_gzip = false;
-         char http_keep_alive = '\0';
+   e->key      = key.rep;
+   e->response = response.rep;
+   e->hash     = micro_cache_hash;
+   e->expire   = u_now->tv_sec + ttl;
 
-         for (uint32_t pos = u_http_info.startHeader; pos < end; ++pos)
-            {
-            U_INTERNAL_DUMP("pos = %.*S", 20, UClientImage_Base::rbuffer->c_pointer(pos))
+   e->key->hold();
+   e->response->hold();
+}
 
-            c = *(p = (ptr + pos));
+/*
+ * The micro-cache is looked up after the parsing of the request (before alias and rewrite rule), the key is made of:
+ *
+ * method, HTTP version, flags of the connection (keep-alive, close), accept gzip, virtual host and URI with the query
+ *
+ * The request with body, range, cookie, authorization or conditional (If-Modified-Since, If-None-Match) are not cacheable, and we don't
+ * store the response that are not 2xx, that go out with sendfile(), that set cookies, that vary on the request headers (Vary) or that ask
+ * for no cache (Cache-Control: no-cache, no-store, private, max-age=0). The ttl of 'Cache-Control: max-age' is capped to MICRO_CACHE_MAX_TTL...
+ */
 
-            U_INTERNAL_DUMP("c = %C", c)
+int UHTTP::checkRequestCache()
+{
+   U_TRACE(0, "UHTTP::checkRequestCache()")
 
-            if (c == '\r') goto end;
+   micro_cache_key_len = 0;
 
-            if (c == 'C')
-               {
-               if (memcmp(ptrC, p+1, 9) == 0) // 9 -> sizeof("onnection")
-                  {
-                  p += 11;
+   if (micro_cache == 0           ||
+       isGETorHEAD() == false     ||
+       U_http_upgrade             ||
+       U_http_range_len           ||
+       u_http_info.clength        ||
+       u_http_info.cookie_len     ||
+       u_http_info.if_modified_since ||
+       (U_HTTP_URI_QUERY_LEN + U_http_host_vlen + 6) > U_MICRO_CACHE_KEY_SIZE ||
+       getHeaderValuePtr(*UClientImage_Base::request, HEADER_AUTHORIZATION, false) ||
+       getHeaderValuePtr(*UClientImage_Base::request, HEADER_IF_NONE_MATCH, false))
+      {
+      U_RETURN(U_PLUGIN_HANDLER_FINISHED);
+      }
 
-                  U_INTERNAL_DUMP("Connection: = %.*S", 13, p-1)
+   char* ptr = micro_cache_key;
 
-                  for (uint32_t i = 0; i < 4; ++i)
-                     {
-                     if (u__toupper(p[i]) == 'K')
-                        {
-                        U_INTERNAL_ASSERT_EQUALS(U_STRNCASECMP(p+i, "keep-alive"), 0);
+   *ptr++ = U_http_method_type;
+   *ptr++ = U_http_version;
+   *ptr++ = U_http_keep_alive;
+   *ptr++ = U_http_is_connection_close;
+   *ptr++ = U_http_is_accept_gzip;
 
-                        http_keep_alive = '1';
+   if (U_http_host_vlen)
+      {
+      U__MEMCPY(ptr, u_http_info.host, U_http_host_vlen);
 
-                        U_INTERNAL_DUMP("http_keep_alive = %C", http_keep_alive)
+      ptr += U_http_host_vlen;
+      }
 
-                        break;
-                        }
-                     }
+   *ptr++ = ' ';
 
-                  if (U_http_is_accept_gzip != '2' || http_gzip) goto end;
+   U__MEMCPY(ptr, u_http_info.uri, U_HTTP_URI_QUERY_LEN);
 
-                  pos = (p - ptr);
-                  }
+   micro_cache_key_len = (ptr - micro_cache_key) + U_HTTP_URI_QUERY_LEN;
+   micro_cache_hash    = u_cdb_hash((unsigned char*)micro_cache_key, micro_cache_key_len, false);
 
-               goto next;
-               }
+   U_INTERNAL_DUMP("micro_cache_key(%u) = %.*S micro_cache_hash = %u", micro_cache_key_len, micro_cache_key_len, micro_cache_key, micro_cache_hash)
 
-            if (U_http_is_accept_gzip != '2' || http_gzip) goto next;
+   U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
 
-            if (c == 'A'                    &&
-                memcmp(ptrA, p+1, 5) ==  0  && // 5 -> sizeof("ccept")
-                             p[6]    == '-' &&
-                    U_MEMCMP(p+7, "Encoding") == 0)
-               {
-               p += 16;
+   micro_cache_entry* e = micro_cache + (micro_cache_hash & (micro_cache_size - 1));
 
-               U_INTERNAL_DUMP("Accept-Encoding: = %.*S", 20, p-1)
+   if (e->key                               &&
+       e->hash == micro_cache_hash          &&
+       e->expire > u_now->tv_sec            &&
+       e->key->equal(micro_cache_key, micro_cache_key_len))
+      {
+      goto hit;
+      }
 
-               p = (const char*) u_find(p, 30, U_CONSTANT_TO_PARAM("gzip"));
+   if (micro_cache_shared)
+      {
+      // NB: if found we copy the entry in the table of this child, it must survive the request...
 
-               if (p && U_STRNCMP(p+4, ";q=0"))
-                  {
-                  http_gzip = true;
+      bool arena = UMemoryArena::active;
 
-                  U_INTERNAL_DUMP("http_gzip = %b", http_gzip)
-                  }
-               }
-next:
-            do { ++pos; } while (pos < end && ptr[pos] != '\n');
-            }
-end:
-         U_INTERNAL_DUMP("U_http_version = %C U_http_keep_alive = %C U_http_is_connection_close = %d U_http_is_accept_gzip = %C",
-                          U_http_version,     U_http_keep_alive,     U_http_is_connection_close,     U_http_is_accept_gzip)
+      UMemoryArena::active = false;
 
-         if (http_keep_alive != U_http_keep_alive ||
-             (http_gzip == false && U_http_is_accept_gzip == '2'))
-            {
-            U_RETURN(U_PLUGIN_HANDLER_FINISHED);
-            }
+      micro_cache_lock->lock();
 
-         (void) cbuffer->_assign(UClientImage_Base::rbuffer->rep);
-         }
+      UString response = micro_cache_shared->get(micro_cache_key, micro_cache_key_len);
+      uint32_t ttl     = 0;
+
+      if (response.empty() == false)
+         {
+         response.duplicate(); // NB: it point to the shared area, that can be overwritten by the other children...
 
-                                               result  = U_PLUGIN_HANDLER_AGAIN;
-      if (U_http_is_connection_close == U_YES) result |= U_PLUGIN_HANDLER_ERROR;
+         ttl = micro_cache_shared->getTTL() - micro_cache_shared->getTime();
+         }
 
-      U_INTERNAL_DUMP("UServer_Base::sfd = %d", UServer_Base::sfd)
+      micro_cache_lock->unlock();
 
-      if (UServer_Base::sfd)
+      if ((int32_t)ttl > 0)
          {
-         U_ASSERT(UClientImage_Base::body->isNull())
-         U_INTERNAL_ASSERT_MAJOR(UServer_Base::count,0)
+         UString key((void*)micro_cache_key, micro_cache_key_len);
 
-         U_INTERNAL_DUMP("UServer_Base::pClientImage->sfd = %d", UServer_Base::pClientImage->sfd)
+         setMicroCacheEntry(e, key, response, ttl);
 
-         U_INTERNAL_ASSERT_EQUALS(UServer_Base::pClientImage->sfd, 0)
+         UMemoryArena::active = arena;
 
-         UServer_Base::pClientImage->sfd    = UServer_Base::sfd;
-         UServer_Base::pClientImage->start  = UServer_Base::start;
-         UServer_Base::pClientImage->count  = UServer_Base::count;
-         UServer_Base::pClientImage->bclose = UServer_Base::bclose;
+         goto hit;
          }
 
-      U_RETURN(result);
+      UMemoryArena::active = arena;
       }
 
    U_RETURN(U_PLUGIN_HANDLER_FINISHED);
+
+hit:
+   int result;
+   const char* p = e->response->data();
+
+   U_INTERNAL_DUMP("response(%u) = %.*S", e->response->size(), U_STRING_TO_TRACE(*(e->response)))
+
+   (void) UClientImage_Base::wbuffer->_assign(e->response);
+
+   micro_cache_key_len       = 0;
+   u_http_info.nResponseCode = (p[9] - '0') * 100 + (p[10] - '0') * 10 + (p[11] - '0'); // NB: "HTTP/1.1 200 OK"...
+
+   if (apache_like_log)
+      {
+      writeApacheLikeLog(true);
+      writeApacheLikeLog(false);
+      }
+
+                                            result  = U_PLUGIN_HANDLER_AGAIN;
+   if (U_http_is_connection_close == U_YES) result |= U_PLUGIN_HANDLER_ERROR;
+
+   U_RETURN(result);
 }
 
 void UHTTP::manageRequestCache()
 {
-   U_TRACE(1, "UHTTP::manageRequestCache()")
+   U_TRACE(0, "UHTTP::manageRequestCache()")
+
+   U_INTERNAL_DUMP("micro_cache_key_len = %u bsendfile = %b U_http_no_cache = %b", micro_cache_key_len, bsendfile, U_http_no_cache)
+
+   if (micro_cache_key_len == 0) return;
 
-   if (isGETorHEAD()                                &&
-       U_IS_HTTP_SUCCESS(u_http_info.nResponseCode) &&
-       U_http_no_cache                 == false     &&
-       UClientImage_Base::isPipeline() == false)
+   uint32_t keylen = micro_cache_key_len,
+            sz1    = UClientImage_Base::wbuffer->size(),
+            sz2    = UClientImage_Base::body->size();
+
+   micro_cache_key_len = 0;
+
+   if (bsendfile                                              ||
+       U_http_no_cache                                        ||
+       UServer_Base::pClientImage->sfd                        ||
+       U_IS_HTTP_SUCCESS(u_http_info.nResponseCode) == false  ||
+       sz1 < U_CONSTANT_SIZE("HTTP/1.1 200 OK\r\n")           ||
+       (sz1 + sz2) > U_MICRO_CACHE_MAX_RESPONSE               ||
+       isMicroCacheMaskMatch(uri_protected_mask)              ||
+       isMicroCacheMaskMatch(uri_request_cert_mask)           ||
+       isMicroCacheMaskMatch(uri_strict_transport_security_mask))
       {
-      U_INTERNAL_ASSERT(cbuffer->isNull())
+      return;
+      }
 
-      (void) cbuffer->_assign(UClientImage_Base::rbuffer->rep);
+   // NB: we check the headers of the response (Set-Cookie, Vary, Cache-Control)...
 
-      U_INTERNAL_DUMP("cbuffer(%u) = %.*S", cbuffer->size(), U_STRING_TO_TRACE(*cbuffer))
+   const char* eol;
+   const char* ptr = UClientImage_Base::wbuffer->data();
+   const char* end = (const char*) u_find(ptr, sz1, U_CONSTANT_TO_PARAM(U_CRLF2));
+   uint32_t ttl    = micro_cache_ttl;
 
-      U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
+   if (end == 0) end = ptr + sz1;
 
-      U_INTERNAL_DUMP("expire        = %ld", UServer_Base::expire)
-      U_INTERNAL_DUMP("u_now->tv_sec = %ld", u_now->tv_sec)
+   for (; ptr < end; ptr = eol + 1)
+      {
+      eol = (const char*) memchr(ptr, '\n', end - ptr);
+
+      if (eol == 0) eol = end;
 
-      UServer_Base::expire = u_now->tv_sec + 1;
+      if (((eol - ptr) > (int)U_CONSTANT_SIZE("Set-Cookie:") &&
+           U_STRNCASECMP(ptr, "Set-Cookie:") == 0) ||
+          ((eol - ptr) > (int)U_CONSTANT_SIZE("Vary:") &&
+           U_STRNCASECMP(ptr, "Vary:") == 0))
+         {
+         return;
+         }
 
-      if (file_data)
+      if ((eol - ptr) > (int)U_CONSTANT_SIZE("Cache-Control:") &&
+          U_STRNCASECMP(ptr, "Cache-Control:") == 0)
          {
-         U_INTERNAL_DUMP("bsendfile = %b", bsendfile)
+         ptr += U_CONSTANT_SIZE("Cache-Control:");
 
-         if (bsendfile)
+         if (u_find(ptr, eol - ptr, U_CONSTANT_TO_PARAM("no-cache")) ||
+             u_find(ptr, eol - ptr, U_CONSTANT_TO_PARAM("no-store")) ||
+             u_find(ptr, eol - ptr, U_CONSTANT_TO_PARAM("private")))
             {
-            U_INTERNAL_DUMP("UServer_Base::pClientImage->sfd   = %d", UServer_Base::pClientImage->sfd)
-            U_INTERNAL_DUMP("UServer_Base::pClientImage->state = %d", UServer_Base::pClientImage->state)
+            return;
+            }
 
-            U_INTERNAL_ASSERT_EQUALS(UServer_Base::sfd, 0)
+         const char* p = (const char*) u_find(ptr, eol - ptr, U_CONSTANT_TO_PARAM("max-age="));
 
-            UServer_Base::sfd = file_data->fd;
-            }
+         if (p)
+            {
+            ttl = strtoul(p + U_CONSTANT_SIZE("max-age="), 0, 10);
+
+            if (ttl == 0) return;
+
+            if (ttl > micro_cache_max_ttl) ttl = micro_cache_max_ttl;
+            }
          }
       }
+
+   U_INTERNAL_DUMP("ttl = %u", ttl)
+
+   if (ttl == 0) return;
+
+   // NB: the entry must survive the request, we don't allocate it on the arena...
+
+   bool arena = UMemoryArena::active;
+
+   UMemoryArena::active = false;
+
+   UString key((void*)micro_cache_key, keylen), response(sz1 + sz2);
+
+             (void) response.append(*UClientImage_Base::wbuffer);
+   if (sz2)  (void) response.append(*UClientImage_Base::body);
+
+   U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
+
+   setMicroCacheEntry(micro_cache + (micro_cache_hash & (micro_cache_size - 1)), key, response, ttl);
+
+   if (micro_cache_shared &&
+       (keylen + sz1 + sz2) <= (micro_cache_shared_size / 4)) // NB: UCache exit if the entry don't fit in the area...
+      {
+      micro_cache_lock->lock();
+
+      micro_cache_shared->add(key, response, ttl);
+
+      micro_cache_lock->unlock();
+      }
+
+   UMemoryArena::active = arena;
 }
 #endif
 
@@ -2915,32 +3592,14 @@ int UHTTP::manageRequest()
    int result = U_PLUGIN_HANDLER_ERROR;
 
 #ifdef U_HTTP_CACHE_REQUEST
-   U_INTERNAL_DUMP("cbuffer(%u) = %.*S",                    cbuffer->size(), U_STRING_TO_TRACE(*cbuffer))
-   U_INTERNAL_DUMP("rbuffer(%u) = %.*S", UClientImage_Base::rbuffer->size(), U_STRING_TO_TRACE(*UClientImage_Base::rbuffer))
-
-   if (cbuffer->isNull() == false)
+   if (UClientImage_Base::isPipeline() == false) UClientImage_Base::initAfterGenericRead();
+   else
       {
-      U_gettimeofday; // NB: optimization if it is enough a time resolution of one second...
-
-      U_INTERNAL_DUMP("expire        = %ld", UServer_Base::expire)
-      U_INTERNAL_DUMP("u_now->tv_sec = %ld", u_now->tv_sec)
-
-      if (UServer_Base::expire >= u_now->tv_sec)
-         {
-         result = checkRequestCache();
-
-         if (result != U_PLUGIN_HANDLER_FINISHED)
-            {
-            if (apache_like_log) writeApacheLikeLog(false);
-
-            U_RETURN(result);
-            }
-         }
+      // NB: with pipelining the response of the previous request is not cleared before...
 
-      clearRequestCache();
+      if (UClientImage_Base::body->isNull() == false) UClientImage_Base::body->clear();
+                                                      UClientImage_Base::wbuffer->clear();
       }
-
-   if (UClientImage_Base::isPipeline() == false) UClientImage_Base::initAfterGenericRead();
 #endif
 
    if (readHeader(UServer_Base::pClientImage->socket, *UClientImage_Base::request) &&
@@ -3057,6 +3716,16 @@ int UHTTP::manageRequest()
    U_ASSERT(isRequestNotFound())
    U_INTERNAL_ASSERT(*UClientImage_Base::request)
 
+#ifdef U_HTTP_CACHE_REQUEST
+   result = checkRequestCache(); // NB: check if the response is in the micro-cache...
+
+   if (result != U_PLUGIN_HANDLER_FINISHED) U_RETURN(result);
+#endif
+
+#if defined(HAVE_SYS_INOTIFY_H) && defined(U_HTTP_INOTIFY_SUPPORT)
+   if (ptr_cache_file_log) checkCacheFileLog(); // NB: apply the change of the document root published by the inotify owner...
+#endif
+
    const char* ptr;
    uint32_t len1, len2;
 
@@ -3463,6 +4132,8 @@ void UHTTP::setCookie(const UString& param)
                keyID->snprintf("%s_%u_%P_%u", UServer_Base::client_address, getUserAgent(), ++sid_counter_gen);
 
                item = *keyID;
+
+               if (data_session) data_session->creation = data_session->last_access = u_now->tv_sec;
                }
 
             // int -- lifetime of the cookie in HOURS -- must (0 -> valid until browser exit)
@@ -3470,6 +4141,18 @@ void UHTTP::setCookie(const UString& param)
             n_hours = (++i < n ? vec[i].strtol() : 0);
             expire  = (n_hours ? u_now->tv_sec + (n_hours * 60L * 60L) : 0L);
 
+            if (n_hours &&
+                UServer_Base::isPreForked())
+               {
+               // NB: the expired sessions are removed from the store after the max lifetime of the cookies (see sweepSession())...
+
+               long old, max_age = n_hours * 60L * 60L;
+
+               do { old = UServer_Base::ptr_shared_data->max_age_http_session; }
+               while (old < max_age &&
+                      __sync_bool_compare_and_swap(&(UServer_Base::ptr_shared_data->max_age_http_session), old, max_age) == false);
+               }
+
             cookie.snprintf("ulib.s%u=", sid_counter_gen);
 
             (void) cookie.append(UServices::generateToken(item, expire)); // HMAC-MD5(data&expire)
@@ -3675,27 +4358,49 @@ bool UHTTP::initSession(const char* location, uint32_t size)
       {
       // NB: the old sessions are automatically invalid because UServer generate the crypto key at startup...
 
+      URDB* db;
       UString pathdb(U_CAPACITY);
 
-      pathdb.snprintf("%s%s", (location[0] == '/' ? "" : U_LIBEXECDIR "/"), location);
+      // NB: the store is open lazily by every process, only the first of them truncate it and start the time of the sweep...
 
-      db_session = U_NEW(URDB(pathdb, false));
+      bool btruncate = __sync_bool_compare_and_swap(&(UServer_Base::ptr_shared_data->sweep_http_session), 0L, u_now->tv_sec);
 
-      bool btruncate = (UServer_Base::pid == 0); // NB: no truncate, if we have started as replacement of child preforked...
+      db_session = UMemoryPool::_malloc(U_HTTP_SESSION_SHARD, sizeof(URDB*), true);
 
-      if (((URDB*)db_session)->open(size, btruncate, true) == false)
+      for (uint32_t i = 0; i < U_HTTP_SESSION_SHARD; ++i)
          {
-         U_SRV_LOG("DB initialization of http session failed...");
+         pathdb.snprintf("%s%s.%u", (location[0] == '/' ? "" : U_LIBEXECDIR "/"), location, i);
 
-         delete (URDB*)db_session;
-                       db_session = 0;
+         db = U_NEW(URDB(pathdb, false));
 
-         U_RETURN(false);
-         }
+         if (db->open(size / U_HTTP_SESSION_SHARD, btruncate, true) == false)
+            {
+            U_SRV_LOG("DB initialization of http session failed...");
+
+            delete db;
+
+            while (i--)
+               {
+               ((URDB**)db_session)[i]->close();
+
+               delete ((URDB**)db_session)[i];
+               }
+
+            UMemoryPool::_free(db_session, U_HTTP_SESSION_SHARD, sizeof(URDB*));
+
+            db_session = 0;
 
-      U_INTERNAL_ASSERT_POINTER(U_LOCK_HTTP_SESSION)
+            U_RETURN(false);
+            }
+
+         U_INTERNAL_ASSERT_POINTER(U_LOCK_HTTP_SESSION(i))
+
+         db->setShared(U_LOCK_HTTP_SESSION(i));
 
-      ((URDB*)db_session)->setShared(U_LOCK_HTTP_SESSION);
+         ((URDB**)db_session)[i] = db;
+         }
+
+      if (UServer_Base::isPreForked()) vsession_cache = (session_cache*) UMemoryPool::_malloc(U_HTTP_SESSION_SEQ, sizeof(session_cache), true);
       }
 
    U_SRV_LOG("DB initialization of http session %s success", location);
@@ -3726,9 +4431,200 @@ U_NO_EXPORT void UHTTP::deleteSession()
       }
    else
       {
-      ((URDB*)db_session)->close();
+      for (uint32_t i = 0; i < U_HTTP_SESSION_SHARD; ++i)
+         {
+         ((URDB**)db_session)[i]->close();
+
+         delete ((URDB**)db_session)[i];
+         }
+
+      UMemoryPool::_free(db_session, U_HTTP_SESSION_SHARD, sizeof(URDB*));
+
+      if (vsession_cache)
+         {
+         for (uint32_t i = 0; i < U_HTTP_SESSION_SEQ; ++i)
+            {
+            if (vsession_cache[i].key)
+               {
+               vsession_cache[i].key->release();
+               vsession_cache[i].data->release();
+               }
+            }
+
+         UMemoryPool::_free(vsession_cache, U_HTTP_SESSION_SEQ, sizeof(session_cache));
+         }
+      }
+}
+
+// NB: the shard is selected by the low bits of the hash of the key, the slot of sequence counter by the others...
+
+U_NO_EXPORT URDB* UHTTP::getSessionShard(const UString& key)
+{
+   U_TRACE(0, "UHTTP::getSessionShard(%.*S)", U_STRING_TO_TRACE(key))
+
+   U_INTERNAL_ASSERT(key)
+   U_INTERNAL_ASSERT_POINTER(db_session)
+
+   uint32_t hash = u_cdb_hash((unsigned char*)key.data(), key.size(), false);
+
+   session_slot = (hash / U_HTTP_SESSION_SHARD) & (U_HTTP_SESSION_SEQ - 1);
+
+   URDB* db = ((URDB**)db_session)[hash & (U_HTTP_SESSION_SHARD - 1)];
+
+   U_INTERNAL_DUMP("shard = %u session_slot = %u", hash & (U_HTTP_SESSION_SHARD - 1), session_slot)
+
+   U_RETURN_POINTER(db, URDB);
+}
+
+U_NO_EXPORT void UHTTP::setSessionCache(const UString& key, const UString& data, uint32_t seq)
+{
+   U_TRACE(0, "UHTTP::setSessionCache(%.*S,%.*S,%u)", U_STRING_TO_TRACE(key), U_STRING_TO_TRACE(data), seq)
+
+   U_INTERNAL_ASSERT_POINTER(vsession_cache)
+
+   session_cache* ptr = vsession_cache + session_slot;
+
+   if (ptr->key)
+      {
+      ptr->key->release();
+      ptr->data->release();
+      }
+
+   // NB: the entry must survive the request, if the strings are on the arena (or they are substring of a string on the arena)
+   //     we copy them out of it, otherwise every entry of the cache pin a chunk of the arena...
+
+   bool arena = UMemoryArena::active;
+
+   UMemoryArena::active = false;
+
+   UString _key = key, _data = data;
+
+   if (UMemoryArena::isArena(_key.data()))  _key.duplicate();
+   if (UMemoryArena::isArena(_data.data())) _data.duplicate();
+
+   UMemoryArena::active = arena;
+
+   ptr->key  = _key.rep;
+   ptr->data = _data.rep;
+   ptr->seq  = seq;
+
+   ptr->key->hold();
+   ptr->data->hold();
+}
+
+// NB: seqlock - the writer (with the lock of the shard) make odd the counter of the slot of the key before the change and even after
+//     it, so the copy of the private cache is valid while the counter is even and equal to the value read with the copy. A write of
+//     another key of the same slot change also the counter, so the copy is at most read again from the shard...
+
+UString UHTTP::getSessionData(const UString& key)
+{
+   U_TRACE(0, "UHTTP::getSessionData(%.*S)", U_STRING_TO_TRACE(key))
+
+   URDB* db                = getSessionShard(key);
+   volatile uint32_t* pseq = UServer_Base::ptr_shared_data->seq_http_session + session_slot;
+
+   if (vsession_cache)
+      {
+      uint32_t seq       = *pseq;
+      session_cache* ptr = vsession_cache + session_slot;
+
+      U_INTERNAL_DUMP("seq = %u ptr->seq = %u", seq, ptr->seq)
+
+      if ((seq & 1) == 0 &&
+          seq == ptr->seq &&
+          ptr->key        &&
+          ptr->key->equal(key.rep))
+         {
+         UString data(ptr->data);
+
+         U_RETURN_STRING(data);
+         }
+      }
+
+   db->lock();
+
+   UString data = (*db)[key];
+
+   if (vsession_cache) setSessionCache(key, data, *pseq);
+
+   db->unlock();
+
+   U_RETURN_STRING(data);
+}
+
+int UHTTP::putSessionData(const UString& key, const UString& data)
+{
+   U_TRACE(0, "UHTTP::putSessionData(%.*S,%.*S)", U_STRING_TO_TRACE(key), U_STRING_TO_TRACE(data))
+
+   URDB* db                = getSessionShard(key);
+   volatile uint32_t* pseq = UServer_Base::ptr_shared_data->seq_http_session + session_slot;
+
+   db->lock();
+
+   // NB: the slot of the key can be shared with keys of other shards (with another lock), so the counter must be changed atomically...
+
+   (void) __sync_add_and_fetch(pseq, 1); // NB: odd -> write in progress...
+
+   int result = (data.empty() ? db->remove(key) : db->store(key, data, RDB_REPLACE));
+
+   (void) __sync_add_and_fetch(pseq, 1);
+
+   if (vsession_cache &&
+       (result == 0 || data.empty()))
+      {
+      setSessionCache(key, data, *pseq);
+      }
+
+   db->unlock();
+
+   U_RETURN(result);
+}
+
+// NB: the storage don't expire...
+
+U_NO_EXPORT void UHTTP::checkForExpiredSession(UStringRep* key, UStringRep* data)
+{
+   U_TRACE(0, "UHTTP::checkForExpiredSession(%.*S,%.*S)", U_STRING_TO_TRACE(*key), U_STRING_TO_TRACE(*data))
+
+   if (key->equal(U_CONSTANT_TO_PARAM(U_STORAGE_KEYID)) == false)
+      {
+      long max_age = U_max(U_ONE_DAY_IN_SECOND, UServer_Base::ptr_shared_data->max_age_http_session);
+
+      if ((u_now->tv_sec - UDataSession::getCreation(data->data())) > max_age) UCDB::addEntryToVector();
+      }
+}
+
+// NB: every U_HTTP_SESSION_SWEEP seconds the first child that arrive remove the expired session of one shard (round robin), so the
+//     scan of the store is spread in time and take the lock of only one shard...
+
+void UHTTP::sweepSession()
+{
+   U_TRACE(0, "UHTTP::sweepSession()")
+
+   long last = UServer_Base::ptr_shared_data->sweep_http_session;
+
+   U_INTERNAL_DUMP("last = %ld", last)
+
+   if ((u_now->tv_sec - last) < U_HTTP_SESSION_SWEEP ||
+       __sync_bool_compare_and_swap(&(UServer_Base::ptr_shared_data->sweep_http_session), last, u_now->tv_sec) == false)
+      {
+      return;
+      }
+
+   UVector<UString> vec;
+   uint32_t shard = __sync_fetch_and_add(&(UServer_Base::ptr_shared_data->shard_http_session), 1) & (U_HTTP_SESSION_SHARD - 1);
+
+   ((URDB**)db_session)[shard]->callForAllEntry(checkForExpiredSession, &vec);
+
+   uint32_t n = vec.size();
+
+   U_INTERNAL_DUMP("shard = %u n = %u", shard, n)
+
+   if (n)
+      {
+      for (uint32_t i = 0; i < n; i += 2) (void) putSessionData(vec[i], UString::getStringNull()); // NB: key, data...
 
-      delete (URDB*)db_session;
+      U_SRV_LOG("Removed %u expired http session from shard %u", n / 2, shard);
       }
 }
 
@@ -3755,7 +4651,7 @@ U_NO_EXPORT void UHTTP::removeDataSession(const UString& token)
       if (UServer_Base::preforked_num_kids == 0) (void) ((UHashMap<UDataSession*>*)db_session)->erase(token);
       else
          {
-         int result = ((URDB*)db_session)->remove(token);
+         int result = putSessionData(token, UString::getStringNull());
 
          if (result) U_SRV_LOG("Remove of session data on db failed with error %d", result);
          }
@@ -3789,16 +4685,16 @@ U_NO_EXPORT void UHTTP::checkDataSession(const UString& token, time_t expire, bo
             }
          else
             {
-            UString data = (*(URDB*)db_session)[token];
+            UString data = getSessionData(token);
 
             if (data.empty() == false)
                {
-               data_session->fromString(data);
+               if (data_session->fromString(data) == false) U_SRV_LOG("Invalid data of session ulib.s%u (size %u), ignored", sid_counter_cur, data.size());
 
                U_INTERNAL_DUMP("data                     = %.*S", U_STRING_TO_TRACE(data))
                U_DUMP(         "data_session->toString() = %.*S", U_STRING_TO_TRACE(data_session->toString()))
 
-               U_ASSERT_EQUALS(data, data_session->toString())
+               U_ASSERT(data_session->data.empty() || data.first_char() != U_DATA_SESSION_VERSION || data == data_session->toString()) // NB: old text format or invalid...
                }
             }
 
@@ -3836,6 +4732,8 @@ bool UHTTP::getDataSession(uint32_t index, UString* value)
 
       U_INTERNAL_DUMP("keyID = %.*S", U_STRING_TO_TRACE(*keyID))
 
+      if (vsession_cache) sweepSession(); // NB: we have the private cache only with preforked children...
+
       if (keyID->empty() == false) goto next;
 
       data_session->clear();
@@ -3882,16 +4780,16 @@ bool UHTTP::getDataStorage(uint32_t index, UString* value)
          }
       else
          {
-         UString data = (*(URDB*)db_session)[UHashMap<void*>::pkey];
+         UString data = getSessionData(U_STRING_FROM_CONSTANT(U_STORAGE_KEYID));
 
          if (data.empty() == false)
             {
-            data_storage->fromString(data);
+            if (data_storage->fromString(data) == false) U_SRV_LOG("Invalid data of session storage (size %u), ignored", data.size());
 
             U_INTERNAL_DUMP("data                     = %.*S", U_STRING_TO_TRACE(data))
             U_DUMP(         "data_storage->toString() = %.*S", U_STRING_TO_TRACE(data_storage->toString()))
 
-            U_ASSERT_EQUALS(data, data_storage->toString())
+            U_ASSERT(data_storage->data.empty() || data.first_char() != U_DATA_SESSION_VERSION || data == data_storage->toString()) // NB: old text format or invalid...
             }
          }
 
@@ -3948,7 +4846,7 @@ void UHTTP::putDataSession(uint32_t index, const char* value, uint32_t size)
 
       U_INTERNAL_ASSERT(data)
 
-      int result = ((URDB*)db_session)->store(*keyID, data, RDB_REPLACE);
+      int result = putSessionData(*keyID, data);
 
       if (result) U_SRV_LOG("Store of session data on db failed with error %d", result);
       }
@@ -3997,7 +4895,7 @@ void UHTTP::putDataStorage(uint32_t index, const char* value, uint32_t size)
 
       U_INTERNAL_ASSERT(data)
 
-      int result = ((URDB*)db_session)->store(UHashMap<void*>::pkey, data, RDB_REPLACE);
+      int result = putSessionData(U_STRING_FROM_CONSTANT(U_STORAGE_KEYID), data);
 
       if (result) U_SRV_LOG("Store of data on db failed with error %d", result);
       }
@@ -4943,7 +5841,7 @@ U_NO_EXPORT bool UHTTP::processAuthorization()
 
    bool result = false;
 
-   const char* ptr = getHeaderValuePtr(*USocket::str_authorization, false);
+   const char* ptr = getHeaderValuePtr(HEADER_AUTHORIZATION, false);
 
    if (ptr == 0) U_RETURN(false);
 
@@ -5603,6 +6501,8 @@ next:
       }
 
 end:
+   file_data->setReadyResponse();
+
    U_SRV_LOG("File cached: %S - %u bytes - (%d%%) compressed ratio%s", pathname->data(), file_data->size, 100 - ratio, (motivation ? motivation : ""));
 }
 
@@ -5972,12 +6872,34 @@ U_NO_EXPORT void UHTTP::manageDataForCache()
 
                U_INTERNAL_DUMP("cgi->interpreter = %S", cgi->interpreter)
 
+               // NB: the shell script of the ULib facility receive the form data as arguments of the command, they can't be served by a pool...
+
+               cgi->pool = 0;
+
+               if (vcgi_pool_mask &&
+                   cgi->sh_script == false)
+                  {
+                  for (uint32_t i = 0, n = vcgi_pool_mask->size(); (i+1) < n; i += 2)
+                     {
+                     if (u_dosmatch_with_OR(U_STRING_TO_PARAM(*pathname), U_STRING_TO_PARAM((*vcgi_pool_mask)[i]), 0))
+                        {
+                        long num = (*vcgi_pool_mask)[i+1].strtol();
+
+                        cgi->pool = (num <= 0 ? 1 : num > 127 ? 127 : num);
+
+                        break;
+                        }
+                     }
+                  }
+
+               U_INTERNAL_DUMP("cgi->pool = %d", cgi->pool)
+
                file_data->ptr        = cgi;
                file_data->mime_index = U_cgi;
 
                const char* link = (cache_file->callForAllEntry(checkIfLink), file_data->link) ? " (link)" : "";
 
-               U_SRV_LOG("cgi-bin found: %.*S%s, interpreter registered: %S", U_FILE_TO_TRACE(*file), link, cgi->interpreter);
+               U_SRV_LOG("cgi-bin found: %.*S%s, interpreter registered: %S, pool of runner: %d", U_FILE_TO_TRACE(*file), link, cgi->interpreter, cgi->pool);
                }
             }
          }
@@ -6056,6 +6978,12 @@ bool UHTTP::isFileInCache()
 
    file_data = getFileInCache(file->getPathRelativ(), file->getPathRelativLen());
 
+   if (UServer_Base::pmetrics) // per-child metrics...
+      {
+      if (file_data) UServer_Base::pmetrics->cache_hit++;
+      else           UServer_Base::pmetrics->cache_miss++;
+      }
+
    if (file_data)
       {
       file->st_size  = file_data->size;
@@ -6132,12 +7060,121 @@ UString UHTTP::getDataFromCache(bool bheader, bool gzip)
    U_RETURN_STRING(result);
 }
 
+void UHTTP::UFileCacheData::setReadyResponse()
+{
+   U_TRACE(0, "UFileCacheData::setReadyResponse()")
+
+   U_INTERNAL_ASSERT_POINTER(array)
+
+   // NB: only for the small files, for major size we use sendfile() or the write can be partial...
+
+   if (mime_index == U_ssi) return;
+
+   UString content, header;
+   uint32_t hsz, csz, n = array->size() / 2;
+
+   for (uint32_t gzip = 0; gzip < n; ++gzip)
+      {
+      content = array->at(gzip * 2);
+      header  = array->at(gzip * 2 + 1);
+
+      hsz = header.size();
+      csz = content.size();
+
+      U_INTERNAL_DUMP("gzip = %u hsz = %u csz = %u", gzip, hsz, csz)
+
+      if (hsz == 0                                 ||
+          (hsz + csz) > U_MIN_SIZE_FOR_PARTIAL_WRITE ||
+          (gzip == 0 && csz >= min_size_for_sendfile))
+         {
+         continue;
+         }
+
+      if (response[gzip]) delete response[gzip];
+
+      response[gzip] = U_NEW(UString(hsz + csz));
+
+      (void) response[gzip]->append(header);
+      (void) response[gzip]->append(content);
+      }
+}
+
+U_NO_EXPORT void UHTTP::setReadyResponsePrefix()
+{
+   U_TRACE(0, "UHTTP::setReadyResponsePrefix()")
+
+   static const char* connection[3] = { "", "Connection: close\r\n", "Connection: Keep-Alive\r\n" };
+
+   char ext[U_READY_RESPONSE_PREFIX];
+   uint32_t len;
+
+   ready_response_time = u_now->tv_sec;
+
+   for (int i = 0; i < 3; ++i)
+      {
+      // NB: with the time cached by the thread the format %D don't consume the argument, so it must be the last...
+
+      len  = u__snprintf(ext,       sizeof(ext),       "Date: %12D\r\n", 0);
+      len += u__snprintf(ext + len, sizeof(ext) - len, "%s", connection[i]);
+
+      // NB: the same bytes of getHeaderForResponse() for a HTTP/1.1 response '200 OK'...
+
+      ready_response_prefix_len[i] = u__snprintf(ready_response_prefix[i], U_READY_RESPONSE_PREFIX, str_frm_header->data(),
+                                                 '1', HTTP_OK, getStatusDescription(HTTP_OK), len, ext, 0, "");
+
+      U_INTERNAL_ASSERT_MINOR(ready_response_prefix_len[i], U_READY_RESPONSE_PREFIX)
+      }
+}
+
+U_NO_EXPORT bool UHTTP::processReadyResponse()
+{
+   U_TRACE(0, "UHTTP::processReadyResponse()")
+
+   U_INTERNAL_ASSERT_POINTER(file_data)
+   U_INTERNAL_ASSERT_EQUALS(U_http_version, '1')
+   U_INTERNAL_ASSERT_EQUALS(u_http_info.nResponseCode, HTTP_OK)
+
+   bool gzip = (U_http_is_accept_gzip && isDataCompressFromCache());
+
+   UString header = getDataFromCache(true, gzip); // NB: it can renew the entry...
+
+   UString* response = file_data->response[gzip];
+
+   U_INTERNAL_DUMP("gzip = %b header(%u) response = %p", gzip, header.size(), response)
+
+   if (response == 0) U_RETURN(false);
+
+   U_INTERNAL_ASSERT(header.empty() == false)
+
+   if (u_now->tv_sec != ready_response_time) setReadyResponsePrefix();
+
+   int i = (U_http_is_connection_close == U_YES ? (UClientImage_Base::isPipeline() == false)
+                                                : (U_http_keep_alive == '1') * 2);
+
+   // NB: the ready response is read-only (it can be in the area shared by the children), the prefix go in wbuffer...
+
+   (void) UClientImage_Base::wbuffer->replace(ready_response_prefix[i], ready_response_prefix_len[i]);
+
+   *UClientImage_Base::body = (isHEAD() ? response->substr(0U, header.size()) : *response);
+
+   if (gzip) U_http_is_accept_gzip = '2';
+
+   U_RETURN(true);
+}
+
 U_NO_EXPORT bool UHTTP::processFileCache()
 {
    U_TRACE(0, "UHTTP::processFileCache()")
 
    U_INTERNAL_ASSERT_POINTER(file_data)
 
+   if (U_http_version   == '1' &&
+       U_http_range_len == 0   &&
+       u_is_ssi()       == false)
+      {
+      if (processReadyResponse()) U_RETURN(true);
+      }
+
    if (U_http_is_accept_gzip &&
        isDataCompressFromCache())
       {
@@ -6167,14 +7204,9 @@ U_NO_EXPORT bool UHTTP::processFileCache()
    if (U_http_range_len &&
        checkGetRequestIfRange(UString::getStringNull()))
       {
-      if (checkGetRequestForRange(header, getDataFromCache(false, false)) != U_PARTIAL) // NB: we have a complete response...
-         {
-#     ifdef U_CLIENT_RESPONSE_PARTIAL_WRITE_SUPPORT
-         goto prepare_for_partial_write_at_response;
-#     else
-         U_RETURN(true);
-#     endif
-         }
+      // NB: with a complete response (multipart/byteranges or error) the file descriptor can't be used for a partial write...
+
+      if (checkGetRequestForRange(header, getDataFromCache(false, false)) != U_PARTIAL) U_RETURN(true);
 
       // NB: range_start is modified only if we have as response from checkGetRequestForRange() U_PARTIAL...
 
@@ -6209,8 +7241,6 @@ build_response:
       *UClientImage_Base::wbuffer = getHeaderForResponse(header, false);
 
 #ifdef U_CLIENT_RESPONSE_PARTIAL_WRITE_SUPPORT
-prepare_for_partial_write_at_response:
-
       if (bsendfile == false          &&
 #        ifdef USE_LIBSSL
           UServer_Base::bssl == false &&
@@ -6509,15 +7539,21 @@ U_NO_EXPORT bool UHTTP::runDynamicPage(UString* penvironment)
 
       if (cgi->sh_script) setCGIShellScript(command);
 
-      UCommand cmd(command);
+      // NB: the CGI of a mask of CGI_POOL are served by the pool of runner, if they don't cooperate we fallback to fork and exec...
+
+      if (cgi->pool == 0 ||
+          processCGIPool(cgi, command, penvironment) == false)
+         {
+         UCommand cmd(command);
 
-      // NB: if server is no preforked (ex: nodog) process the HTTP CGI request with fork....
+         // NB: if server is no preforked (ex: nodog) process the HTTP CGI request with fork....
 
-      async = (as_service == false                   &&
-               UServer_Base::preforked_num_kids == 0 &&
-               UClientImage_Base::isPipeline()  == false);
+         async = (as_service == false                   &&
+                  UServer_Base::preforked_num_kids == 0 &&
+                  UClientImage_Base::isPipeline()  == false);
 
-      (void) processCGIRequest(cmd, penvironment, cgi_dir, async);
+         (void) processCGIRequest(cmd, penvironment, cgi_dir, async);
+         }
       }
 
    if (form_name_value->size()) resetForm(true);
@@ -6827,7 +7863,7 @@ UString UHTTP::getCGIEnvironment(bool bHTTP_Variables)
 
    // The hostname of your server from header's request.
    // The difference between HTTP_HOST and U_HTTP_VHOST is that
-   // HTTP_HOST can include the :PORT text, and U_HTTP_VHOST only the name
+   // HTTP_HOST can include the �:PORT� text, and U_HTTP_VHOST only the name
 
    if (U_http_host_len)
       {
@@ -7318,226 +8354,607 @@ no_headers: // NB: we assume to have HTML without HTTP headers...
                   if (XSendfile(*pathname, ext)) U_RETURN(true);
                   }
 
-               goto error;
-               }
-            }
-         break;
+               goto error;
+               }
+            }
+         break;
+
+         case 'S':
+            {
+            // check if is used to give the server an HTTP status line to send to the client...
+            // ---------------------------------------------------------------------------------------------------------------------------------------------
+            // Ex: "Status: 503 Service Unavailable\r\nX-Powered-By: PHP/5.2.6-pl7-gentoo\r\nContent-Type: text/html;charset=utf-8\r\n\r\n<!DOCTYPE html"...
+
+            U_INTERNAL_DUMP("check 'Status: ...'")
+
+            if (U_STRNEQ(ptr+1, "tatus: "))
+               {
+               location = ptr + U_CONSTANT_SIZE("Status: ");
+
+               u_http_info.nResponseCode = strtol(location, 0, 0);
+
+               U_INTERNAL_DUMP("u_http_info.nResponseCode = %d", u_http_info.nResponseCode)
+
+               location = (const char*) memchr(location, '\n', sz);
+
+               if (location)
+                  {
+                  uint32_t diff = (location - ptr) + 1; // NB: we cut also \n...
+
+                  U_INTERNAL_ASSERT_MINOR(diff,512)
+                  U_INTERNAL_ASSERT_MINOR(diff, endHeader)
+
+                  sz        -= diff;
+                  endHeader -= diff;
+
+                  U_INTERNAL_DUMP("diff = %u sz = %u endHeader = %u", diff, sz, endHeader)
+
+                  UClientImage_Base::wbuffer->erase(0, diff);
+
+                  U_INTERNAL_DUMP("wbuffer(%u) = %.*S", sz, U_STRING_TO_TRACE(*UClientImage_Base::wbuffer))
+
+                  U_ASSERT_EQUALS(sz, UClientImage_Base::wbuffer->size())
+
+                  ptr    = UClientImage_Base::wbuffer->data();
+                  endptr = UClientImage_Base::wbuffer->c_pointer(endHeader);
+
+                  continue;
+                  }
+
+               goto error;
+               }
+
+            // ULIB facility: check for request TODO timed session cookies...
+
+            U_INTERNAL_DUMP("check 'Set-Cookie: TODO['")
+
+            if (U_STRNEQ(ptr+1, "et-Cookie: TODO["))
+               {
+               uint32_t pos1,
+                        pos2 = U_CONSTANT_SIZE("Set-Cookie: "),
+                        n1   = U_CONSTANT_SIZE("TODO[");
+
+               ptr += pos2;
+               pos1 = UClientImage_Base::wbuffer->distance(ptr);
+
+               ptr     += n1;
+               location = ptr;
+
+               ptr = (const char*) memchr(location, ']', sz);
+
+               if (ptr)
+                  {
+                  uint32_t len = ptr - location;
+
+                  n1 += len + 1; // ']'
+
+                  setCookie(UClientImage_Base::wbuffer->substr(location, len));
+
+                  uint32_t n2   = set_cookie->size() - pos2,
+                           diff = n2 - n1;
+
+                  sz        += diff;
+                  endHeader += diff;
+
+                  U_INTERNAL_DUMP("diff = %u sz = %u endHeader = %u", diff, sz, endHeader)
+
+                  U_INTERNAL_ASSERT_MINOR(diff,512)
+
+                  (void) UClientImage_Base::wbuffer->replace(pos1, n1, *set_cookie, pos2, n2);
+
+                  set_cookie->setEmpty();
+
+                  U_INTERNAL_DUMP("wbuffer(%u) = %#.*S", UClientImage_Base::wbuffer->size(), U_STRING_TO_TRACE(*UClientImage_Base::wbuffer))
+
+                  U_ASSERT_EQUALS(sz, UClientImage_Base::wbuffer->size())
+
+                  // for next parsing...
+
+                  ptr    = UClientImage_Base::wbuffer->c_pointer(pos1 + n2 + 2);
+                  endptr = UClientImage_Base::wbuffer->c_pointer(endHeader);
+
+                  continue;
+                  }
+
+               goto error;
+               }
+            }
+         break;
+
+         case 'C':
+            {
+            // check if is used to specify to the server to close the connection...
+
+            U_INTERNAL_DUMP("check 'Connection: close'")
+
+            if (U_STRNEQ(ptr+1, "onnection: close"))
+               {
+               connection_close = true;
+
+               ptr += U_CONSTANT_SIZE("Connection: close") + 2;
+
+               continue;
+               }
+
+            U_INTERNAL_DUMP("check 'Content-...: ...'")
+
+            if (U_STRNEQ(ptr+1, "ontent-"))
+               {
+               ptr += U_CONSTANT_SIZE("Content-");
+
+               char c = u__toupper(*ptr++);
+
+               if (c == 'T' &&
+                   U_STRNEQ(ptr, "ype: "))
+                  {
+                  ptr += U_CONSTANT_SIZE("ype: ");
+
+                  header_content_type = true;
+
+                  U_INTERNAL_DUMP("header_content_type = %b", header_content_type)
+
+                  if (U_STRNEQ(ptr, "text/") == false) content_encoding = true;
+
+                  U_INTERNAL_DUMP("content_encoding = %b", content_encoding)
+                  }
+               else if (c == 'L' &&
+                        U_STRNEQ(ptr, "ength:"))
+                  {
+                  ptr += U_CONSTANT_SIZE("ength:");
+
+                  header_content_length = true;
+
+                  U_INTERNAL_DUMP("header_content_length = %b", header_content_length)
+
+                  uint32_t pos = UClientImage_Base::wbuffer->distance(ptr);
+
+                  if (checkContentLength(*UClientImage_Base::wbuffer, u_http_info.clength, pos)) // NB: with drupal can happens...!!!
+                     {
+                     sz     = UClientImage_Base::wbuffer->size();
+                     ptr    = UClientImage_Base::wbuffer->c_pointer(pos);
+                     endptr = UClientImage_Base::wbuffer->c_pointer(endHeader);
+                     }
+                  }
+               else if (c == 'E' &&
+                        U_STRNEQ(ptr, "ncoding: "))
+                  {
+                  content_encoding = true;
+
+                  ptr += U_CONSTANT_SIZE("ncoding: ");
+                  }
+               }
+            }
+         break;
+         }
+
+      ptr = (const char*) memchr(ptr, '\n', sz);
+
+      if (ptr == 0) goto error;
+
+      ++ptr;
+      }
+
+   U_INTERNAL_ASSERT_MAJOR(endHeader, 0)
+
+   U_INTERNAL_DUMP("u_http_info.clength = %u", u_http_info.clength)
+
+   if (u_http_info.clength)
+      {
+      if (header_content_length)
+         {
+         *UClientImage_Base::body    = *UClientImage_Base::wbuffer;
+         *UClientImage_Base::wbuffer = getHeaderForResponse(*str_ulib_header, connection_close);
+         }
+      else
+         {
+         bool bcompress = (content_encoding == false && isCompressable());
+
+         setCgiResponse(header_content_type, bcompress, connection_close);
+         }
+      }
+   else
+      {
+      // NB: no body...it's ok Content-Length: 0...
+
+      if (header_content_length == false)
+         {
+         u_http_info.nResponseCode = HTTP_NO_CONTENT;
+
+         (void) UClientImage_Base::wbuffer->insert(0, U_CONSTANT_TO_PARAM("Content-Length: 0\r\n"));
+         }
+
+      UClientImage_Base::body->clear();
+
+      *UClientImage_Base::wbuffer = getHeaderForResponse(*UClientImage_Base::wbuffer, connection_close);
+      }
+
+   U_RETURN(true);
+
+error:
+   U_SRV_LOG("WARNING: UHTTP::processCGIOutput() failed...");
+
+   setInternalError(); // set internal error response...
+
+   U_RETURN(false);
+}
+
+// -----------------------------------------------------------------------------------------------------------------------------
+// CGI_POOL: the runners of a CGI accept() the connections on a UNIX socket in the abstract namespace that they receive as stdin
+// (as with spawn-fcgi), the name depend only from the port of the server and the command, so the pool is shared by all the
+// preforked children and it is spawned again by the first child that find nobody listening on the name...
+// -----------------------------------------------------------------------------------------------------------------------------
+
+#define U_FCGI_HEADER_LEN    8
+#define U_FCGI_BEGIN_REQUEST 1
+#define U_FCGI_END_REQUEST   3
+#define U_FCGI_PARAMS        4
+#define U_FCGI_STDIN         5
+#define U_FCGI_STDOUT        6
+
+static void appendFCGIRecord(UString& x, char type, uint16_t request_id, const char* data, uint32_t len)
+{
+   U_TRACE(0, "appendFCGIRecord(%.*S,%C,%u,%.*S,%u)", U_STRING_TO_TRACE(x), type, request_id, len, data, len)
+
+   // NB: the content of a record is at most 65535 bytes...
+
+   uint32_t n;
+   char header[U_FCGI_HEADER_LEN] = { 1, type, (char)(request_id >> 8), (char)request_id, 0, 0, 0, 0 };
+
+   do {
+      n = U_min(len, 65535U);
+
+      header[4] = (char)(n >> 8);
+      header[5] = (char) n;
+
+      (void) x.append(header, U_FCGI_HEADER_LEN);
+
+      if (n)
+         {
+         (void) x.append(data, n);
+
+         data += n;
+         len  -= n;
+         }
+      }
+   while (len);
+}
+
+static char* setFCGILength(char* ptr, uint32_t len)
+{
+   U_TRACE(0, "setFCGILength(%p,%u)", ptr, len)
+
+   if (len < 0x80) *ptr++ = (char)len;
+   else
+      {
+      *ptr++ = (char)((len >> 24) | 0x80);
+      *ptr++ = (char) (len >> 16);
+      *ptr++ = (char) (len >>  8);
+      *ptr++ = (char)  len;
+      }
+
+   return ptr;
+}
+
+// NB: the request of the responder role: the environment is sent as params (u_split() write on it) and the body as stdin...
+
+UString UHTTP::getFCGIRequest(UString& environment, uint16_t request_id, bool keep_conn)
+{
+   U_TRACE(0, "UHTTP::getFCGIRequest(%.*S,%u,%b)", U_STRING_TO_TRACE(environment), request_id, keep_conn)
+
+   char* ptr;
+   char* equalPtr;
+   char* argp[U_MAX_ARGS];
+   char buffer[U_FCGI_HEADER_LEN];
+   int32_t i, n, nameLen, valueLen;
+   UString params(U_CAPACITY), request(U_CAPACITY);
+
+   // FCGI_BEGIN_REQUEST: role FCGI_RESPONDER, flags FCGI_KEEP_CONN (the application don't close the connection after the response)...
+
+   (void) U_SYSCALL(memset, "%p,%d,%u", buffer, 0, U_FCGI_HEADER_LEN);
+
+   buffer[1] = 1;
+   buffer[2] = keep_conn;
+
+   appendFCGIRecord(request, U_FCGI_BEGIN_REQUEST, request_id, buffer, U_FCGI_HEADER_LEN);
+
+   n = u_split(U_STRING_TO_PARAM(environment), argp, 0);
+
+   for (i = 0; i < n; ++i)
+      {
+      equalPtr = strchr(argp[i], '=');
+
+      if (equalPtr == 0) continue;
+
+       nameLen = (equalPtr - argp[i]);
+      valueLen = u__strlen(++equalPtr, __PRETTY_FUNCTION__);
+
+      ptr = setFCGILength(buffer, nameLen);
+      ptr = setFCGILength(ptr,   valueLen);
+
+      (void) params.append(buffer, ptr - buffer);
+      (void) params.append(argp[i], nameLen);
+      (void) params.append(equalPtr, valueLen);
+      }
+
+   appendFCGIRecord(request, U_FCGI_PARAMS, request_id, U_STRING_TO_PARAM(params));
+   appendFCGIRecord(request, U_FCGI_PARAMS, request_id, 0, 0);
+
+   // maybe we have some data to put on stdin of cgi process (POST)
+
+   U_INTERNAL_DUMP("UClientImage_Base::body(%u) = %.*S", UClientImage_Base::body->size(), U_STRING_TO_TRACE(*UClientImage_Base::body))
+
+   if (UClientImage_Base::body->empty() == false) appendFCGIRecord(request, U_FCGI_STDIN, request_id, U_STRING_TO_PARAM(*UClientImage_Base::body));
+
+   appendFCGIRecord(request, U_FCGI_STDIN, request_id, 0, 0);
+
+   U_RETURN_STRING(request);
+}
+
+U_NO_EXPORT int UHTTP::connectCGIPool(ucgi* cgi, const UString& command, bool& bspawn)
+{
+   U_TRACE(1, "UHTTP::connectCGIPool(%p,%.*S,%b)", cgi, U_STRING_TO_TRACE(command), bspawn)
+
+   U_INTERNAL_ASSERT_MAJOR(cgi->pool, 0)
+
+   static int fd_stderr = UServices::getDevNull("/tmp/processCGIRequest.err");
+
+   int fd, lfd;
+   pid_t pid;
+   bool btry = true;
+   socklen_t len;
+   struct sockaddr_un addr;
+
+   (void) U_SYSCALL(memset, "%p,%d,%u", &addr, 0, sizeof(addr));
+
+   // NB: in the abstract namespace (the first byte of the name is '\0') the name disappear when the last runner of the pool exit...
+
+   addr.sun_family = AF_UNIX;
+
+   len = offsetof(struct sockaddr_un, sun_path) + 1 +
+         u__snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "userver_cgi.%u.%u", UServer_Base::port,
+                     u_cdb_hash((unsigned char*)U_STRING_TO_PARAM(command), false));
+
+   fd = U_SYSCALL(socket, "%d,%d,%d", AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+   if (fd == -1) U_RETURN(-1);
+
+loop:
+   if (U_SYSCALL(connect, "%d,%p,%d", fd, (sockaddr*)&addr, len) == 0)
+      {
+      // NB: in the abstract namespace the name has no permission, anybody can bind it before us. The request carry the cookies,
+      //     the authorization and the body of the client, so we send it only to a runner with our credentials...
+
+      struct ucred cred = { 0, 0, 0 };
+      socklen_t cred_len = sizeof(struct ucred);
+
+      if (U_SYSCALL(getsockopt, "%d,%d,%d,%p,%p", fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) == 0 &&
+          cred.uid == (uid_t) U_SYSCALL_NO_PARAM(geteuid))
+         {
+         U_RETURN(fd);
+         }
+
+      U_SRV_LOG("WARNING: the socket of the runners of the CGI %.*S is held by the process %d of the user %u, we use fork and exec for every request",
+                  U_STRING_TO_TRACE(command), cred.pid, cred.uid);
+
+      cgi->pool = 0;
+
+      goto end;
+      }
+
+   if (btry &&
+       errno == ECONNREFUSED)
+      {
+      btry = false;
+
+      // NB: if another child is spawning the pool the bind() fail with EADDRINUSE and we try only to connect again...
+
+      lfd = U_SYSCALL(socket, "%d,%d,%d", AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
 
-         case 'S':
+      if (lfd != -1)
+         {
+         if (U_SYSCALL(bind,   "%d,%p,%d", lfd, (sockaddr*)&addr, len) == 0 &&
+             U_SYSCALL(listen, "%d,%d",    lfd, U_CGI_POOL_BACKLOG)   == 0)
             {
-            // check if is used to give the server an HTTP status line to send to the client...
-            // ---------------------------------------------------------------------------------------------------------------------------------------------
-            // Ex: "Status: 503 Service Unavailable\r\nX-Powered-By: PHP/5.2.6-pl7-gentoo\r\nContent-Type: text/html;charset=utf-8\r\n\r\n<!DOCTYPE html"...
+            // NB: double fork, the runners must not be our children (nobody wait for them) but they must be in our process
+            //     group (the SIGTERM that the monitoring process send to the process group when we go down must reach them)...
 
-            U_INTERNAL_DUMP("check 'Status: ...'")
+            pid = U_FORK();
 
-            if (U_STRNEQ(ptr+1, "tatus: "))
+            if (pid == 0)
                {
-               location = ptr + U_CONSTANT_SIZE("Status: ");
+               // NB: the runners live after us and they must not inherit our descriptors (the listening socket of the server
+               //     above all: with SO_REUSEPORT a socket held by a process that never accept() get its share of the connections)...
 
-               u_http_info.nResponseCode = strtol(location, 0, 0);
-
-               U_INTERNAL_DUMP("u_http_info.nResponseCode = %d", u_http_info.nResponseCode)
+               struct rlimit nofile;
 
-               location = (const char*) memchr(location, '\n', sz);
+               int maxfd = (::getrlimit(RLIMIT_NOFILE, &nofile) == 0 ? (int)nofile.rlim_cur : 1024);
 
-               if (location)
+               for (int i = STDERR_FILENO + 1; i < maxfd; ++i)
                   {
-                  uint32_t diff = (location - ptr) + 1; // NB: we cut also \n...
-
-                  U_INTERNAL_ASSERT_MINOR(diff,512)
-                  U_INTERNAL_ASSERT_MINOR(diff, endHeader)
+                  if (i != lfd &&
+                      i != fd_stderr)
+                     {
+                     (void) ::close(i);
+                     }
+                  }
 
-                  sz        -= diff;
-                  endHeader -= diff;
+               if (cgi->dir[0]) (void) UFile::chdir(cgi->dir, false);
 
-                  U_INTERNAL_DUMP("diff = %u sz = %u endHeader = %u", diff, sz, endHeader)
+               UCommand cmd(command);
 
-                  UClientImage_Base::wbuffer->erase(0, diff);
+               for (int i = 0; i < cgi->pool; ++i) (void) cmd.execute(0, 0, lfd, fd_stderr);
 
-                  U_INTERNAL_DUMP("wbuffer(%u) = %.*S", sz, U_STRING_TO_TRACE(*UClientImage_Base::wbuffer))
+               ::_exit(0);
+               }
 
-                  U_ASSERT_EQUALS(sz, UClientImage_Base::wbuffer->size())
+            if (pid > 0) (void) UProcess::waitpid(pid, 0, 0);
 
-                  ptr    = UClientImage_Base::wbuffer->data();
-                  endptr = UClientImage_Base::wbuffer->c_pointer(endHeader);
+            bspawn = true;
 
-                  continue;
-                  }
+            U_SRV_LOG("spawned pool of %d runner for the CGI: %.*S", cgi->pool, U_STRING_TO_TRACE(command));
+            }
 
-               goto error;
-               }
+         (void) U_SYSCALL(close, "%d", lfd);
+         }
 
-            // ULIB facility: check for request TODO timed session cookies...
+      goto loop;
+      }
 
-            U_INTERNAL_DUMP("check 'Set-Cookie: TODO['")
+end:
+   (void) U_SYSCALL(close, "%d", fd);
 
-            if (U_STRNEQ(ptr+1, "et-Cookie: TODO["))
-               {
-               uint32_t pos1,
-                        pos2 = U_CONSTANT_SIZE("Set-Cookie: "),
-                        n1   = U_CONSTANT_SIZE("TODO[");
+   U_RETURN(-1);
+}
 
-               ptr += pos2;
-               pos1 = UClientImage_Base::wbuffer->distance(ptr);
+U_NO_EXPORT bool UHTTP::processCGIPool(ucgi* cgi, const UString& command, UString* penv)
+{
+   U_TRACE(1, "UHTTP::processCGIPool(%p,%.*S,%p)", cgi, U_STRING_TO_TRACE(command), penv)
 
-               ptr     += n1;
-               location = ptr;
+   U_INTERNAL_ASSERT_MAJOR(cgi->pool, 0)
 
-               ptr = (const char*) memchr(location, ']', sz);
+   UCommand cmd(command);
 
-               if (ptr)
-                  {
-                  uint32_t len = ptr - location;
+   if (cmd.checkForExecute() == false)
+      {
+      setForbidden();
 
-                  n1 += len + 1; // ']'
+      U_RETURN(true);
+      }
 
-                  setCookie(UClientImage_Base::wbuffer->substr(location, len));
+   bool bspawn = false;
+   int fd = connectCGIPool(cgi, command, bspawn);
 
-                  uint32_t n2   = set_cookie->size() - pos2,
-                           diff = n2 - n1;
+   if (fd == -1)
+      {
+      if (bspawn) goto disable;
 
-                  sz        += diff;
-                  endHeader += diff;
+      U_RETURN(false);
+      }
 
-                  U_INTERNAL_DUMP("diff = %u sz = %u endHeader = %u", diff, sz, endHeader)
+   {
+   UString environment, request, response(U_CAPACITY);
 
-                  U_INTERNAL_ASSERT_MINOR(diff,512)
+   if (penv) environment = *penv;
 
-                  (void) UClientImage_Base::wbuffer->replace(pos1, n1, *set_cookie, pos2, n2);
+   if (environment.empty())
+      {
+      environment = getCGIEnvironment(true);
 
-                  set_cookie->setEmpty();
+      if (environment.empty())
+         {
+         (void) U_SYSCALL(close, "%d", fd);
 
-                  U_INTERNAL_DUMP("wbuffer(%u) = %#.*S", UClientImage_Base::wbuffer->size(), U_STRING_TO_TRACE(*UClientImage_Base::wbuffer))
+         setBadRequest();
 
-                  U_ASSERT_EQUALS(sz, UClientImage_Base::wbuffer->size())
+         U_RETURN(true);
+         }
+      }
+   else
+      {
+      environment.duplicate(); // NB: u_split() write on the data...
+      }
 
-                  // for next parsing...
+   request = getFCGIRequest(environment, 1, false); // NB: the runner close the connection after the response...
 
-                  ptr    = UClientImage_Base::wbuffer->c_pointer(pos1 + n2 + 2);
-                  endptr = UClientImage_Base::wbuffer->c_pointer(endHeader);
+   if (UNotifier::write(fd, U_STRING_TO_PARAM(request)) != request.size())
+      {
+      (void) U_SYSCALL(close, "%d", fd);
 
-                  continue;
-                  }
+      if (bspawn) goto disable;
 
-               goto error;
-               }
-            }
-         break;
+      U_RETURN(false);
+      }
 
-         case 'C':
-            {
-            // check if is used to specify to the server to close the connection...
+   U_INTERNAL_DUMP("u_http_info.nResponseCode = %d", u_http_info.nResponseCode)
 
-            U_INTERNAL_DUMP("check 'Connection: close'")
+   u_http_info.nResponseCode = 0;
 
-            if (U_STRNEQ(ptr+1, "onnection: close"))
-               {
-               connection_close = true;
+   // NB: the runner is not our child, in the log of the command (see processCGIRequest()) there is the process that wait for it...
 
-               ptr += U_CONSTANT_SIZE("Connection: close") + 2;
+   UCommand::pid = u_pid;
 
-               continue;
-               }
+   if (UServices::readEOF(fd, response, UCommand::timeoutMS) == false)
+      {
+      (void) U_SYSCALL(close, "%d", fd);
 
-            U_INTERNAL_DUMP("check 'Content-...: ...'")
+      UCommand::exit_value = -EAGAIN;
 
-            if (U_STRNEQ(ptr+1, "ontent-"))
-               {
-               ptr += U_CONSTANT_SIZE("Content-");
+      UServer_Base::logCommandMsgError(cmd.getCommand(), false);
 
-               char c = u__toupper(*ptr++);
+      u_http_info.nResponseCode = HTTP_GATEWAY_TIMEOUT;
 
-               if (c == 'T' &&
-                   U_STRNEQ(ptr, "ype: "))
-                  {
-                  ptr += U_CONSTANT_SIZE("ype: ");
+      U_RETURN(true);
+      }
 
-                  header_content_type = true;
+   (void) U_SYSCALL(close, "%d", fd);
 
-                  U_INTERNAL_DUMP("header_content_type = %b", header_content_type)
+   // FCGI_STDOUT records are the output of the CGI, FCGI_END_REQUEST give us the exit status...
 
-                  if (U_STRNEQ(ptr, "text/") == false) content_encoding = true;
+   int app_status = -1;
+   uint32_t clength, size = response.size();
+   const unsigned char* h = (const unsigned char*)response.data();
+   const unsigned char* end = h + size;
 
-                  U_INTERNAL_DUMP("content_encoding = %b", content_encoding)
-                  }
-               else if (c == 'L' &&
-                        U_STRNEQ(ptr, "ength:"))
-                  {
-                  ptr += U_CONSTANT_SIZE("ength:");
+   UClientImage_Base::wbuffer->setBuffer(U_CAPACITY);
 
-                  header_content_length = true;
+   while ((h + U_FCGI_HEADER_LEN) <= end)
+      {
+      clength = (h[4] << 8) | h[5];
 
-                  U_INTERNAL_DUMP("header_content_length = %b", header_content_length)
+      if ((h + U_FCGI_HEADER_LEN + clength + h[6]) > end) break;
 
-                  uint32_t pos = UClientImage_Base::wbuffer->distance(ptr);
+      U_INTERNAL_DUMP("type = %d clength = %u", h[1], clength)
 
-                  if (checkContentLength(*UClientImage_Base::wbuffer, u_http_info.clength, pos)) // NB: with drupal can happens...!!!
-                     {
-                     sz     = UClientImage_Base::wbuffer->size();
-                     ptr    = UClientImage_Base::wbuffer->c_pointer(pos);
-                     endptr = UClientImage_Base::wbuffer->c_pointer(endHeader);
-                     }
-                  }
-               else if (c == 'E' &&
-                        U_STRNEQ(ptr, "ncoding: "))
-                  {
-                  content_encoding = true;
+      if (h[1] == U_FCGI_STDOUT) (void) UClientImage_Base::wbuffer->append((const char*)h + U_FCGI_HEADER_LEN, clength);
+      else if (h[1] == U_FCGI_END_REQUEST)
+         {
+         app_status = (h[8] << 24) | (h[9] << 16) | (h[10] << 8) | h[11];
 
-                  ptr += U_CONSTANT_SIZE("ncoding: ");
-                  }
-               }
-            }
          break;
          }
 
-      ptr = (const char*) memchr(ptr, '\n', sz);
+      h += U_FCGI_HEADER_LEN + clength + h[6];
+      }
 
-      if (ptr == 0) goto error;
+   U_INTERNAL_DUMP("app_status = %d", app_status)
 
-      ++ptr;
+   if (app_status == -1 &&
+       UClientImage_Base::wbuffer->empty())
+      {
+      // NB: the runner closed the connection without a response, if the pool is just spawned the CGI don't cooperate...
+
+      if (bspawn) goto disable;
+
+      U_RETURN(false);
       }
 
-   U_INTERNAL_ASSERT_MAJOR(endHeader, 0)
+   UCommand::status     = (app_status & 0xff) << 8;
+   UCommand::exit_value =  app_status;
 
-   U_INTERNAL_DUMP("u_http_info.clength = %u", u_http_info.clength)
+   UServer_Base::logCommandMsgError(cmd.getCommand(), false);
 
-   if (u_http_info.clength)
+   if (app_status)
       {
-      if (header_content_length)
-         {
-         *UClientImage_Base::body    = *UClientImage_Base::wbuffer;
-         *UClientImage_Base::wbuffer = getHeaderForResponse(*str_ulib_header, connection_close);
-         }
-      else
-         {
-         bool bcompress = (content_encoding == false && isCompressable());
+      // NB: like the exit value of the CGI (see processCGIRequest())...
 
-         setCgiResponse(header_content_type, bcompress, connection_close);
+      if (app_status > 128 &&
+          U_IS_HTTP_ERROR(app_status + 256))
+         {
+         u_http_info.nResponseCode = app_status + 256;
          }
-      }
-   else
-      {
-      // NB: no body...it's ok Content-Length: 0...
-
-      if (header_content_length == false)
+      else if (UClientImage_Base::wbuffer->empty())
          {
-         u_http_info.nResponseCode = HTTP_NO_CONTENT;
-
-         (void) UClientImage_Base::wbuffer->insert(0, U_CONSTANT_TO_PARAM("Content-Length: 0\r\n"));
+         u_http_info.nResponseCode = HTTP_INTERNAL_ERROR;
          }
-
-      UClientImage_Base::body->clear();
-
-      *UClientImage_Base::wbuffer = getHeaderForResponse(*UClientImage_Base::wbuffer, connection_close);
       }
 
    U_RETURN(true);
+   }
 
-error:
-   U_SRV_LOG("WARNING: UHTTP::processCGIOutput() failed...");
+disable:
+   U_SRV_LOG("WARNING: the runners of the CGI %.*S don't cooperate, we use fork and exec for every request", U_STRING_TO_TRACE(command));
 
-   setInternalError(); // set internal error response...
+   cgi->pool = 0;
 
    U_RETURN(false);
 }
@@ -7729,7 +9146,7 @@ U_NO_EXPORT bool UHTTP::checkGetRequestIfRange(const UString& etag)
 {
    U_TRACE(0, "UHTTP::checkGetRequestIfRange(%.*S)", U_STRING_TO_TRACE(etag))
 
-   const char* ptr = getHeaderValuePtr(*USocket::str_if_range, false);
+   const char* ptr = getHeaderValuePtr(HEADER_IF_RANGE, false);
 
    if (ptr)
       {
@@ -7855,7 +9272,7 @@ U_NO_EXPORT int UHTTP::checkGetRequestForRange(UString& ext, const UString& data
       {
       array.sort(sortRange);
 
-      for (i = 1, n = array.size(); i < n; ++i)
+      for (i = 1; i < array.size(); ++i)
          {
          cur  = array[i];
          prev = array[i-1];
@@ -7867,7 +9284,7 @@ U_NO_EXPORT int UHTTP::checkGetRequestForRange(UString& ext, const UString& data
             {
             prev->end = U_max(prev->end, cur->end);
 
-            array.erase(i);
+            array.erase(i--); // NB: the next range is now at the same position, it must be checked against the merged one...
             }
          }
 
@@ -7923,7 +9340,118 @@ U_NO_EXPORT int UHTTP::checkGetRequestForRange(UString& ext, const UString& data
    --------------------------
    */
 
-   uint32_t start;
+   uint32_t start, total = 0;
+
+   for (i = 0; i < n; ++i) total += array[i]->end - array[i]->start + 1;
+
+   U_INTERNAL_DUMP("total = %u min_size_for_sendfile = %u", total, min_size_for_sendfile)
+
+   // NB: for major size we don't build the message in memory, the parts go out with sendfile() straight from the file
+   //     interleaving their header with the segments of the file (see UClientImage_Base::handlerWrite())...
+
+   if (total >= min_size_for_sendfile &&
+       isGET()                        &&
+       file_data                      &&
+#  ifdef USE_LIBSSL
+       UServer_Base::bssl == false    &&
+#  endif
+       file_data->fd > 0)
+      {
+      UClientImage_Base* pClientImage = UServer_Base::pClientImage;
+
+      U_INTERNAL_ASSERT_EQUALS(pClientImage->sfd, 0)
+      U_INTERNAL_ASSERT_EQUALS(pClientImage->vrange, 0)
+
+      // NB: the type of the parts is the type of the file...
+
+      uint32_t ctype_len = U_CONSTANT_SIZE(U_CTYPE_HTML);
+      const char* ctype  =                 U_CTYPE_HTML;
+      uint32_t pos       = ext.find(*USocket::str_content_type);
+
+      if (pos != U_NOT_FOUND)
+         {
+         const char* end;
+
+         ctype = ext.c_pointer(pos + USocket::str_content_type->size() + 1);
+
+         if (u__isspace(*ctype)) ++ctype;
+
+         end = (const char*) memchr(ctype, '\r', ext.remain(ctype));
+
+         if (end) ctype_len = end - ctype;
+         }
+
+      // NB: the entry must survive the request, we don't allocate it on the arena...
+
+      bool arena = UMemoryArena::active;
+
+      UMemoryArena::active = false;
+
+      if (pClientImage->range_part == 0) pClientImage->range_part = U_NEW(UString(U_CAPACITY));
+
+      char boundary[64];
+      uint32_t len, boundary_len = u__snprintf(boundary, sizeof(boundary), "%P_%ld_%ld", u_now->tv_sec, u_now->tv_usec);
+
+      UString first(U_CAPACITY), msg(U_CAPACITY);
+      UString& part = *(pClientImage->range_part);
+      UClientImage_Base::range_segment* vrange = (UClientImage_Base::range_segment*) UMemoryPool::_malloc(n, sizeof(UClientImage_Base::range_segment));
+
+      for (i = 0; i < n; ++i)
+         {
+         cur = array[i];
+
+         vrange[i].start = cur->start;
+         vrange[i].count = cur->end - cur->start + 1;
+
+         if (i == 0)
+            {
+            first.snprintf("--%.*s\r\nContent-Type: %.*s\r\nContent-Range: bytes %u-%u/%u\r\n\r\n",
+                           boundary_len, boundary, ctype_len, ctype, cur->start, cur->end, range_size);
+
+            continue;
+            }
+
+         len = part.size();
+
+         part.snprintf_add("\r\n--%.*s\r\nContent-Type: %.*s\r\nContent-Range: bytes %u-%u/%u\r\n\r\n",
+                           boundary_len, boundary, ctype_len, ctype, cur->start, cur->end, range_size);
+
+         vrange[i-1].len = part.size() - len;
+         }
+
+      len = part.size();
+
+      part.snprintf_add("\r\n--%.*s--\r\n", boundary_len, boundary);
+
+      vrange[n-1].len = part.size() - len;
+
+      msg.snprintf("Content-Type: multipart/byteranges; boundary=%.*s\r\n"
+                   "Content-Length: %u\r\n"
+                   "\r\n", boundary_len, boundary, first.size() + total + part.size());
+
+      (void) msg.append(first);
+
+      UMemoryArena::active = arena;
+
+      pClientImage->vrange      = vrange;
+      pClientImage->range_num   = n;
+      pClientImage->range_pos   = 0;
+      pClientImage->range_index = 0;
+
+      bsendfile = true;
+
+      u_http_info.nResponseCode   = HTTP_PARTIAL;
+      *UClientImage_Base::wbuffer = getHeaderForResponse(msg, false);
+
+      pClientImage->sfd    = file_data->fd;
+      pClientImage->start  = vrange[0].start;
+      pClientImage->count  = vrange[0].count;
+      pClientImage->bclose = U_http_is_connection_close;
+                             U_http_is_connection_close = U_NOT;
+
+      U_RETURN(U_YES);
+      }
+
    UString tmp(100U);
    const char* ptr = tmp.data();
 
@@ -8005,7 +9533,7 @@ U_NO_EXPORT bool UHTTP::checkGetRequestIfModified()
       [blank line here]
       */
 
-      const char* ptr = getHeaderValuePtr(*USocket::str_if_unmodified_since, false);
+      const char* ptr = getHeaderValuePtr(HEADER_IF_UNMODIFIED_SINCE, false);
 
       if (ptr)
          {
@@ -8047,7 +9575,7 @@ void UHTTP::processGetRequest()
 
    etag = file->etag();
 
-   const char* ptr = getHeaderValuePtr(*USocket::str_if_none_match, false);
+   const char* ptr = getHeaderValuePtr(HEADER_IF_NONE_MATCH, false);
 
    if (ptr)
       {
@@ -8250,6 +9778,29 @@ U_NO_EXPORT void UHTTP::processGetRequest(const UString& etag, UString& ext)
 
    if (bsendfile)                               goto sendfile;
 
+   // NB: with the threads of disk I/O (DISK_IO_THREAD) if the data are not in page cache we don't touch the mmap (the check of the
+   //     magic byte wait for the disk), the content type is by the extension and the body is sent with sendfile()...
+
+   if (U_http_range_len      == 0 &&
+       u_http_info.query_len == 0 &&
+       isGET()                    &&
+       UServer_Base::isDiskIO()   &&
+       UServer_Base::isDataNotResident(file->fd, 0, file->st_size))
+      {
+      (void) ext.append(getHeaderMimeType(0, file->getMimeType(false), file->st_size, 0));
+
+      range_size  = file->st_size;
+      range_start = 0;
+
+      u_http_info.nResponseCode = HTTP_OK;
+
+      *UClientImage_Base::wbuffer = getHeaderForResponse(ext, false);
+
+      bsendfile = true;
+
+      goto sendfile;
+      }
+
    if (file->memmap(PROT_READ, &mmap) == false) goto error;
 
    (void) ext.append(getHeaderMimeType(file->map, file->getMimeType(U_http_is_navigation), file->st_size, 0));
@@ -8322,23 +9873,26 @@ next:
       {
       U_INTERNAL_ASSERT_EQUALS((bool)*UClientImage_Base::body, false)
 
-      // NB: we check if we need to send the body with sendfile()
+      // NB: we check if we need to send the body with sendfile(). With the threads of disk I/O (DISK_IO_THREAD) we use it also
+      //     if the data are not in page cache, otherwise the write of the mmap block the event loop on the page fault...
 
-      if (range_size >= min_size_for_sendfile)
+      if (range_size >= min_size_for_sendfile ||
+          (UServer_Base::isDiskIO() &&
+           UServer_Base::isDataNotResident(file->fd, range_start, range_size)))
          {
          bsendfile = true;
 sendfile:
          U_INTERNAL_DUMP("UServer_Base::pClientImage->sfd = %d", UServer_Base::pClientImage->sfd)
 
          U_ASSERT_EQUALS(isHEAD(), false)
-         U_INTERNAL_ASSERT(range_size >= min_size_for_sendfile)
+         U_INTERNAL_ASSERT(range_size >= min_size_for_sendfile || UServer_Base::isDiskIO())
          U_INTERNAL_ASSERT_EQUALS(UServer_Base::pClientImage->sfd, 0)
 
          UServer_Base::pClientImage->sfd    = file->fd;
-         UServer_Base::pClientImage->start  = UServer_Base::start  = range_start;
-         UServer_Base::pClientImage->count  = UServer_Base::count  = range_size;
-         UServer_Base::pClientImage->bclose = UServer_Base::bclose = U_http_is_connection_close;
-                                                                     U_http_is_connection_close = U_NOT;
+         UServer_Base::pClientImage->start  = range_start;
+         UServer_Base::pClientImage->count  = range_size;
+         UServer_Base::pClientImage->bclose = U_http_is_connection_close;
+                                              U_http_is_connection_close = U_NOT;
 
          return;
          }
@@ -8446,7 +10000,7 @@ U_NO_EXPORT bool UHTTP::initUploadProgress(int byte_read)
 
       const char* uuid_ptr = (n >= 2 && form_name_value->isEqual(n-2, *USocket::str_X_Progress_ID, true)
                                  ? form_name_value->c_pointer(n-1)
-                                 : getHeaderValuePtr(*USocket::str_X_Progress_ID, true));
+                                 : getHeaderValuePtr(HEADER_X_PROGRESS_ID, true));
 
       U_INTERNAL_DUMP("uuid = %.32S", uuid_ptr)
 
@@ -8640,6 +10194,8 @@ U_EXPORT istream& operator>>(istream& is, UHTTP::UFileCacheData& d)
 
                   d.array->push_back(decoded);
                   }
+
+               d.setReadyResponse();
                }
             }
 
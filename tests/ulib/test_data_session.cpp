@@ -0,0 +1,200 @@
+// test_data_session.cpp
+
+#include <ulib/utility/data_session.h>
+
+#include <iostream>
+
+class MySession : public UDataSession {
+public:
+
+   UString query;
+   int page;
+
+   MySession()
+      {
+      U_TRACE_REGISTER_OBJECT(5, MySession, "")
+
+      page = 0;
+      }
+
+   virtual ~MySession()
+      {
+      U_TRACE_UNREGISTER_OBJECT(5, MySession)
+      }
+
+   virtual void clear()
+      {
+      U_TRACE(5, "MySession::clear()")
+
+      UDataSession::clear();
+
+      query.clear();
+
+      page = 0;
+      }
+
+   virtual void fromStream(istream& is)
+      {
+      U_TRACE(5, "MySession::fromStream(%p)", &is)
+
+      UDataSession::fromStream(is);
+
+      is >> page;
+
+      is.get(); // skip ' '
+
+      query.get(is);
+      }
+
+   virtual void toStream(ostream& os)
+      {
+      U_TRACE(5, "MySession::toStream(%p)", &os)
+
+      UDataSession::toStream(os);
+
+      os << page;
+
+      os.put(' ');
+
+      query.write(os);
+      }
+};
+
+static void print(UDataSession& d, uint32_t n)
+{
+   U_TRACE(5, "print(%p,%u)", &d, n)
+
+   UString value;
+
+   cout << "creation = " << d.creation;
+
+   for (uint32_t i = 0; i < n; ++i)
+      {
+      cout << " [" << i << "] = ";
+
+      if (d.getValue(i, value) == false) cout << "<none>";
+      else
+         {
+         for (uint32_t j = 0; j < value.size(); ++j) cout << (u__isprint(value[j]) ? value[j] : '.');
+         }
+      }
+
+   cout << '\n';
+}
+
+static void fill(UDataSession& d)
+{
+   U_TRACE(5, "fill(%p)", &d)
+
+   d.creation = 1234567890L;
+
+   d.putValue(0, U_STRING_FROM_CONSTANT("foo"));
+   d.putValue(1, UString::getStringNull());
+   d.putValue(2, UString("bin\0\r\n\377", 7));
+   d.putValue(3, U_STRING_FROM_CONSTANT("bar"));
+}
+
+int U_EXPORT main(int argc, char* argv[])
+{
+   U_ULIB_INIT(argv);
+
+   U_TRACE(5, "main(%d)", argc)
+
+   // binary format: the values are read back as they are stored
+
+   UDataSession a, b;
+
+   fill(a);
+
+   UString x = a.toString();
+
+   cout << "binary: version = " << (x.first_char() == U_DATA_SESSION_VERSION) << " size = " << x.size() << '\n';
+
+   cout << "binary: decoded = " << b.fromString(x) << '\n';
+
+   print(b, 4);
+
+   cout << "binary: encoded again is the same = " << (b.toString() == x) << '\n';
+
+   // old text format: the session is read and stored again in the binary format (migration)
+
+   UDataSession c, d, e;
+
+   c.creation = 1234567890L;
+
+   c.putValue(0, U_STRING_FROM_CONSTANT("foo"));
+   c.putValue(1, U_STRING_FROM_CONSTANT("bar"));
+
+   char buffer[4096];
+
+   ostrstream os(buffer, sizeof(buffer));
+
+   c.toStream(os);
+
+   UString text(buffer, os.pcount());
+
+   cout << "text: " << text << '\n';
+
+   cout << "text: decoded = " << d.fromString(text) << '\n';
+
+   print(d, 2);
+
+   x = d.toString();
+
+   cout << "text: encoded in binary = " << (x.first_char() == U_DATA_SESSION_VERSION) << " decoded = " << e.fromString(x) << '\n';
+
+   print(e, 2);
+
+   // subclass: the data of toStream() follow the values of the binary record
+
+   MySession f, g;
+
+   fill(f);
+
+   f.page  = 3;
+   f.query = U_STRING_FROM_CONSTANT("hello world");
+
+   x = f.toString();
+
+   cout << "subclass: decoded = " << g.fromString(x) << " page = " << g.page << " query = " << g.query << '\n';
+
+   print(g, 4);
+
+   cout << "subclass: encoded again is the same = " << (g.toString() == x) << '\n';
+
+   // invalid data: a truncated record or a length out of the string leave the session empty
+
+   UString value;
+   uint32_t i, refused = 0;
+
+   x = a.toString();
+
+   for (i = 1; i < x.size(); ++i)
+      {
+      UDataSession h;
+
+      if (h.fromString(x.substr(0U, i)) == false &&
+          h.getValue(0, value)          == false)
+         {
+         ++refused;
+         }
+      }
+
+   cout << "invalid: truncated refused " << refused << " of " << x.size() - 1 << '\n';
+
+   UString y = x.copy();
+
+   u_put_unalignedp((uint32_t)0xffffffff, y.data()+1+sizeof(uint32_t)); // n
+
+   UDataSession h1;
+
+   cout << "invalid: number of values = " << h1.fromString(y) << '\n';
+
+   y = x.copy();
+
+   u_put_unalignedp((uint32_t)0x7fffffff, y.data()+U_DATA_SESSION_HEADER); // len of the first value
+
+   UDataSession h2;
+
+   cout << "invalid: length of value = " << h2.fromString(y) << " empty = " << (h2.getValue(0, value) == false) << '\n';
+}
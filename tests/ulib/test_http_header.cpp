@@ -0,0 +1,103 @@
+// test_http_header.cpp
+
+#include <ulib/utility/uhttp.h>
+
+#include <iostream>
+
+#define REQUEST_1                                                    \
+   "GET /index.html HTTP/1.1\r\n"                                    \
+   "Host: localhost\r\n"                                             \
+   "X-Proxy-If-Range: proxy\r\n"                                     \
+   "If-Range: range\r\n"                                             \
+   "Accept: text/html\r\n"                                           \
+   "accept: text/plain\r\n"                                          \
+   "Cookie: NameA=valueA;\r\n"                                       \
+   "  Accept: continuation\r\n"                                      \
+   "Content-Length : 12\r\n"                                         \
+   "Accept-Encoding:gzip\r\n"                                        \
+   "\r\n"
+
+static void setHeader(const UString& request)
+{
+   U_TRACE(5, "setHeader(%.*S)", U_STRING_TO_TRACE(request))
+
+   u_http_info.startHeader = request.find('\n') + 1;
+   u_http_info.szHeader    = request.size() - u_http_info.startHeader - 4; // NB: without the blank line...
+}
+
+static void lookup(const UString& request, const char* name, bool nocase)
+{
+   U_TRACE(5, "lookup(%.*S,%S,%b)", U_STRING_TO_TRACE(request), name, nocase)
+
+   const char* ptr = UHTTP::getHeaderValuePtr(request, UString(name), nocase);
+
+   cout << name << (nocase ? " (nocase)" : "") << " = ";
+
+   if (ptr == 0) cout << "<not found>\n";
+   else
+      {
+      const char* end = (const char*) memchr(ptr, '\r', request.remain(ptr));
+
+      cout.write(ptr, end - ptr) << '\n';
+      }
+}
+
+static void test(const UString& request, bool nocase)
+{
+   U_TRACE(5, "test(%.*S,%b)", U_STRING_TO_TRACE(request), nocase)
+
+   setHeader(request);
+
+   // NB: the first lookup of a request is a scan of the header lines, the next ones use the index...
+
+   lookup(request, "Accept",            nocase);
+   lookup(request, "Host",              nocase);
+   lookup(request, "If-Range",          nocase);
+   lookup(request, "X-Proxy-If-Range",  nocase);
+   lookup(request, "ACCEPT",            nocase);
+   lookup(request, "accept",            nocase);
+   lookup(request, "Content-Length",    nocase);
+   lookup(request, "Accept-Encoding",   nocase);
+   lookup(request, "Range",             nocase);
+   lookup(request, "NameA",             nocase);
+   lookup(request, "Accept",            nocase);
+}
+
+int U_EXPORT main(int argc, char* argv[])
+{
+   U_ULIB_INIT(argv);
+
+   U_TRACE(5, "main(%d)", argc)
+
+   UString request1(U_CONSTANT_TO_PARAM(REQUEST_1)),
+           request2(U_CONSTANT_TO_PARAM(REQUEST_1));
+
+   test(request1, false);
+   test(request2, true);
+
+   // NB: the same request after a lookup on another one (the index must be rebuilt)...
+
+   setHeader(request1);
+
+   lookup(request1, "accept", false);
+   lookup(request1, "accept", true);
+
+   // NB: too many header lines for the index (we scan the request)...
+
+   UString request3(U_CAPACITY);
+
+   (void) request3.append(U_CONSTANT_TO_PARAM("GET / HTTP/1.1\r\n"));
+
+   for (int i = 0; i < 100; ++i) request3.snprintf_add("X-Header-%d: %d\r\n", i, i);
+
+   (void) request3.append(U_CONSTANT_TO_PARAM("Host: many\r\n\r\n"));
+
+   setHeader(request3);
+
+   lookup(request3, "X-Header-0",  false);
+   lookup(request3, "X-Header-99", false);
+   lookup(request3, "x-header-50", true);
+   lookup(request3, "x-header-50", false);
+   lookup(request3, "Host",        false);
+   lookup(request3, "X-Header",    false);
+}
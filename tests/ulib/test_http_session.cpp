@@ -0,0 +1,204 @@
+// test_http_session.cpp
+
+#include <ulib/file.h>
+#include <ulib/db/rdb.h>
+#include <ulib/utility/uhttp.h>
+#include <ulib/net/server/server.h>
+
+#include <iostream>
+
+#include <sys/wait.h>
+
+#define N_KEY     256
+#define N_CHILD     4
+#define N_WRITE 20000
+
+static UString getKey(uint32_t i)
+{
+   U_TRACE(5, "getKey(%u)", i)
+
+   UString key(100U);
+
+   key.snprintf("session-key-%u", i);
+
+   U_RETURN_STRING(key);
+}
+
+static UString getData(uint32_t i, long age)
+{
+   U_TRACE(5, "getData(%u,%ld)", i, age)
+
+   UDataSession data;
+
+   data.creation = u_now->tv_sec - age;
+
+   data.putValue(0, getKey(i));
+
+   U_RETURN_STRING(data.toString());
+}
+
+static uint32_t getTotalSession()
+{
+   U_TRACE(5, "getTotalSession()")
+
+   uint32_t n = 0;
+
+   for (uint32_t i = 0; i < U_HTTP_SESSION_SHARD; ++i) n += ((URDB**)UHTTP::db_session)[i]->size();
+
+   U_RETURN(n);
+}
+
+static uint64_t getSumSeq(bool* peven)
+{
+   U_TRACE(5, "getSumSeq(%p)", peven)
+
+   uint64_t sum = 0;
+
+   *peven = true;
+
+   for (uint32_t i = 0; i < U_HTTP_SESSION_SEQ; ++i)
+      {
+      uint32_t seq = UServer_Base::ptr_shared_data->seq_http_session[i];
+
+      if (seq & 1) *peven = false;
+
+      sum += seq;
+      }
+
+   U_RETURN(sum);
+}
+
+int U_EXPORT main(int argc, char* argv[])
+{
+   U_ULIB_INIT(argv);
+
+   U_TRACE(5, "main(%d)", argc)
+
+   (void) gettimeofday(u_now, 0);
+
+   // NB: the store of the session is sharded only with preforked children, that share the locks and the counters in the shared data...
+
+   uint32_t map_size = sizeof(UServer_Base::shared_data);
+
+   UServer_Base::ptr_shared_data    = (UServer_Base::shared_data*) UFile::mmap(&map_size);
+   UServer_Base::preforked_num_kids = N_CHILD;
+
+   if (UHTTP::initSession(argv[1], 64 * 1024) == false)
+      {
+      cout << "initSession() failed\n";
+
+      return 1;
+      }
+
+   // sharding: every key is stored in one shard, and the keys are spread over all of them
+
+   uint32_t i, used = 0;
+
+   for (i = 0; i < N_KEY; ++i) (void) UHTTP::putSessionData(getKey(i), getData(i, 0));
+
+   for (i = 0; i < U_HTTP_SESSION_SHARD; ++i)
+      {
+      if (((URDB**)UHTTP::db_session)[i]->size()) ++used;
+      }
+
+   cout << "sharding: " << getTotalSession() << " session in " << used << " of " << U_HTTP_SESSION_SHARD << " shard\n";
+
+   for (i = 0; i < N_KEY; ++i)
+      {
+      if (UHTTP::getSessionData(getKey(i)) != getData(i, 0)) break;
+      }
+
+   cout << "sharding: read back " << i << " of " << N_KEY << '\n';
+
+   // seqlock: the copy in the private cache of a process is invalid after the write of another process...
+
+   UString key = getKey(0);
+
+   (void) UHTTP::getSessionData(key);
+
+   pid_t pid = fork();
+
+   if (pid == 0)
+      {
+      (void) UHTTP::putSessionData(key, getData(N_KEY, 0));
+
+      _exit(0);
+      }
+
+   (void) waitpid(pid, 0, 0);
+
+   cout << "seqlock: read after the write of another process: " << (UHTTP::getSessionData(key) == getData(N_KEY, 0)) << '\n';
+
+   // seqlock: the writes of concurrent processes on keys of different shard that share the slot of the counter are all counted
+
+   UString vkey[N_CHILD];
+   uint32_t n = 0, hash0 = u_cdb_hash((unsigned char*)U_STRING_TO_PARAM(key), false);
+
+   for (i = 0; n < N_CHILD; ++i)
+      {
+      UString x     = getKey(i);
+      uint32_t hash = u_cdb_hash((unsigned char*)U_STRING_TO_PARAM(x), false);
+
+      if (((hash  / U_HTTP_SESSION_SHARD) & (U_HTTP_SESSION_SEQ - 1)) ==
+          ((hash0 / U_HTTP_SESSION_SHARD) & (U_HTTP_SESSION_SEQ - 1)) &&
+          (hash & (U_HTTP_SESSION_SHARD - 1)) == n)
+         {
+         vkey[n++] = x;
+         }
+      }
+
+   bool beven;
+   uint64_t sum = getSumSeq(&beven);
+
+   for (n = 0; n < N_CHILD; ++n)
+      {
+      if (fork() == 0)
+         {
+         // NB: the children start to write together...
+
+         (void) __sync_add_and_fetch(&U_CNT_USER1, 1);
+
+         while (U_CNT_USER1 < N_CHILD) sched_yield();
+
+         for (i = 0; i < N_WRITE; ++i) (void) UHTTP::putSessionData(vkey[n], getData(n, 0));
+
+         _exit(0);
+         }
+      }
+
+   while (wait(0) > 0) {}
+
+   sum = getSumSeq(&beven) - sum;
+
+   cout << "seqlock: " << sum / 2 << " of " << N_CHILD * N_WRITE << " write counted, counters even = " << beven << '\n';
+
+   // sweep: the expired sessions are removed one shard at a time
+
+   for (i = 0; i < N_KEY; i += 2) (void) UHTTP::putSessionData(getKey(i), getData(i, 2 * U_ONE_DAY_IN_SECOND));
+
+   for (i = 0; i < U_HTTP_SESSION_SHARD; ++i)
+      {
+      UServer_Base::ptr_shared_data->sweep_http_session = u_now->tv_sec - 3600L;
+
+      UHTTP::sweepSession();
+
+      if (i == 0) cout << "sweep: after the first shard " << (getTotalSession() > N_KEY / 2) << '\n';
+      }
+
+   cout << "sweep: " << getTotalSession() << " session of " << N_KEY << " after all the shard\n";
+
+   for (i = 1; i < N_KEY; i += 2)
+      {
+      if (UHTTP::getSessionData(getKey(i)).empty()) break;
+      }
+
+   cout << "sweep: the not expired session are still there: " << (i >= N_KEY) << '\n';
+
+   // NB: the sweep of a shard is done at most every U_HTTP_SESSION_SWEEP seconds...
+
+   (void) UHTTP::putSessionData(getKey(1), getData(1, 2 * U_ONE_DAY_IN_SECOND));
+
+   UHTTP::sweepSession();
+
+   cout << "sweep: not done before the time: " << (UHTTP::getSessionData(getKey(1)).empty() == false) << '\n';
+}
@@ -170,6 +170,110 @@ static void check_size()
    U_ASSERT( U_SIZE_TO_STACK_INDEX(U_STACK_TYPE_9 - 0) ==  9 )
 }
 
+static void check_arena()
+{
+   U_TRACE(5, "check_arena()")
+
+   if (UMemoryArena::init(2 * U_ARENA_CHUNK_SIZE) == false) return;
+
+   // request 1: all the strings die with the request, the chunk is rewound...
+
+   UMemoryArena::begin();
+
+   UString* a = U_NEW(UString(100U));
+   UString* b = U_NEW(UString(U_CAPACITY));
+   UString* c = U_NEW(UString(10U * U_CAPACITY)); // NB: too big for the arena...
+
+   UMemoryArena::end();
+
+   U_ASSERT( UMemoryArena::isArena(a->rep) )
+   U_ASSERT( UMemoryArena::isArena(b->rep) )
+   U_ASSERT( UMemoryArena::isArena(c->rep) == false )
+
+   delete a;
+   delete b;
+   delete c;
+
+   U_ASSERT( UMemoryArena::num_request == 1 )
+   U_ASSERT( UMemoryArena::request_size > 100U + U_CAPACITY )
+
+   // request 2: we fill more than one chunk and one string survive the request...
+
+   UMemoryArena::begin();
+
+   UString* v[64];
+
+   for (int i = 0; i < 64; ++i) v[i] = U_NEW(UString(2000U));
+
+   UMemoryArena::end();
+
+   U_ASSERT( UMemoryArena::num_pinned == 1 )
+
+   for (int i = 1; i < 64; ++i) delete v[i];
+
+   U_ASSERT( UMemoryArena::num_pinned == 1 )
+
+   delete v[0];
+
+   U_ASSERT( UMemoryArena::num_pinned == 0 )
+
+   // request 3: outside of begin()/end() we don't use the arena...
+
+   UString d(100U);
+
+   U_ASSERT( UMemoryArena::isArena(d.rep) == false )
+
+   // request 4: a string survive the clear of the arena, the area is unmapped only with its death...
+
+   UMemoryArena::begin();
+
+   UString* e = U_NEW(UString(100U));
+
+   UMemoryArena::end();
+
+   UMemoryArena::clear();
+
+   U_ASSERT( UMemoryArena::isArena(e->rep) )
+
+   UMemoryArena::begin();
+
+   U_ASSERT( UMemoryArena::active == false )
+
+   delete e;
+
+   U_ASSERT( UMemoryArena::base == 0 )
+}
+
+static void check_stat()
+{
+   U_TRACE(5, "check_stat()")
+
+#if defined(ENABLE_MEMPOOL) && defined(__linux__)
+   char buffer[4096];
+   umemorypoolstat* pstat = UMemoryPool::pool_stat + U_SIZE_TO_STACK_INDEX(U_STACK_TYPE_6);
+
+   (void) UMemoryPool::writeInfo(buffer, sizeof(buffer)); // NB: with thread we add to the global the counters of the magazine...
+
+   uint64_t num_alloc = pstat->num_alloc,
+            num_free  = pstat->num_free;
+
+   void* v[100];
+
+   for (int i = 0; i < 100; ++i) v[i] = UMemoryPool::pop(U_SIZE_TO_STACK_INDEX(U_STACK_TYPE_6));
+
+   U_ASSERT( pstat->max_in_use >= 100 )
+
+   for (int i = 0; i < 100; ++i) UMemoryPool::push(v[i], U_SIZE_TO_STACK_INDEX(U_STACK_TYPE_6));
+
+   uint32_t n = UMemoryPool::writeInfo(buffer, sizeof(buffer));
+
+   U_ASSERT( n > 0 )
+   U_ASSERT( pstat->num_alloc - num_alloc == 100 )
+   U_ASSERT( pstat->num_free  - num_free  == 100 )
+   U_ASSERT( pstat->size >= 100 * U_STACK_TYPE_6 )
+#endif
+}
+
 static struct itimerval timeval = { { 0, 2000 }, { 0, 2000 } };
 
 static RETSIGTYPE
@@ -202,6 +306,8 @@ U_EXPORT main(int argc, char** argv)
       }
 
    check_size();
+   check_arena();
+   check_stat();
 
 #  define U_NUM_ENTRY_MEM_BLOCK 32
 
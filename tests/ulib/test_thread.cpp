@@ -1,6 +1,7 @@
 // test_thread.cpp
 
 #include <ulib/thread.h>
+#include <ulib/string.h>
 
 #include <iostream>
 
@@ -166,6 +167,38 @@ public:
       }
 };
 
+// the strings are allocated by one thread and released by another one (magazines of UMemoryPool)...
+
+#define U_NUM_POOL_THREAD 4
+
+static UString* volatile vstr[U_NUM_POOL_THREAD][64];
+
+class PoolThread : public UThread {
+public:
+
+   int id;
+
+   PoolThread(int i) : UThread(false, true), id(i) {}
+
+   void run()
+      {
+      U_TRACE(5, "PoolThread::run()")
+
+      UString* str;
+
+      for (uint32_t i = 0; i < 100000; ++i)
+         {
+         str = U_NEW(UString(10U + (i * 37U) % 4000U));
+
+         (void) str->append(U_CONSTANT_TO_PARAM("pool"));
+
+         str = __sync_lock_test_and_set(&vstr[(id + 1) % U_NUM_POOL_THREAD][i & 63], str);
+
+         if (str) delete str;
+         }
+      }
+};
+
 int U_EXPORT main(int argc, char* argv[])
 {
    U_ULIB_INIT(argv);
@@ -255,6 +288,22 @@ int U_EXPORT main(int argc, char* argv[])
 
    delete th1; // delete to join
 
+   // Test allocation from memory pool by more thread
+
+   cout << "\nstarting pool threads...";
+
+   PoolThread* vth[U_NUM_POOL_THREAD];
+
+   for (int i = 0; i < U_NUM_POOL_THREAD; ++i) (vth[i] = new PoolThread(i))->start();
+   for (int i = 0; i < U_NUM_POOL_THREAD; ++i) delete vth[i]; // delete to join
+
+   for (int i = 0; i < U_NUM_POOL_THREAD; ++i)
+      {
+      for (int j = 0; j < 64; ++j) if (vstr[i][j]) delete vstr[i][j];
+      }
+
+   cout << "ok" << endl;
+
    printf("\nNow program should finish... :)\n");
 
    return 0;
@@ -1,6 +1,7 @@
 // test_timer.cpp
 
 #include <ulib/timer.h>
+#include <ulib/debug/crono.h>
 
 #include <iostream>
 
@@ -76,6 +77,82 @@ public:
 #endif
 };
 
+static int num_expire;
+
+class MyCount : public UEventTime {
+public:
+
+   // COSTRUTTORI
+
+   MyCount(long sec, long usec) : UEventTime(sec, usec)
+      {
+      U_TRACE_REGISTER_OBJECT(0, MyCount, "%ld,%ld", sec, usec)
+      }
+
+   virtual ~MyCount()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, MyCount)
+      }
+
+   virtual int handlerTime()
+      {
+      U_TRACE(0, "MyCount::handlerTime()")
+
+      ++num_expire;
+
+      U_RETURN(-1);
+      }
+
+#ifdef DEBUG
+   const char* dump(bool reset) const { return UEventTime::dump(reset); }
+#endif
+};
+
+// insert/erase/expire cost of the timing wheel with many thousands of timer (es: keep-alive connection)
+
+static void benchmark(int n)
+{
+   U_TRACE(5, "benchmark(%d)", n)
+
+   int i;
+   UCrono crono;
+   MyCount** vec = (MyCount**) malloc(n * sizeof(MyCount*));
+
+   for (i = 0; i < n; ++i) vec[i] = U_NEW(MyCount(0L, (1 + (i % 1000)) * 1000L)); // 1-1000ms
+
+   num_expire = 0;
+
+   crono.start();
+
+   for (i = 0; i < n; ++i) UTimer::insert(vec[i], false);
+
+   crono.stop();
+
+   cout << "Time Consumed to insert " << n << " timer = " << crono.getTimeElapsed() << " ms\n";
+
+   crono.start();
+
+   for (i = 0; i < n; i += 2) UTimer::erase(vec[i], true, false);
+
+   crono.stop();
+
+   cout << "Time Consumed to erase " << n / 2 << " timer = " << crono.getTimeElapsed() << " ms\n";
+
+   UTimeVal(1L, 100L * 1000L).nanosleep();
+
+   crono.start();
+
+   UTimer::setTimer(true);
+
+   crono.stop();
+
+   cout << "Time Consumed to expire " << num_expire << " timer = " << crono.getTimeElapsed() << " ms\n";
+
+   free(vec);
+
+   UTimer::clear(false);
+}
+
 int U_EXPORT main (int argc, char* argv[])
 {
    U_ULIB_INIT(argv);
@@ -126,4 +203,8 @@ int U_EXPORT main (int argc, char* argv[])
 #ifdef DEBUG
    if (argc > 2) UTimer::printInfo(cout);
 #endif
+
+   benchmark(  1000);
+   benchmark( 10000);
+   benchmark(100000);
 }
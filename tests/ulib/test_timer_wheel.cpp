@@ -0,0 +1,228 @@
+// test_timer_wheel.cpp
+
+#include <ulib/timer.h>
+
+#include <iostream>
+
+static int num_expire;
+
+class MyCount : public UEventTime {
+public:
+
+   // COSTRUTTORI
+
+   MyCount(long sec, long usec) : UEventTime(sec, usec)
+      {
+      U_TRACE_REGISTER_OBJECT(0, MyCount, "%ld,%ld", sec, usec)
+      }
+
+   virtual ~MyCount()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, MyCount)
+      }
+
+   virtual int handlerTime()
+      {
+      U_TRACE(0, "MyCount::handlerTime()")
+
+      ++num_expire;
+
+      U_RETURN(-1);
+      }
+
+#ifdef DEBUG
+   const char* dump(bool reset) const { return UEventTime::dump(reset); }
+#endif
+};
+
+class MyMonitor : public MyCount {
+public:
+
+   // COSTRUTTORI
+
+   MyMonitor(long sec, long usec) : MyCount(sec, usec)
+      {
+      U_TRACE_REGISTER_OBJECT(0, MyMonitor, "%ld,%ld", sec, usec)
+      }
+
+   virtual ~MyMonitor()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, MyMonitor)
+      }
+
+   virtual int handlerTime()
+      {
+      U_TRACE(0, "MyMonitor::handlerTime()")
+
+      // NB: the alarm is inserted again in the wheel (monitoring) until the third expire...
+
+      if (++num_expire < 3) U_RETURN(0);
+
+      U_RETURN(-1);
+      }
+};
+
+class MyEraser : public MyCount {
+public:
+
+   UEventTime* peer;
+
+   // COSTRUTTORI
+
+   MyEraser(long sec, long usec, UEventTime* _peer) : MyCount(sec, usec), peer(_peer)
+      {
+      U_TRACE_REGISTER_OBJECT(0, MyEraser, "%ld,%ld,%p", sec, usec, _peer)
+      }
+
+   virtual ~MyEraser()
+      {
+      U_TRACE_UNREGISTER_OBJECT(0, MyEraser)
+      }
+
+   virtual int handlerTime()
+      {
+      U_TRACE(0, "MyEraser::handlerTime()")
+
+      // NB: a handler can cancel another alarm while the wheel is processed...
+
+      UTimer::erase(peer, true, false);
+
+      U_RETURN(-1);
+      }
+};
+
+static long getRemainingMs()
+{
+   U_TRACE(0, "getRemainingMs()")
+
+   struct itimerval it;
+
+   (void) getitimer(ITIMER_REAL, &it);
+
+   long result = it.it_value.tv_sec * 1000L + it.it_value.tv_usec / 1000L;
+
+   U_RETURN(result);
+}
+
+static void expire(long ms)
+{
+   U_TRACE(0, "expire(%ld)", ms)
+
+   UTimeVal(ms / 1000L, (ms % 1000L) * 1000L).nanosleep();
+
+   UTimer::setTimer(true);
+}
+
+int U_EXPORT main (int argc, char* argv[])
+{
+   U_ULIB_INIT(argv);
+
+   U_TRACE(5,"main(%d)",argc)
+
+   UTimer::init(false);
+
+   int i;
+   MyCount* vec[1000];
+
+   // insert and cancellation in the same slot and in different turn of the wheel
+
+   num_expire = 0;
+
+   for (i = 0; i < 1000; ++i)
+      {
+      vec[i] = U_NEW(MyCount(0L, (1 + (i % 100)) * 1000L)); // 1-100ms
+
+      UTimer::insert(vec[i], false);
+      }
+
+   for (i = 0; i < 1000; i += 2) UTimer::erase(vec[i], true, false);
+
+   expire(150);
+
+   cout << "expired " << num_expire << " of 500, empty = " << UTimer::empty() << '\n';
+
+   // alarm after more than one turn of the wheel must not expire at the first turn
+
+   num_expire = 0;
+
+   UTimer::insert(U_NEW(MyCount(1L, 500L * 1000L)), false);
+   UTimer::insert(U_NEW(MyCount(0L,  50L * 1000L)), false);
+
+   expire(100);
+
+   cout << "first turn: expired " << num_expire << '\n';
+
+   expire(1500);
+
+   cout << "second turn: expired " << num_expire << ", empty = " << UTimer::empty() << '\n';
+
+   // monitoring (the handler return 0) and cancellation from the handler of another alarm
+
+   num_expire = 0;
+
+   MyCount* peer = U_NEW(MyCount(0L, 80L * 1000L));
+
+   UTimer::insert(U_NEW(MyMonitor(0L, 20L * 1000L)), false);
+   UTimer::insert(U_NEW(MyEraser(0L, 10L * 1000L, peer)), false);
+   UTimer::insert(peer, false);
+
+   for (i = 0; i < 4; ++i) expire(30);
+
+   cout << "monitoring: expired " << num_expire << ", empty = " << UTimer::empty() << '\n';
+
+   // the cancellation of the armed alarm reprogram the timer on the next one
+
+   MyCount* a = U_NEW(MyCount(0L,  10L * 1000L));
+   MyCount* b = U_NEW(MyCount(0L, 500L * 1000L));
+
+   UTimer::insert(a);
+   UTimer::insert(b);
+
+   cout << "armed on the first: " << (getRemainingMs() <= 10) << '\n';
+
+   UTimer::erase(a, true);
+
+   cout << "armed on the next after erase: " << (getRemainingMs() > 100) << '\n';
+
+   UTimer::erase(b, true);
+
+   cout << "stopped after erase of the last: " << (getRemainingMs() == 0) << '\n';
+
+   // the alarm beyond a turn of the first level (es: keep-alive timeout) is in the second level, the timer is armed on it
+
+   MyCount* c = U_NEW(MyCount(5L, 0L));
+   MyCount* d = U_NEW(MyCount(20L * 60L, 0L)); // beyond a turn of the second level
+
+   UTimer::insert(c);
+
+   cout << "armed on the second level: " << (getRemainingMs() > 4900) << '\n';
+
+   UTimer::erase(c, true);
+   UTimer::insert(d);
+
+   cout << "armed beyond a turn of the second level: " << (getRemainingMs() > 1199000) << '\n';
+
+   UTimer::erase(d, true);
+
+   // the alarms of the second level are moved in the first level when the current tick enter their block
+
+   num_expire = 0;
+
+   for (i = 0; i < 100; ++i) UTimer::insert(U_NEW(MyCount(1L, (100L + i * 5L) * 1000L)), false); // 1.1-1.6s
+
+   UTimer::insert(U_NEW(MyCount(2L, 500L * 1000L)), false);
+
+   expire(1000);
+
+   cout << "second level before the block: expired " << num_expire << '\n';
+
+   expire(700);
+
+   cout << "second level after the cascade: expired " << num_expire << ", empty = " << UTimer::empty() << '\n';
+
+   expire(1000);
+
+   cout << "second level at the end: expired " << num_expire << ", empty = " << UTimer::empty() << '\n';
+
+   UTimer::clear(false);
+}